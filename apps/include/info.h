@@ -89,8 +89,6 @@ extern "C" {
 #define MAX_SUBFLOW         (32)
 #define MAX_MOSAIC_INPUT    (32)
 
-#define MAX_RAW_IMG         (100)
-
 typedef enum {
     RTOS_CAM = 0,
     LINUX_CAM,
@@ -99,6 +97,14 @@ typedef enum {
     NUM_INPUT_SOURCES
 } InputSource;
 
+typedef enum {
+    RAW_IMG_FILE = 0,
+    RAW_IMG_DIR,
+    RAW_IMG_GLOB,
+    RAW_IMG_LIST,
+    RAW_IMG_PACK
+} RawImgPathType;
+
 typedef enum {
     RTOS_DISPLAY = 0,
     LINUX_DISPLAY,
@@ -133,11 +139,12 @@ typedef struct {
     /* Frame rate for raw img input. */
     float           framerate;
 
-    /* Directory containg raw img. */
-    char            raw_img_paths[MAX_RAW_IMG][MAX_CHAR_ARRAY_SIZE];
+    /* Raw img file, directory, glob pattern, list file with a path per
+     * line or image pack. Images are enumerated when the input starts. */
+    char            raw_img_path[MAX_CHAR_ARRAY_SIZE];
 
-    /* Number of total raw img */
-    uint32_t        num_raw_img;
+    /* Kind of raw_img_path */
+    RawImgPathType  raw_img_type;
 
     /* Video file path */
     char            video_path[MAX_CHAR_ARRAY_SIZE];
@@ -163,6 +170,17 @@ typedef struct {
     /* Number of channels of the input */
     uint32_t        num_channels;
 
+    /* Drop policy of the input pad, a DROP_POLICY of tiovx modules */
+    int32_t         drop_policy;
+
+    /* Frames the graph may hold before the drop policy engages, 0 for one
+     * less than the buffers of the input pad
+     */
+    uint32_t        max_queued;
+
+    /* Memory in MB to preload raw img frames, 0 to read them every pass */
+    uint32_t        cache_mb;
+
 } InputInfo;
 
 /*
@@ -269,6 +287,9 @@ typedef struct {
     /* Framerate for saving image */
     float           framerate;
 
+    /* Save images to a single image pack at output_path */
+    bool            image_pack;
+
     /* Apply performance overlay */
     bool            overlay_perf;
 
@@ -318,6 +339,12 @@ typedef struct {
 
     /* Max height amongst provided mosaic info. */
     uint32_t    max_mosaic_height;
+
+    /* Process one of every decimation frames of the input. */
+    uint32_t    decimation;
+
+    /* Target frame rate of the subflow, 0 for input rate. */
+    float       fps;
 } SubflowInfo;
 
 /*
@@ -349,6 +376,27 @@ typedef struct {
 
     /* Dump graph as dot */
     bool        dump_dot;
+
+    /* Run each input flow in its own graph */
+    bool        multi_graph;
+
+    /* Chrome trace output file, empty if tracing is disabled */
+    char        trace_file[256];
+
+    /* Unix socket serving metrics, empty if disabled */
+    char        metrics_socket[108];
+
+    /* Buffer depths file, loaded or written by calibration */
+    char        bufq_file[256];
+
+    /* Frames to run for buffer depth calibration, 0 if disabled */
+    uint32_t    calibrate_frames;
+
+    /* Snapshot of the parsed flows, empty if disabled */
+    char        cache_file[256];
+
+    /* Startup profile output file, empty if disabled */
+    char        profile_file[256];
 } CmdArgs;
 
 #ifdef __cplusplus
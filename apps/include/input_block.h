@@ -81,6 +81,9 @@
 extern "C" {
 #endif
 
+/* Buffers of a raw image input, read ahead frames and the one in the graph */
+#define RAW_IMG_BUFQ_DEPTH (4)
+
 #if defined(TARGET_OS_LINUX)
 /*
  * V4L2 Information
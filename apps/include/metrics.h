@@ -0,0 +1,118 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _TIOVX_APPS_METRICS
+#define _TIOVX_APPS_METRICS
+
+#include <apps/include/info.h>
+
+#include <stdio.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_MAX_PATH 108
+
+typedef enum {
+    METRICS_GAUGE = 0,
+    METRICS_COUNTER,
+} MetricsType;
+
+/* Formats samples for one client, Prometheus text or JSON lines */
+typedef struct {
+    FILE            *fp;
+    bool            json;
+    const char      *last_name;
+    uint64_t        ts_ms;
+} MetricsWriter;
+
+/* Called for every client, adds the current samples with metrics_add */
+typedef void (*MetricsCollect)(MetricsWriter *writer, void *priv);
+
+/* Serves metrics on a local unix socket. A client that sends nothing or
+ * "GET /metrics" gets Prometheus text, "json" or "GET /metrics.json" gets
+ * one JSON object per line
+ */
+typedef struct {
+    char            path[METRICS_MAX_PATH];
+    int             fd;
+    pthread_t       thread;
+    MetricsCollect  collect;
+    void            *priv;
+    volatile bool   running;
+} MetricsServer;
+
+int32_t metrics_server_start(MetricsServer *server, const char *path,
+                             MetricsCollect collect, void *priv);
+void metrics_server_stop(MetricsServer *server);
+
+/* Adds one sample with num_labels pairs of label name and value strings */
+void metrics_add(MetricsWriter *writer, MetricsType type, const char *name,
+                 double value, uint32_t num_labels, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -65,6 +65,7 @@
 #include <tiovx_utils.h>
 #include <edgeai_nv12_drawing_utils.h>
 #include <edgeai_overlay_perf_stats_utils.h>
+#include <apps/include/metrics.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -76,6 +77,11 @@ void set_mosaic_background(vx_image image, char *title);
 void update_perf_overlay(vx_image image, EdgeAIPerfStats *perf_stats_handle);
 void print_perf(GraphObj *graph, EdgeAIPerfStats *perf_stats_handle);
 void generate_datasheet(GraphObj *graph, EdgeAIPerfStats *perf_stats_handle);
+void write_perf_metrics(MetricsWriter *writer, EdgeAIPerfStats *perf_stats_handle);
+void write_graph_metrics(MetricsWriter *writer, GraphObj *graphs[],
+                         const char *graph_names[], uint32_t num_graphs);
+void reset_graph_pad_stats(GraphObj *graph);
+void print_bufq_depths(GraphObj *graph, const char *graph_name);
 
 #ifdef __cplusplus
 }
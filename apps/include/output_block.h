@@ -108,6 +108,12 @@ typedef struct {
     /* Input pad to the block */
     Pad                     *input_pads[TIVX_IMG_MOSAIC_MAX_INPUTS];
     
+    /* Mosaic pad for each input pad that belongs to another graph */
+    Pad                     *bridge_pads[TIVX_IMG_MOSAIC_MAX_INPUTS];
+
+    /* Subflow feeding each input pad */
+    SubflowInfo             *input_subflows[TIVX_IMG_MOSAIC_MAX_INPUTS];
+
     /* Output pad from the block */
     Pad                     *output_pad;
 
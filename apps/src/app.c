@@ -68,23 +68,64 @@
 #include <apps/include/misc.h>
 
 #include <tiovx_modules.h>
+#include <tiovx_modules_runtime.h>
+#include <tiovx_modules_trace.h>
 #include <tiovx_utils.h>
+#include <raw_img_list.h>
 
+#include <stdlib.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <signal.h>
 #include <math.h>
+#include <inttypes.h>
+
+/* Mosaic repeats the last frame of a bridged input stalled this long */
+#define BRIDGE_TIMEOUT_MS (100)
+
+/* Frames run before buffer depth calibration starts measuring */
+#define CALIBRATE_WARMUP_FRAMES (30)
 
 static volatile int run_loop = 1;
 pthread_mutex_t r_thread_lock[MAX_FLOWS];
 pthread_mutex_t w_thread_lock[MAX_FLOWS];
+pthread_mutex_t perf_lock;
+
+/* Wait of the raw image reader for a free buffer before checking for exit */
+#define RAW_IMG_POLL_MS (100)
+
+/* Memory handles of one image */
+struct img_mem
+{
+  void          *addr[TIOVX_MODULES_MAX_REF_HANDLES];
+  vx_uint32     size[TIOVX_MODULES_MAX_REF_HANDLES];
+  vx_uint32     num_entries;
+  bool          saved;
+};
 
 /* Data required by read image thread */
 struct read_img_thread_data
 {
   int32_t       id;
   InputInfo     *input_info;
-  Buf           *read_image_buf;
+  BufPool       *buf_pool;
+  RawImgList    img_list;
+  /* Preloaded frames, the reader thread is not used if there are any */
+  vx_image      *cache_imgs;
+  struct img_mem *cache_mem;
+  uint32_t      num_cached;
+  uint32_t      cache_next;
+  /* Own memory of each pool buffer while it shows a preloaded frame */
+  struct img_mem *buf_mem;
+  /* Ring of completely read frames, guarded by r_thread_lock */
+  Buf           *ready[RAW_IMG_BUFQ_DEPTH];
+  uint32_t      ready_head;
+  uint32_t      ready_count;
+  bool          done;
+  pthread_cond_t cond;
+  /* Time the next frame is due on CLOCK_MONOTONIC */
+  uint64_t      next_us;
+  uint64_t      period_us;
 };
 
 /* Data required by write image thread */
@@ -100,42 +141,336 @@ void interrupt_handler(int32_t x)
     run_loop = 0;
 }
 
-void *read_img_thread(void *arg) 
+static uint64_t get_monotonic_us()
 {
-    /* This thread is used to read raw image and fill it in input buffer.
-     * The loop then sleeps for some time to maintain user defined fps
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Wait for the ring to change, r_thread_lock must be held */
+static void read_img_wait(struct read_img_thread_data *data)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_nsec += RAW_IMG_POLL_MS * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&data->cond, &r_thread_lock[data->id], &deadline);
+}
+
+void *read_img_thread(void *arg)
+{
+    /* This thread reads raw images ahead into free pool buffers and hands
+     * them to input_cb once completely read. Pacing is left to input_cb.
      */
-    uint32_t counter;
-    useconds_t sleep_time;
-    struct read_img_thread_data *data;   
-    
+    struct read_img_thread_data *data;
+    vx_status status;
+    Buf *buf;
+
     data = (struct read_img_thread_data *)arg;
-    sleep_time = (useconds_t) (1000000/data->input_info->framerate);
-    counter = 0;
 
     while (run_loop)
     {
-        if (counter == data->input_info->num_raw_img)
+        /* Wait for room in the ring if the pool is deeper than it */
+        pthread_mutex_lock(&r_thread_lock[data->id]);
+        while (run_loop && RAW_IMG_BUFQ_DEPTH == data->ready_count)
+        {
+            read_img_wait(data);
+        }
+        pthread_mutex_unlock(&r_thread_lock[data->id]);
+
+        if (!run_loop)
+        {
+            break;
+        }
+
+        buf = tiovx_modules_acquire_buf_timeout(data->buf_pool, RAW_IMG_POLL_MS);
+        if (NULL == buf)
+        {
+            continue;
+        }
+
+        if (0 != raw_img_list_read(&data->img_list, (vx_image)buf->handle, &status))
         {
-            if(false == data->input_info->loop)
+            raw_img_list_rewind(&data->img_list);
+            if (false == data->input_info->loop ||
+                0 != raw_img_list_read(&data->img_list, (vx_image)buf->handle, &status))
             {
+                tiovx_modules_release_buf(buf);
                 break;
             }
-            counter = 0;
         }
 
         pthread_mutex_lock(&r_thread_lock[data->id]);
+        data->ready[(data->ready_head + data->ready_count) % RAW_IMG_BUFQ_DEPTH] = buf;
+        data->ready_count++;
+        pthread_cond_broadcast(&data->cond);
+        pthread_mutex_unlock(&r_thread_lock[data->id]);
+    }
+
+    pthread_mutex_lock(&r_thread_lock[data->id]);
+    data->done = true;
+    pthread_cond_broadcast(&data->cond);
+    pthread_mutex_unlock(&r_thread_lock[data->id]);
+
+    return NULL;
+}
+
+static int32_t read_img_preload(struct read_img_thread_data *data,
+                                GraphObj *graph,
+                                Pad *pad)
+{
+    /* Reads all images into their own images once, if they fit in
+     * cache_mb. Frames are then shown by pointing pool buffers at them.
+     */
+    uint32_t num_imgs = raw_img_list_count(&data->img_list);
+    vx_uint32 width, height;
+    vx_df_image format;
+    uint64_t frame_bytes = 0;
+    vx_status status = VX_SUCCESS;
+    uint32_t i, j;
+
+    vxQueryImage((vx_image)pad->exemplar, VX_IMAGE_WIDTH, &width, sizeof(width));
+    vxQueryImage((vx_image)pad->exemplar, VX_IMAGE_HEIGHT, &height, sizeof(height));
+    vxQueryImage((vx_image)pad->exemplar, VX_IMAGE_FORMAT, &format, sizeof(format));
+
+    if (0 == num_imgs)
+    {
+        return -1;
+    }
+
+    /* Only the 0th handle is pointed at a frame, other channels would
+     * keep showing whatever their buffer last held
+     */
+    if (pad->enqueue_arr || data->buf_pool->bufs[0].num_channels > 1)
+    {
+        TIOVX_APPS_PRINTF("Multi channel input, reading images from disk\n");
+        return -1;
+    }
+
+    data->cache_imgs = (vx_image *)calloc(num_imgs, sizeof(vx_image));
+    data->cache_mem = (struct img_mem *)calloc(num_imgs, sizeof(struct img_mem));
+    data->buf_mem = (struct img_mem *)calloc(data->buf_pool->max_bufq_depth,
+                                             sizeof(struct img_mem));
+    if (NULL == data->cache_imgs || NULL == data->cache_mem || NULL == data->buf_mem)
+    {
+        TIOVX_APPS_ERROR("Unable to allocate raw image cache\n");
+        status = VX_FAILURE;
+    }
+
+    for (i = 0; i < num_imgs && VX_SUCCESS == status; i++)
+    {
+        data->cache_imgs[i] = vxCreateImage(graph->tiovx_context, width, height, format);
+        status = vxGetStatus((vx_reference)data->cache_imgs[i]);
+        if (VX_SUCCESS == status)
+        {
+            status = tivxReferenceExportHandle((vx_reference)data->cache_imgs[i],
+                                               data->cache_mem[i].addr,
+                                               data->cache_mem[i].size,
+                                               TIOVX_MODULES_MAX_REF_HANDLES,
+                                               &data->cache_mem[i].num_entries);
+        }
+        if (VX_SUCCESS != status)
+        {
+            data->cache_imgs[i] = NULL;
+            break;
+        }
+
+        /* Images are read only once the whole set is known to fit */
+        if (0 == i)
+        {
+            for (j = 0; j < data->cache_mem[0].num_entries; j++)
+            {
+                frame_bytes += data->cache_mem[0].size[j];
+            }
+            if (frame_bytes * num_imgs >
+                (uint64_t)data->input_info->cache_mb * 1024 * 1024)
+            {
+                TIOVX_APPS_PRINTF("%u images need %" PRIu64 " MB, reading from disk\n",
+                                  num_imgs, (frame_bytes * num_imgs) >> 20);
+                status = VX_FAILURE;
+                break;
+            }
+        }
+
+        /* A list file may have changed since it was counted */
+        if (0 != raw_img_list_read(&data->img_list, data->cache_imgs[i], &status))
+        {
+            status = VX_FAILURE;
+        }
+    }
+
+    raw_img_list_rewind(&data->img_list);
+
+    if (VX_SUCCESS == status)
+    {
+        data->num_cached = num_imgs;
+        data->cache_next = 0;
+        return 0;
+    }
+
+    for (i = 0; NULL != data->cache_imgs && i < num_imgs; i++)
+    {
+        if (NULL != data->cache_imgs[i])
+        {
+            vxReleaseImage(&data->cache_imgs[i]);
+        }
+    }
+    free(data->cache_imgs);
+    free(data->cache_mem);
+    free(data->buf_mem);
+    data->cache_imgs = NULL;
+    data->cache_mem = NULL;
+    data->buf_mem = NULL;
+
+    return -1;
+}
+
+/* Point a buffer back at its own memory after it showed a preloaded frame */
+static void read_img_restore_mem(struct read_img_thread_data *data, Buf *buf)
+{
+    struct img_mem *mem = &data->buf_mem[buf->buf_index];
+
+    if (mem->saved)
+    {
+        tivxReferenceImportHandle(buf->handle, (const void **)mem->addr,
+                                  mem->size, mem->num_entries);
+        mem->saved = false;
+    }
+}
+
+static Buf *read_img_cached_buf(struct read_img_thread_data *data)
+{
+    /* Points a free buffer at the next preloaded frame, no copy is done */
+    struct img_mem *mem;
+    struct img_mem *frame;
+    Buf *buf = NULL;
+
+    if (data->cache_next == data->num_cached)
+    {
+        if (false == data->input_info->loop)
+        {
+            return NULL;
+        }
+        data->cache_next = 0;
+    }
+
+    while (run_loop && NULL == buf)
+    {
+        buf = tiovx_modules_acquire_buf_timeout(data->buf_pool, RAW_IMG_POLL_MS);
+    }
+
+    if (NULL == buf)
+    {
+        return NULL;
+    }
+
+    mem = &data->buf_mem[buf->buf_index];
+    frame = &data->cache_mem[data->cache_next];
+
+    /* A frame dropped by the pool comes back still pointing at the cache */
+    if (!mem->saved)
+    {
+        tivxReferenceExportHandle(buf->handle, mem->addr, mem->size,
+                                  TIOVX_MODULES_MAX_REF_HANDLES, &mem->num_entries);
+        mem->saved = true;
+    }
+    tivxReferenceImportHandle(buf->handle, (const void **)frame->addr,
+                              frame->size, frame->num_entries);
+
+    data->cache_next++;
+
+    return buf;
+}
+
+static void read_img_free_cache(struct read_img_thread_data *data)
+{
+    /* Buffers must own their memory again before the pool is freed */
+    uint32_t i;
+
+    for (i = 0; i < (uint32_t)data->buf_pool->max_bufq_depth; i++)
+    {
+        read_img_restore_mem(data, &data->buf_pool->bufs[i]);
+    }
+
+    for (i = 0; i < data->num_cached; i++)
+    {
+        vxReleaseImage(&data->cache_imgs[i]);
+    }
+
+    free(data->cache_imgs);
+    free(data->cache_mem);
+    free(data->buf_mem);
+    data->num_cached = 0;
+}
+
+static Buf *read_img_next_buf(struct read_img_thread_data *data, Buf *consumed)
+{
+    /* Gives the consumed buffer back to the reader and returns the next
+     * read frame when it is due, NULL once the images have ended
+     */
+    struct timespec deadline;
+    uint64_t now;
+    Buf *buf = NULL;
+
+    if (NULL != consumed)
+    {
+        if (data->num_cached > 0)
+        {
+            read_img_restore_mem(data, consumed);
+        }
+        tiovx_modules_release_buf(consumed);
+    }
 
-        readImage(data->input_info->raw_img_paths[counter],
-                  (vx_image)data->read_image_buf->handle);
+    if (data->num_cached > 0)
+    {
+        buf = read_img_cached_buf(data);
+    }
+    else
+    {
+        pthread_mutex_lock(&r_thread_lock[data->id]);
+        while (run_loop && 0 == data->ready_count && !data->done)
+        {
+            read_img_wait(data);
+        }
 
+        if (data->ready_count > 0)
+        {
+            buf = data->ready[data->ready_head];
+            data->ready_head = (data->ready_head + 1) % RAW_IMG_BUFQ_DEPTH;
+            data->ready_count--;
+            pthread_cond_broadcast(&data->cond);
+        }
         pthread_mutex_unlock(&r_thread_lock[data->id]);
+    }
 
-        counter++;
-        usleep(sleep_time);
+    if (NULL == buf)
+    {
+        return NULL;
     }
 
-    return NULL;
+    /* Frames are due at a fixed period, a late frame restarts the period */
+    now = get_monotonic_us();
+    if (data->next_us > now)
+    {
+        deadline.tv_sec = data->next_us / 1000000;
+        deadline.tv_nsec = (data->next_us % 1000000) * 1000;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
+    else
+    {
+        data->next_us = now;
+    }
+    data->next_us += data->period_us;
+
+    return buf;
 }
 
 void *write_img_thread(void *arg)
@@ -147,35 +482,461 @@ void *write_img_thread(void *arg)
     useconds_t sleep_time;
     char output_filename[512];
     struct write_img_thread_data *data;
+    ImagePack pack;
 
     data = (struct write_img_thread_data *)arg;
     sleep_time = (useconds_t) (1000000/data->output_info->framerate);
     counter = 0;
 
+    /* An image pack takes every frame, with no file per frame */
+    if (data->output_info->image_pack &&
+        VX_SUCCESS != createImagePack(data->output_info->output_path,
+                                      (vx_image)data->write_image_buf->handle,
+                                      &pack))
+    {
+        TIOVX_APPS_ERROR("Unable to create image pack %s\n",
+                         data->output_info->output_path);
+        return NULL;
+    }
+
     while (run_loop)
     {
-        /* Max file written will be 9999 and then files will start getting
-         * overwritten
-         */
-        if (counter == 9999)
-        {
-            counter = 0;
-        }
+        if (data->output_info->image_pack)
+        {
+            pthread_mutex_lock(&w_thread_lock[data->id]);
+            writeImagePackFrame(&pack, (vx_image)data->write_image_buf->handle,
+                                get_monotonic_us());
+            pthread_mutex_unlock(&w_thread_lock[data->id]);
+
+            usleep(sleep_time);
+            continue;
+        }
+
+        /* Max file written will be 9999 and then files will start getting
+         * overwritten
+         */
+        if (counter == 9999)
+        {
+            counter = 0;
+        }
+
+        sprintf(output_filename, "%s/%04d.yuv", data->output_info->output_path, counter);
+
+        pthread_mutex_lock(&w_thread_lock[data->id]);
+        writeImage(output_filename, (vx_image)data->write_image_buf->handle);
+        pthread_mutex_unlock(&w_thread_lock[data->id]);
+
+        counter++;
+        usleep(sleep_time);
+    }
+
+    if (data->output_info->image_pack)
+    {
+        closeImagePack(&pack);
+    }
+
+    return NULL;
+}
+
+/* Data required by runtime callbacks */
+struct runtime_cb_data
+{
+  int32_t                       id;
+  InputBlock                    *input_block;
+  OutputBlock                   *output_block;
+  struct read_img_thread_data   *r_thread_data;
+  struct write_img_thread_data  *w_thread_data;
+  GraphObj                      *graph;
+  CmdArgs                       *cmd_args;
+  EdgeAIPerfStats               *perf_stats_handle;
+  bool                          perf_tick;
+  uint64_t                      num_frames;
+  uint32_t                      num_dropped;
+};
+
+/* Data required by metrics collection */
+struct metrics_data
+{
+  GraphObj                      *graph;
+  GraphObj                      *flow_graphs;
+  uint32_t                      num_flow_graphs;
+  struct runtime_cb_data        *in_cb_data;
+  uint32_t                      num_flows;
+  Bridge                        *bridges;
+  uint32_t                      num_bridges;
+  EdgeAIPerfStats               *perf_stats_handle;
+  uint64_t                      prev_frames[MAX_FLOWS];
+  struct timespec               prev_ts;
+};
+
+static void service_perf(struct runtime_cb_data *data, vx_image image)
+{
+    /* Callbacks run on separate threads, perf stats are shared */
+    pthread_mutex_lock(&perf_lock);
+    update_perf_overlay(image, data->perf_stats_handle);
+    if(data->cmd_args->verbose)
+    {
+        print_perf(data->graph, data->perf_stats_handle);
+    }
+    if(data->cmd_args->gen_data)
+    {
+        generate_datasheet(data->graph, data->perf_stats_handle);
+    }
+    pthread_mutex_unlock(&perf_lock);
+}
+
+static void collect_metrics(MetricsWriter *writer, void *priv)
+{
+    /* Called on the metrics server thread for every scrape */
+    struct metrics_data *data = (struct metrics_data *)priv;
+    struct timespec now;
+    double elapsed;
+    uint64_t frames[MAX_FLOWS];
+    GraphObj *graphs[MAX_FLOWS + 1];
+    const char *graph_names[MAX_FLOWS + 1];
+    char flow_graph_names[MAX_FLOWS][16];
+    char label[16];
+    uint32_t i;
+
+    pthread_mutex_lock(&perf_lock);
+    write_perf_metrics(writer, data->perf_stats_handle);
+    pthread_mutex_unlock(&perf_lock);
+
+    graphs[0] = data->graph;
+    graph_names[0] = "main";
+    for(i = 0; i < data->num_flow_graphs; i++)
+    {
+        sprintf(flow_graph_names[i], "flow%d", i);
+        graphs[i + 1] = &data->flow_graphs[i];
+        graph_names[i + 1] = flow_graph_names[i];
+    }
+    write_graph_metrics(writer, graphs, graph_names, data->num_flow_graphs + 1);
+
+    /* Per flow fps since the previous scrape. Each metric is written for
+     * all flows before the next, as Prometheus expects.
+     */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed = (now.tv_sec - data->prev_ts.tv_sec) +
+              (now.tv_nsec - data->prev_ts.tv_nsec) / 1000000000.0;
+    data->prev_ts = now;
+
+    for(i = 0; i < data->num_flows; i++)
+    {
+        frames[i] = __atomic_load_n(&data->in_cb_data[i].num_frames,
+                                    __ATOMIC_RELAXED);
+        sprintf(label, "%d", i);
+        metrics_add(writer, METRICS_COUNTER, "tiovx_flow_frames_total",
+                    frames[i], 1, "flow", label);
+    }
+    for(i = 0; i < data->num_flows; i++)
+    {
+        sprintf(label, "%d", i);
+        metrics_add(writer, METRICS_GAUGE, "tiovx_flow_fps",
+                    (elapsed > 0) ? (frames[i] - data->prev_frames[i]) / elapsed : 0,
+                    1, "flow", label);
+        data->prev_frames[i] = frames[i];
+    }
+    for(i = 0; i < data->num_flows; i++)
+    {
+        sprintf(label, "%d", i);
+        metrics_add(writer, METRICS_COUNTER, "tiovx_flow_dropped_total",
+                    __atomic_load_n(&data->in_cb_data[i].num_dropped,
+                                    __ATOMIC_RELAXED),
+                    1, "flow", label);
+    }
+
+    for(i = 0; i < data->num_bridges; i++)
+    {
+        sprintf(label, "%d", i);
+        metrics_add(writer, METRICS_COUNTER, "tiovx_bridge_dropped_total",
+                    data->bridges[i].num_dropped, 1, "bridge", label);
+    }
+    for(i = 0; i < data->num_bridges; i++)
+    {
+        sprintf(label, "%d", i);
+        metrics_add(writer, METRICS_COUNTER, "tiovx_bridge_repeated_total",
+                    data->bridges[i].num_repeated, 1, "bridge", label);
+    }
+    for(i = 0; i < data->num_bridges; i++)
+    {
+        sprintf(label, "%d", i);
+        metrics_add(writer, METRICS_COUNTER, "tiovx_bridge_skipped_total",
+                    data->bridges[i].rate.num_skipped, 1, "bridge", label);
+    }
+}
+
+static Buf *input_cb(Buf *buf, void *priv)
+{
+    /* Called with a buffer consumed by the graph, returns the buffer to be
+     * enqueued next or NULL once the source has ended
+     */
+    struct runtime_cb_data *data = (struct runtime_cb_data *)priv;
+    InputBlock *input_block = data->input_block;
+
+    if (RTOS_CAM == input_block->input_info->source)
+    {
+        /* Enqueue back the same buffer */
+    }
+
+#if defined(TARGET_OS_LINUX)
+    else if (LINUX_CAM == input_block->input_info->source)
+    {
+        /* Give the buffer back to v4l2 and wait for the next frame */
+        v4l2_capture_enqueue_buf(input_block->v4l2_obj.v4l2_capture_handle, buf);
+        buf = NULL;
+        while(run_loop && NULL == buf)
+        {
+            /* Frames backed up in v4l2 are dropped for the freshest one */
+            if (TIOVX_MODULES_KEEP_LATEST == input_block->input_info->drop_policy ||
+                TIOVX_MODULES_DROP_OLDEST == input_block->input_info->drop_policy)
+            {
+                uint32_t num_dropped = 0;
+
+                buf = v4l2_capture_dqueue_latest_buf(input_block->v4l2_obj.v4l2_capture_handle,
+                                                     &num_dropped);
+                __atomic_add_fetch(&data->num_dropped, num_dropped,
+                                   __ATOMIC_RELAXED);
+            }
+            else
+            {
+                buf = v4l2_capture_dqueue_buf(input_block->v4l2_obj.v4l2_capture_handle);
+            }
+        }
+    }
+
+    else if (VIDEO == input_block->input_info->source)
+    {
+        /* Enqueue to v4l2 for decode, then dequeue the decoded frame */
+        v4l2_decode_enqueue_buf(input_block->v4l2_obj.v4l2_decode_handle, buf);
+        buf = v4l2_decode_dqueue_buf(input_block->v4l2_obj.v4l2_decode_handle);
+    }
+#endif
+
+    else if (RAW_IMG == input_block->input_info->source)
+    {
+        /* Refill the consumed buffer and enqueue the next read frame */
+        buf = read_img_next_buf(data->r_thread_data, buf);
+    }
+
+    if(NULL != buf)
+    {
+        __atomic_add_fetch(&data->num_frames, 1, __ATOMIC_RELAXED);
+    }
+
+    if(NULL != buf && data->perf_tick)
+    {
+        service_perf(data, NULL);
+    }
+
+    return buf;
+}
+
+#if defined(TARGET_OS_LINUX)
+static Buf *h3a_cb(Buf *buf, void *priv)
+{
+    /* AEWB processing for linux, aewb buffer completes with h3a buffer */
+    struct runtime_cb_data *data = (struct runtime_cb_data *)priv;
+    InputBlock *input_block = data->input_block;
+    Buf *aewb_buf = NULL;
+
+    aewb_buf = tiovx_modules_dequeue_buf(input_block->v4l2_obj.aewb_pad->buf_pool);
+    aewb_process(input_block->v4l2_obj.aewb_handle, buf, aewb_buf);
+    tiovx_modules_enqueue_buf(aewb_buf);
+
+    return buf;
+}
+#endif
+
+static Buf *output_cb(Buf *buf, void *priv)
+{
+    /* Called with a buffer produced by the graph, returns the buffer to be
+     * enqueued next or NULL once the sink has ended
+     */
+    struct runtime_cb_data *data = (struct runtime_cb_data *)priv;
+    OutputBlock *output_block = data->output_block;
+
+    if (IMG_DIR == output_block->output_info->sink)
+    {
+        /* Update write image thread buffer */
+        pthread_mutex_lock(&w_thread_lock[data->id]);
+        data->w_thread_data->write_image_buf = buf;
+        pthread_mutex_unlock(&w_thread_lock[data->id]);
+    }
+#if defined(TARGET_OS_LINUX)
+    else if (LINUX_DISPLAY == output_block->output_info->sink)
+    {
+        /* Render the dequeued buffer on kms display */
+        kms_display_render_buf(output_block->kms_obj.kms_display_handle, buf);
+    }
+    else if (H264_ENCODE == output_block->output_info->sink ||
+             H265_ENCODE == output_block->output_info->sink)
+    {
+        v4l2_encode_enqueue_buf(output_block->v4l2_obj.v4l2_encode_handle, buf);
+        buf = v4l2_encode_dqueue_buf(output_block->v4l2_obj.v4l2_encode_handle);
+    }
+#endif
+
+    return buf;
+}
+
+static Buf *perf_overlay_cb(Buf *buf, void *priv)
+{
+    struct runtime_cb_data *data = (struct runtime_cb_data *)priv;
+
+    service_perf(data, (vx_image)buf->handle);
+
+    return buf;
+}
+
+static bool has_rate(SubflowInfo *subflow_info)
+{
+    return (subflow_info->decimation > 1 || subflow_info->fps > 0);
+}
+
+static bool rate_at_source(FlowInfo *flow_info)
+{
+    /* A rate shared by all subflows is applied before the graph, so the
+     * whole flow including inference runs at that rate. Only sources that
+     * block for the next frame can skip frames this way.
+     */
+    SubflowInfo *first = &flow_info->subflow_infos[0];
+    uint32_t i;
+
+    if (!has_rate(first))
+    {
+        return false;
+    }
+
+#if defined(TARGET_OS_LINUX)
+    if (LINUX_CAM != flow_info->input_info.source &&
+        VIDEO != flow_info->input_info.source)
+    {
+        return false;
+    }
+#else
+    return false;
+#endif
+
+    for (i = 1; i < flow_info->num_subflows; i++)
+    {
+        if (flow_info->subflow_infos[i].decimation != first->decimation ||
+            flow_info->subflow_infos[i].fps != first->fps)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static int32_t load_bufq_depths(char *path,
+                                GraphObj *graph,
+                                GraphObj flow_graphs[],
+                                uint32_t num_flow_graphs)
+{
+    FILE *fp;
+    char name[16];
+    int32_t status;
+    uint32_t i;
+
+    fp = fopen(path, "r");
+    if(NULL == fp)
+    {
+        TIOVX_APPS_ERROR("Unable to open %s\n", path);
+        return -1;
+    }
+
+    status = tiovx_modules_load_bufq_depths(graph, "main", fp);
+    for(i = 0; i < num_flow_graphs && VX_SUCCESS == status; i++)
+    {
+        sprintf(name, "flow%d", i);
+        status = tiovx_modules_load_bufq_depths(&flow_graphs[i], name, fp);
+    }
+
+    fclose(fp);
+
+    return status;
+}
+
+static int32_t save_bufq_depths(char *path,
+                                GraphObj *graph,
+                                GraphObj flow_graphs[],
+                                uint32_t num_flow_graphs)
+{
+    FILE *fp = NULL;
+    char name[16];
+    int32_t status = 0;
+    uint32_t i;
+
+    print_bufq_depths(graph, "main");
+    for(i = 0; i < num_flow_graphs; i++)
+    {
+        sprintf(name, "flow%d", i);
+        print_bufq_depths(&flow_graphs[i], name);
+    }
+
+    if('\0' == path[0])
+    {
+        return status;
+    }
+
+    fp = fopen(path, "w");
+    if(NULL == fp)
+    {
+        TIOVX_APPS_ERROR("Unable to open %s\n", path);
+        return -1;
+    }
+
+    fprintf(fp, "# graph node_index node_type direction pad_index bufq_depth\n");
+    status = tiovx_modules_save_bufq_depths(graph, "main", fp);
+    for(i = 0; i < num_flow_graphs && VX_SUCCESS == status; i++)
+    {
+        sprintf(name, "flow%d", i);
+        status = tiovx_modules_save_bufq_depths(&flow_graphs[i], name, fp);
+    }
 
-        sprintf(output_filename, "%s/%04d.yuv", data->output_info->output_path, counter);
+    fclose(fp);
 
-        pthread_mutex_lock(&w_thread_lock[data->id]);
-        writeImage(output_filename, (vx_image)data->write_image_buf->handle);
-        pthread_mutex_unlock(&w_thread_lock[data->id]);
+    return status;
+}
 
-        counter++;
-        usleep(sleep_time);
+static int32_t save_startup_profile(char *path,
+                                    GraphObj *graph,
+                                    GraphObj flow_graphs[],
+                                    uint32_t num_flow_graphs)
+{
+    FILE *fp = NULL;
+    char name[16];
+    int32_t status = 0;
+    uint32_t i;
+
+    fp = fopen(path, "w");
+    if(NULL == fp)
+    {
+        TIOVX_APPS_ERROR("Unable to open %s\n", path);
+        return -1;
     }
 
-    return NULL;
+    fprintf(fp, "[");
+    for(i = 0; i < num_flow_graphs && VX_SUCCESS == status; i++)
+    {
+        sprintf(name, "flow%d", i);
+        status = tiovx_modules_write_startup_profile(&flow_graphs[i], name, fp);
+        fprintf(fp, ",\n");
+    }
+    if(VX_SUCCESS == status)
+    {
+        status = tiovx_modules_write_startup_profile(graph, "main", fp);
+    }
+    fprintf(fp, "]\n");
+
+    fclose(fp);
+
+    return status;
 }
 
 int32_t connect_blocks(GraphObj *graph,
+                       GraphObj flow_graphs[],
                        FlowInfo flow_infos[],
                        uint32_t num_flows,
                        InputBlock input_blocks[],
@@ -225,6 +986,9 @@ int32_t connect_blocks(GraphObj *graph,
         /* Initialize Input Block */
         InputBlock  input_block;
 
+        /* Graph of this flow, outputs always go in graph */
+        GraphObj *flow_graph = (NULL != flow_graphs) ? &flow_graphs[i] : graph;
+
         /* Array of all resize block required by this Input */
         ResizeBlock resize_blocks[MAX_SUBFLOW];
         uint32_t num_resize_blocks = 0;
@@ -394,7 +1158,7 @@ int32_t connect_blocks(GraphObj *graph,
                 dl_block.post_proc_height = flow_infos[i].subflow_infos[j].max_mosaic_height;
                 dl_block.num_channels = flow_infos[i].input_info.num_channels;
 
-                status = create_deep_learning_block(graph, &dl_block);
+                status = create_deep_learning_block(flow_graph, &dl_block);
                 if(0 != status)
                 {
                     TIOVX_APPS_ERROR("Cannot create deep learning block\n");
@@ -484,7 +1248,7 @@ int32_t connect_blocks(GraphObj *graph,
          */
         for(j = 0; j < num_resize_blocks; j++)
         {
-            status = create_resize_block(graph, &resize_blocks[j]);
+            status = create_resize_block(flow_graph, &resize_blocks[j]);
             if(0 != status)
             {
                 TIOVX_APPS_ERROR("Cannot create resize block\n");
@@ -522,7 +1286,7 @@ int32_t connect_blocks(GraphObj *graph,
         }
 
         /* Create Input Block */
-        status = create_input_block(graph, &input_block);
+        status = create_input_block(flow_graph, &input_block);
         if(0 != status)
         {
             TIOVX_APPS_ERROR("Cannot create input block\n");
@@ -566,6 +1330,8 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
     uint32_t num_output_blocks;
 
     GraphObj graph;
+    GraphObj *flow_graphs = NULL;
+    uint32_t num_flow_graphs = 0;
 
     BufPool *in_buf_pool = NULL;
     Buf *inbuf = NULL;
@@ -576,20 +1342,39 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
 
     BufPool *linux_aewb_buf_pool = NULL;
     Buf *linux_aewb_buf = NULL;
-
-    Buf *v4l2_valid_bufs[num_flows];
-    Buf *v4l2_dq_bufs[num_flows];
 #endif
 
     BufPool *out_buf_pool = NULL;
     Buf *outbuf = NULL;
 
+    Runtime runtimes[1 + num_flows];
+    uint32_t num_runtimes = 0;
+    uint32_t num_started = 0;
+    bool finished = false;
+    Runtime *flow_runtime = NULL;
+
+    Bridge bridges[NUM_OUTPUT_SINKS * TIVX_IMG_MOSAIC_MAX_INPUTS];
+    uint32_t num_bridges = 0;
+
+    struct runtime_cb_data in_cb_data[num_flows];
+    struct runtime_cb_data out_cb_data[NUM_OUTPUT_SINKS];
+
     BufPool *perf_overlay_buf_pool = NULL;
     Buf *perf_overlay_buf = NULL;
 
     EdgeAIPerfStats perf_stats_handle;
     bool overlay_perf_graph = true;
 
+    MetricsServer metrics_server;
+    struct metrics_data m_data;
+    bool use_metrics = ('\0' != cmd_args->metrics_socket[0]);
+    bool calibrate = (cmd_args->calibrate_frames > 0);
+    bool calibrating = false;
+    uint64_t calibrate_start = 0;
+
+    memset(&metrics_server, 0, sizeof(metrics_server));
+    memset(&m_data, 0, sizeof(m_data));
+
     /* Capture SIGINT to stop loop */
     signal(SIGINT, interrupt_handler);
 
@@ -599,15 +1384,7 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
         pthread_mutex_init(&r_thread_lock[i], NULL);
         pthread_mutex_init(&w_thread_lock[i], NULL);
     }
-
-#if defined(TARGET_OS_LINUX)
-    /* Initialize v4l2 buffers to NULL */
-    for (i = 0; i < num_flows; i++)
-    {
-        v4l2_valid_bufs[i] = NULL;
-        v4l2_dq_bufs[i] = NULL;
-    }
-#endif
+    pthread_mutex_init(&perf_lock, NULL);
 
     /* Initialize the graph */
     status = tiovx_modules_initialize_graph(&graph);
@@ -620,8 +1397,44 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
     /* Set scheduling mode to AUTO*/
     graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
 
+    /* Graph parameter events drive the runtime */
+    graph.use_param_events = vx_true_e;
+
+    /* Queue statistics are served as metrics and used by calibration */
+    graph.collect_pad_stats = use_metrics || calibrate;
+
+    graph.print_startup_profile = cmd_args->verbose;
+
+    /* Each flow gets its own graph, outputs stay in graph */
+    if(cmd_args->multi_graph)
+    {
+        flow_graphs = (GraphObj *)calloc(num_flows, sizeof(GraphObj));
+        if(NULL == flow_graphs)
+        {
+            TIOVX_APPS_ERROR("Unable to allocate flow graphs\n");
+            status = -1;
+            goto clean_graph;
+        }
+
+        for(i = 0; i < num_flows; i++)
+        {
+            status = tiovx_modules_initialize_graph(&flow_graphs[i]);
+            if(VX_SUCCESS != status)
+            {
+                TIOVX_APPS_ERROR("Unable to create TIOVX graph for flow %d\n", i);
+                goto clean_graph;
+            }
+            flow_graphs[i].schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+            flow_graphs[i].use_param_events = vx_true_e;
+            flow_graphs[i].collect_pad_stats = use_metrics || calibrate;
+            flow_graphs[i].print_startup_profile = cmd_args->verbose;
+            num_flow_graphs++;
+        }
+    }
+
     /* Connect the nodes in the graph */
     status = connect_blocks(&graph,
+                           flow_graphs,
                            flow_infos,
                            num_flows,
                            input_blocks,
@@ -634,7 +1447,31 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
         goto clean_graph;
     }
 
+    /* Apply buffer depths of a previous calibration */
+    if('\0' != cmd_args->bufq_file[0] && !calibrate)
+    {
+        status = load_bufq_depths(cmd_args->bufq_file,
+                                  &graph,
+                                  flow_graphs,
+                                  num_flow_graphs);
+        if(0 != status)
+        {
+            TIOVX_APPS_ERROR("Error loading buffer depths\n");
+            goto clean_graph;
+        }
+    }
+
     /* Verify the graph */
+    for(i = 0; i < num_flow_graphs; i++)
+    {
+        status = tiovx_modules_verify_graph(&flow_graphs[i]);
+        if (VX_SUCCESS != status)
+        {
+            TIOVX_APPS_ERROR("Error verifying graph for flow %d\n", i);
+            goto clean_graph;
+        }
+    }
+
     status = tiovx_modules_verify_graph(&graph);
     if (VX_SUCCESS != status)
     {
@@ -642,6 +1479,30 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
         goto clean_graph;
     }
 
+    if('\0' != cmd_args->profile_file[0])
+    {
+        status = save_startup_profile(cmd_args->profile_file,
+                                      &graph,
+                                      flow_graphs,
+                                      num_flow_graphs);
+        if(0 != status)
+        {
+            TIOVX_APPS_ERROR("Error writing startup profile\n");
+            goto clean_graph;
+        }
+    }
+
+    /* Record a timeline, written on exit or on SIGUSR2 */
+    if('\0' != cmd_args->trace_file[0])
+    {
+        status = tiovx_modules_trace_start(cmd_args->trace_file, 0);
+        if (VX_SUCCESS != status)
+        {
+            TIOVX_APPS_ERROR("Error starting trace\n");
+            goto clean_graph;
+        }
+    }
+
     /* Dump graph as a dot file */
     if(cmd_args->dump_dot)
     {
@@ -653,6 +1514,19 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
             TIOVX_APPS_ERROR("Error exporting graph as dot\n");
             goto clean_graph;
         }
+
+        for(i = 0; i < num_flow_graphs; i++)
+        {
+            char prefix[32];
+
+            sprintf(prefix, "edgeai_tiovx_apps_flow%d", i);
+            status = tiovx_modules_export_graph(&flow_graphs[i], ".", prefix);
+            if (VX_SUCCESS != status)
+            {
+                TIOVX_APPS_ERROR("Error exporting graph as dot\n");
+                goto clean_graph;
+            }
+        }
     }
 
     /* Initialize perf stats */
@@ -672,6 +1546,32 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
         perf_stats_handle.numInstances = 1;
     }
 
+    /* Open image lists before any source starts, an empty one would hang */
+    for(i = 0; i < num_input_blocks; i++)
+    {
+        if (RAW_IMG != input_blocks[i].input_info->source)
+        {
+            continue;
+        }
+
+        if (0 != raw_img_list_open(&r_thread_data[i].img_list,
+                                   input_blocks[i].input_info) ||
+            0 == raw_img_list_count(&r_thread_data[i].img_list))
+        {
+            TIOVX_APPS_ERROR("No images to read from %s\n",
+                             input_blocks[i].input_info->raw_img_path);
+            for(j = 0; j <= i; j++)
+            {
+                if (RAW_IMG == input_blocks[j].input_info->source)
+                {
+                    raw_img_list_close(&r_thread_data[j].img_list);
+                }
+            }
+            status = VX_FAILURE;
+            goto clean_graph;
+        }
+    }
+
     /* Enqueue buffers at start based on input sources in all input blocks */
     for(i = 0; i < num_input_blocks; i++)
     {
@@ -679,12 +1579,14 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
 
         if (RTOS_CAM == input_blocks[i].input_info->source)
         {
+            Buf *inbufs[in_buf_pool->bufq_depth];
+
+            /* Get buffers from buffer pool and enqueue them together */
             for (j = 0; j < in_buf_pool->bufq_depth; j++)
             {
-                /* Get buffers from buffer pool and enqueue */
-                inbuf = tiovx_modules_acquire_buf(in_buf_pool);
-                tiovx_modules_enqueue_buf(inbuf);
+                inbufs[j] = tiovx_modules_acquire_buf(in_buf_pool);
             }
+            tiovx_modules_enqueue_bufs(inbufs, in_buf_pool->bufq_depth);
         }
 
 #if defined(TARGET_OS_LINUX)
@@ -729,19 +1631,48 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
 
         else if (RAW_IMG == input_blocks[i].input_info->source)
         {
-            inbuf = tiovx_modules_acquire_buf(in_buf_pool);
+            pthread_condattr_t cond_attr;
 
             /* Create a seperate thread for reading image */
             r_thread_data[i].id = i;
-            r_thread_data[i].read_image_buf = inbuf;
             r_thread_data[i].input_info = input_blocks[i].input_info;
-            pthread_create(&read_img_thread_id[num_r_threads],
-                           NULL,
-                           read_img_thread,
-                           (void *)&r_thread_data[i]);
-            num_r_threads++;
+            r_thread_data[i].buf_pool = in_buf_pool;
+            r_thread_data[i].ready_head = 0;
+            r_thread_data[i].ready_count = 0;
+            r_thread_data[i].done = false;
+            r_thread_data[i].next_us = 0;
+            r_thread_data[i].period_us =
+                (uint64_t)(1000000 / input_blocks[i].input_info->framerate);
+            pthread_condattr_init(&cond_attr);
+            pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+            pthread_cond_init(&r_thread_data[i].cond, &cond_attr);
+            pthread_condattr_destroy(&cond_attr);
+
+            r_thread_data[i].num_cached = 0;
+
+            /* Replay preloaded frames if they fit, else read them ahead */
+            if (input_blocks[i].input_info->cache_mb > 0)
+            {
+                read_img_preload(&r_thread_data[i],
+                                 &graph,
+                                 input_blocks[i].input_pad);
+            }
 
-            tiovx_modules_enqueue_buf(inbuf);
+            if (0 == r_thread_data[i].num_cached)
+            {
+                pthread_create(&read_img_thread_id[num_r_threads],
+                               NULL,
+                               read_img_thread,
+                               (void *)&r_thread_data[i]);
+                num_r_threads++;
+            }
+
+            /* The graph starts with the first frame read */
+            inbuf = read_img_next_buf(&r_thread_data[i], NULL);
+            if (NULL != inbuf)
+            {
+                tiovx_modules_enqueue_buf(inbuf);
+            }
         }
     }
 
@@ -807,296 +1738,307 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
     }
 
 #if defined(TARGET_OS_LINUX)
-    /* Enqueue half buffer from pool to tiovx graph for v4l2 capture */
-    uint8_t buf_cnt = 0;
-    while(buf_cnt < 2)
+    /* Enqueue two captured buffers per v4l2 capture to tiovx graph */
+    for(i = 0; i < num_input_blocks; i++)
     {
-        bool skip = false;
-
-        for(i = 0; i < num_input_blocks; i++)
+        if (LINUX_CAM == input_blocks[i].input_info->source)
         {
-            if (LINUX_CAM == input_blocks[i].input_info->source)
+            for (j = 0; j < 2 && run_loop; j++)
             {
-                /*
-                 * Dqueue v4l2 buffers and if not NULL store in valid buffers
-                 * which will be used later to enqueue and dqueue in openvx graph
-                 */
-                v4l2_dq_bufs[i] = v4l2_capture_dqueue_buf(input_blocks[i].v4l2_obj.v4l2_capture_handle);
-                if(NULL != v4l2_dq_bufs[i] && NULL ==  v4l2_valid_bufs[i])
+                inbuf = NULL;
+                while(run_loop && NULL == inbuf)
+                {
+                    inbuf = v4l2_capture_dqueue_buf(input_blocks[i].v4l2_obj.v4l2_capture_handle);
+                }
+                if(NULL != inbuf)
                 {
-                    v4l2_valid_bufs[i] = v4l2_dq_bufs[i];
-                    v4l2_dq_bufs[i] = NULL;
+                    tiovx_modules_enqueue_buf(inbuf);
                 }
             }
         }
+    }
+#endif
 
-        for(i = 0; i < num_input_blocks; i++)
+    /* One runtime per graph, runtimes[0] drives graph */
+    status = VX_SUCCESS;
+    for(i = 0; i < 1 + num_flow_graphs && VX_SUCCESS == status; i++)
+    {
+        status = tiovx_modules_runtime_init(&runtimes[i],
+                                            (0 == i) ? &graph : &flow_graphs[i - 1]);
+        if(VX_SUCCESS == status)
         {
-            if (LINUX_CAM == input_blocks[i].input_info->source &&
-                NULL == v4l2_valid_bufs[i])
-            {
-                /*
-                 * Skip if any v4l2 buffer is not there
-                 */
-                skip = true;
-                break;
-            }
+            num_runtimes++;
         }
+    }
 
-        for(i = 0; i < num_input_blocks; i++)
+    /* Register a callback for every exposed graph parameter */
+    for(i = 0; i < num_input_blocks && VX_SUCCESS == status; i++)
+    {
+        flow_runtime = (0 != num_flow_graphs) ? &runtimes[1 + i] : &runtimes[0];
+
+        in_cb_data[i].id = i;
+        in_cb_data[i].input_block = &input_blocks[i];
+        in_cb_data[i].output_block = NULL;
+        in_cb_data[i].r_thread_data = &r_thread_data[i];
+        in_cb_data[i].w_thread_data = NULL;
+        in_cb_data[i].graph = &graph;
+        in_cb_data[i].cmd_args = cmd_args;
+        in_cb_data[i].perf_stats_handle = &perf_stats_handle;
+        /* Without perf overlay, perf is updated with the first input */
+        in_cb_data[i].perf_tick = (0 == i && !overlay_perf_graph &&
+                                   (cmd_args->verbose || cmd_args->gen_data ||
+                                    use_metrics));
+        in_cb_data[i].num_frames = 0;
+        in_cb_data[i].num_dropped = 0;
+
+        status = tiovx_modules_runtime_add_source(flow_runtime,
+                                                  input_blocks[i].input_pad,
+                                                  input_cb,
+                                                  &in_cb_data[i]);
+
+        if (VX_SUCCESS == status && rate_at_source(&flow_infos[i]))
         {
-            if (LINUX_CAM == input_blocks[i].input_info->source)
+            status = tiovx_modules_runtime_set_rate(flow_runtime,
+                                                    input_blocks[i].input_pad,
+                                                    flow_infos[i].subflow_infos[0].decimation,
+                                                    flow_infos[i].subflow_infos[0].fps);
+        }
+        else if (VX_SUCCESS == status && 0 == num_flow_graphs)
+        {
+            for (j = 0; j < flow_infos[i].num_subflows; j++)
             {
-                /*
-                 * If all v4l2 buffers are present, enqueue to openvx graph.
-                 */
-                if(!skip)
-                {
-                    tiovx_modules_enqueue_buf(v4l2_valid_bufs[i]);
-                    v4l2_valid_bufs[i] = NULL;
-
-                    /* AEWB processing for linux */
-                    linux_h3a_buf_pool = input_blocks[i].v4l2_obj.h3a_pad->buf_pool;
-                    linux_aewb_buf_pool = input_blocks[i].v4l2_obj.aewb_pad->buf_pool;
-                    linux_h3a_buf = tiovx_modules_dequeue_buf(linux_h3a_buf_pool);
-                    linux_aewb_buf = tiovx_modules_dequeue_buf(linux_aewb_buf_pool);
-                    aewb_process(input_blocks[i].v4l2_obj.aewb_handle, linux_h3a_buf, linux_aewb_buf);
-                    tiovx_modules_enqueue_buf(linux_h3a_buf);
-                    tiovx_modules_enqueue_buf(linux_aewb_buf);
-                }
-
-                /*
-                 * Else, enqueue back the dequeue buffer from v4l2 capture
-                 */
-                if(NULL != v4l2_dq_bufs[i])
+                if (has_rate(&flow_infos[i].subflow_infos[j]))
                 {
-                    v4l2_capture_enqueue_buf(input_blocks[i].v4l2_obj.v4l2_capture_handle, v4l2_dq_bufs[i]);
+                    TIOVX_APPS_ERROR("Subflow rate of flow %d ignored, "
+                                     "needs --multi-graph\n", i);
+                    break;
                 }
             }
         }
-
-        if(!skip)
+#if defined(TARGET_OS_LINUX)
+        if (VX_SUCCESS == status &&
+            LINUX_CAM == input_blocks[i].input_info->source)
         {
-            buf_cnt++;
+            status = tiovx_modules_runtime_add_sink(flow_runtime,
+                                                    input_blocks[i].v4l2_obj.h3a_pad,
+                                                    h3a_cb,
+                                                    &in_cb_data[i]);
         }
-
+#endif
     }
 
-    for (i = 0; i < num_flows; i++)
+    for(i = 0; i < num_output_blocks && VX_SUCCESS == status; i++)
     {
-        v4l2_valid_bufs[i] = NULL;
-        v4l2_dq_bufs[i] = NULL;
-    }
-
-#endif
+        out_cb_data[i].id = i;
+        out_cb_data[i].input_block = NULL;
+        out_cb_data[i].output_block = &output_blocks[i];
+        out_cb_data[i].r_thread_data = NULL;
+        out_cb_data[i].w_thread_data = &w_thread_data[i];
+        out_cb_data[i].graph = &graph;
+        out_cb_data[i].cmd_args = cmd_args;
+        out_cb_data[i].perf_stats_handle = &perf_stats_handle;
+        out_cb_data[i].perf_tick = false;
 
+        if(NULL != output_blocks[i].output_pad)
+        {
+            status = tiovx_modules_runtime_add_sink(&runtimes[0],
+                                                    output_blocks[i].output_pad,
+                                                    output_cb,
+                                                    &out_cb_data[i]);
+        }
+        if(VX_SUCCESS == status && NULL != output_blocks[i].perf_overlay_pad)
+        {
+            status = tiovx_modules_runtime_add_source(&runtimes[0],
+                                                      output_blocks[i].perf_overlay_pad,
+                                                      perf_overlay_cb,
+                                                      &out_cb_data[i]);
+        }
+    }
 
-    /* Main loop that runs till interrupt */
-    while(run_loop)
+    /* Hand over frames from flow graphs to mosaic inputs of graph */
+    for(i = 0; i < num_output_blocks && VX_SUCCESS == status; i++)
     {
-        bool skip = false;
-
-#if defined(TARGET_OS_LINUX)
-        /***********************************************************************
-        *                        V4L2 Sources                                  *
-        ***********************************************************************/
-
-        for(i = 0; i < num_input_blocks; i++)
+        for(j = 0; j < output_blocks[i].num_inputs && VX_SUCCESS == status; j++)
         {
-            if (LINUX_CAM == input_blocks[i].input_info->source)
+            Pad *src_pad = output_blocks[i].input_pads[j];
+            Pad *sink_pad = output_blocks[i].bridge_pads[j];
+            Bridge *bridge = &bridges[num_bridges];
+            SubflowInfo *subflow_info = NULL;
+            uint32_t k, flow_idx;
+
+            if(NULL == sink_pad)
             {
-                /*
-                 * Dqueue v4l2 buffers and if not NULL store in valid buffers
-                 * which will be used later to enqueue and dqueue in openvx graph
-                 */
-                v4l2_dq_bufs[i] = v4l2_capture_dqueue_buf(input_blocks[i].v4l2_obj.v4l2_capture_handle);
-                if(NULL != v4l2_dq_bufs[i] && NULL ==  v4l2_valid_bufs[i])
-                {
-                    v4l2_valid_bufs[i] = v4l2_dq_bufs[i];
-                    v4l2_dq_bufs[i] = NULL;
-                }
+                continue;
             }
-        }
 
-        for(i = 0; i < num_input_blocks; i++)
-        {
-            if (LINUX_CAM == input_blocks[i].input_info->source &&
-                NULL == v4l2_valid_bufs[i])
+            status = tiovx_modules_bridge_init(bridge, src_pad, sink_pad,
+                                               BRIDGE_TIMEOUT_MS);
+            if(VX_SUCCESS != status)
             {
-                /*
-                 * Skip if any v4l2 buffer is not there
-                 */
-                skip = true;
                 break;
             }
-        }
+            num_bridges++;
 
-        for(i = 0; i < num_input_blocks; i++)
-        {
-            in_buf_pool = input_blocks[i].input_pad->buf_pool;
-            if (LINUX_CAM == input_blocks[i].input_info->source)
+            /* Subflow rate not applied at the source limits its handoff */
+            flow_idx = src_pad->node->graph - flow_graphs;
+            subflow_info = output_blocks[i].input_subflows[j];
+            if(NULL != subflow_info && has_rate(subflow_info) &&
+               !rate_at_source(&flow_infos[flow_idx]))
             {
-                /*
-                 * If all v4l2 buffers are present, enqueue and dequeue to
-                 * openvx graph.
-                 */
-                if(!skip)
-                {
-                    tiovx_modules_enqueue_buf(v4l2_valid_bufs[i]);
-                    inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-                    v4l2_capture_enqueue_buf(input_blocks[i].v4l2_obj.v4l2_capture_handle, inbuf);
-                    v4l2_valid_bufs[i] = NULL;
-
-                    /* AEWB processing for linux */
-                    linux_h3a_buf_pool = input_blocks[i].v4l2_obj.h3a_pad->buf_pool;
-                    linux_aewb_buf_pool = input_blocks[i].v4l2_obj.aewb_pad->buf_pool;
-                    linux_h3a_buf = tiovx_modules_dequeue_buf(linux_h3a_buf_pool);
-                    linux_aewb_buf = tiovx_modules_dequeue_buf(linux_aewb_buf_pool);
-                    aewb_process(input_blocks[i].v4l2_obj.aewb_handle, linux_h3a_buf, linux_aewb_buf);
-                    tiovx_modules_enqueue_buf(linux_h3a_buf);
-                    tiovx_modules_enqueue_buf(linux_aewb_buf);
-                }
-
-                /*
-                 * Else, enqueue back the dequeue buffer from v4l2 capture
-                 */
-                if(NULL != v4l2_dq_bufs[i])
-                {
-                    v4l2_capture_enqueue_buf(input_blocks[i].v4l2_obj.v4l2_capture_handle, v4l2_dq_bufs[i]);
-                }
-
+                tiovx_modules_bridge_set_rate(bridge,
+                                              subflow_info->decimation,
+                                              subflow_info->fps);
             }
-        }
-
-        if(skip)
-        {
-            continue;
-        }
-#endif
 
-        /***********************************************************************
-        *                        Other Sources                                 *
-        ***********************************************************************/
-        for(i = 0; i < num_input_blocks; i++)
-        {
-            in_buf_pool = input_blocks[i].input_pad->buf_pool;
-            if (RTOS_CAM == input_blocks[i].input_info->source)
+            /* Prime producer with all buffers and consumer with all but
+             * the one held in bridge slot
+             */
             {
-                /* Dequeue and the enqueue buffers */
-                inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-                tiovx_modules_enqueue_buf(inbuf);
-            }
+                Buf *src_bufs[src_pad->buf_pool->bufq_depth];
+                Buf *sink_bufs[sink_pad->buf_pool->bufq_depth];
 
-#if defined(TARGET_OS_LINUX)
-            else if (VIDEO == input_blocks[i].input_info->source)
-            {
-                /* Dequeue from graph, enqueue to v4l2 for decode,
-                 * then dequeue from v4l2 and enqueue to graph
-                 */
-                inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-                v4l2_decode_enqueue_buf(input_blocks[i].v4l2_obj.v4l2_decode_handle, inbuf);
-                inbuf = v4l2_decode_dqueue_buf(input_blocks[i].v4l2_obj.v4l2_decode_handle);
-                if(NULL == inbuf)
+                for(k = 0; k < src_pad->buf_pool->bufq_depth; k++)
                 {
-                    run_loop = false;
-                    skip = true;
-                    break;
+                    src_bufs[k] = tiovx_modules_acquire_buf(src_pad->buf_pool);
                 }
-                tiovx_modules_enqueue_buf(inbuf);
+                tiovx_modules_enqueue_bufs(src_bufs, src_pad->buf_pool->bufq_depth);
+
+                for(k = 0; k < sink_pad->buf_pool->bufq_depth - 1; k++)
+                {
+                    sink_bufs[k] = tiovx_modules_acquire_buf(sink_pad->buf_pool);
+                }
+                tiovx_modules_enqueue_bufs(sink_bufs, sink_pad->buf_pool->bufq_depth - 1);
             }
-#endif
 
-            else if (RAW_IMG == input_blocks[i].input_info->source)
+            flow_runtime = &runtimes[1 + flow_idx];
+            status = tiovx_modules_runtime_add_sink(flow_runtime,
+                                                    src_pad,
+                                                    tiovx_modules_bridge_push,
+                                                    bridge);
+            if(VX_SUCCESS == status)
             {
-                /* Dequeue the buffer, send to read image thread for filling
-                 * the buffer and the enqueue it
-                 */
-                inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-
-                pthread_mutex_lock(&r_thread_lock[i]);
-                r_thread_data[i].read_image_buf = inbuf;
-                pthread_mutex_unlock(&r_thread_lock[i]);
-
-                tiovx_modules_enqueue_buf(inbuf);
+                status = tiovx_modules_runtime_add_source(&runtimes[0],
+                                                          sink_pad,
+                                                          tiovx_modules_bridge_pull,
+                                                          bridge);
             }
         }
+    }
 
-        if(skip)
+    for(i = 0; i < num_runtimes && VX_SUCCESS == status; i++)
+    {
+        status = tiovx_modules_runtime_start(&runtimes[i]);
+        if(VX_SUCCESS == status)
         {
-            break;
+            num_started++;
         }
+    }
+
+    /* Serve metrics while running */
+    if(VX_SUCCESS == status && use_metrics)
+    {
+        m_data.graph = &graph;
+        m_data.flow_graphs = flow_graphs;
+        m_data.num_flow_graphs = num_flow_graphs;
+        m_data.in_cb_data = in_cb_data;
+        m_data.num_flows = num_input_blocks;
+        m_data.bridges = bridges;
+        m_data.num_bridges = num_bridges;
+        m_data.perf_stats_handle = &perf_stats_handle;
+        clock_gettime(CLOCK_MONOTONIC, &m_data.prev_ts);
+
+        status = metrics_server_start(&metrics_server,
+                                      cmd_args->metrics_socket,
+                                      collect_metrics,
+                                      &m_data);
+    }
 
-        for(i = 0; i < num_output_blocks; i++)
+    /* Run till interrupt or till a source or sink ends */
+    if(VX_SUCCESS == status)
+    {
+        while(run_loop && !finished)
         {
-            if(NULL != output_blocks[i].output_pad)
+            finished = tiovx_modules_runtime_wait(&runtimes[0], 100);
+            for(i = 1; i < num_runtimes && !finished; i++)
             {
-                /* Dequeue and enqueue output buffer if pad is present */
-                out_buf_pool = output_blocks[i].output_pad->buf_pool;
-                outbuf = tiovx_modules_dequeue_buf(out_buf_pool);
-                if (IMG_DIR == output_blocks[i].output_info->sink)
-                {
-                    /* Update write image thread buffer */
-                    pthread_mutex_lock(&w_thread_lock[i]);
-                    w_thread_data[i].write_image_buf = outbuf;
-                    pthread_mutex_unlock(&w_thread_lock[i]);
-                }
-#if defined(TARGET_OS_LINUX)
-                else if (LINUX_DISPLAY == output_blocks[i].output_info->sink)
-                {
-                    /* Render the dequeued buffer on kms display */
-                    kms_display_render_buf(output_blocks[i].kms_obj.kms_display_handle,
-                                           outbuf);
-                }
-                else if (H264_ENCODE == output_blocks[i].output_info->sink ||
-                         H265_ENCODE == output_blocks[i].output_info->sink)
-                {
-                    v4l2_encode_enqueue_buf(output_blocks[i].v4l2_obj.v4l2_encode_handle, outbuf);
-                    outbuf = v4l2_encode_dqueue_buf(output_blocks[i].v4l2_obj.v4l2_encode_handle);
-                    if(NULL == outbuf)
-                    {
-                        run_loop = false;
-                        break;
-                    }
-                }
-#endif
-                tiovx_modules_enqueue_buf(outbuf);
+                finished = tiovx_modules_runtime_wait(&runtimes[i], 0);
             }
 
-            /* Dequeue and enqueue perf overlay buffer */
-            if(NULL != output_blocks[i].perf_overlay_pad)
+            /* Measure calibration frames once the pipeline is warm */
+            if(calibrate)
             {
-                perf_overlay_buf_pool = output_blocks[i].perf_overlay_pad->buf_pool;
-                perf_overlay_buf = tiovx_modules_dequeue_buf(perf_overlay_buf_pool);
-                update_perf_overlay((vx_image)perf_overlay_buf->handle, &perf_stats_handle);
-                if(cmd_args->verbose)
+                uint64_t frames = __atomic_load_n(&in_cb_data[0].num_frames,
+                                                  __ATOMIC_RELAXED);
+
+                if(!calibrating && frames >= CALIBRATE_WARMUP_FRAMES)
                 {
-                    print_perf(&graph, &perf_stats_handle);
+                    reset_graph_pad_stats(&graph);
+                    for(i = 0; i < num_flow_graphs; i++)
+                    {
+                        reset_graph_pad_stats(&flow_graphs[i]);
+                    }
+                    calibrate_start = frames;
+                    calibrating = true;
                 }
-                if(cmd_args->gen_data)
+                else if(calibrating &&
+                        frames - calibrate_start >= cmd_args->calibrate_frames)
                 {
-                    generate_datasheet(&graph, &perf_stats_handle);
+                    break;
                 }
-                tiovx_modules_enqueue_buf(perf_overlay_buf);
             }
         }
 
-        if(!overlay_perf_graph && cmd_args->verbose)
-        {
-            update_perf_overlay(NULL, &perf_stats_handle);
-            print_perf(&graph, &perf_stats_handle);
-        }
-        if(!overlay_perf_graph && cmd_args->gen_data)
+        /* Recommend depths before stopping drains the queues */
+        if(calibrating &&
+           0 != save_bufq_depths(cmd_args->bufq_file,
+                                 &graph,
+                                 flow_graphs,
+                                 num_flow_graphs))
         {
-            update_perf_overlay(NULL, &perf_stats_handle);
-            generate_datasheet(&graph, &perf_stats_handle);
+            TIOVX_APPS_ERROR("Error saving buffer depths\n");
         }
     }
+    else
+    {
+        TIOVX_APPS_ERROR("Error starting runtime\n");
+    }
+    run_loop = 0;
+
+    metrics_server_stop(&metrics_server);
+
+    /* Stops callbacks and drains buffers still in the graphs */
+    for(i = 0; i < num_started; i++)
+    {
+        tiovx_modules_runtime_stop(&runtimes[i]);
+    }
+
+    for(i = 0; i < num_bridges; i++)
+    {
+        tiovx_modules_bridge_deinit(&bridges[i]);
+    }
+
+    for(i = 0; i < num_runtimes; i++)
+    {
+        tiovx_modules_runtime_deinit(&runtimes[i]);
+    }
 
     /* Stop all read image threads */
     for (i = 0; i < num_r_threads; i++)
     {
         pthread_join(read_img_thread_id[i], NULL); 
     }
+    for (i = 0; i < num_input_blocks; i++)
+    {
+        if (RAW_IMG == input_blocks[i].input_info->source)
+        {
+            pthread_cond_destroy(&r_thread_data[i].cond);
+            raw_img_list_close(&r_thread_data[i].img_list);
+            if (r_thread_data[i].num_cached > 0)
+            {
+                read_img_free_cache(&r_thread_data[i]);
+            }
+        }
+    }
 
     /* Stop all write image threads */
     for (i = 0; i < num_w_threads; i++)
@@ -1105,43 +2047,21 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
     }
 
     /* Stop handles */
+#if defined(TARGET_OS_LINUX)
     for(i = 0; i < num_input_blocks; i++)
     {
-        in_buf_pool = input_blocks[i].input_pad->buf_pool;
-        /* Why RTOS Cam needs two */
-        if (RTOS_CAM == input_blocks[i].input_info->source)
-        {
-            for(j = 0; j < in_buf_pool->bufq_depth - 2; j++)
-            {
-                inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-                tiovx_modules_release_buf(inbuf);
-            }
-        }
-#if defined(TARGET_OS_LINUX)
-        else if (LINUX_CAM == input_blocks[i].input_info->source)
+        if (LINUX_CAM == input_blocks[i].input_info->source)
         {
-            for(j = 0; j < 2; j++) {
-                inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-                tiovx_modules_release_buf(inbuf);
-            }
             v4l2_capture_stop(input_blocks[i].v4l2_obj.v4l2_capture_handle);
             v4l2_capture_delete_handle(input_blocks[i].v4l2_obj.v4l2_capture_handle);
         }
         else if (VIDEO == input_blocks[i].input_info->source)
         {
-            inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-            tiovx_modules_release_buf(inbuf);
             v4l2_decode_stop(input_blocks[i].v4l2_obj.v4l2_decode_handle);
             v4l2_decode_delete_handle(input_blocks[i].v4l2_obj.v4l2_decode_handle);
         }
-        else {
-            inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
-            tiovx_modules_release_buf(inbuf);
-        }
-#endif
     }
 
-#if defined(TARGET_OS_LINUX)
     for(i = 0; i < num_output_blocks; i++)
     {
         if (H264_ENCODE == output_blocks[i].output_info->sink ||
@@ -1159,6 +2079,14 @@ int32_t run_app(FlowInfo flow_infos[], uint32_t num_flows, CmdArgs *cmd_args)
 
 clean_graph:
 
+    tiovx_modules_trace_stop();
+
+    for(i = 0; i < num_flow_graphs; i++)
+    {
+        tiovx_modules_clean_graph(&flow_graphs[i]);
+    }
+    free(flow_graphs);
+
     tiovx_modules_clean_graph(&graph);
 
 exit:
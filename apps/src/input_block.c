@@ -646,6 +646,31 @@ int32_t create_input_block(GraphObj *graph, InputBlock *input_block)
         }
     }
    
+    if(RAW_IMG == input_info->source)
+    {
+        input_pad->bufq_depth = RAW_IMG_BUFQ_DEPTH;
+    }
+
+    /* Only RAW_IMG takes its buffers from the pool, so only it can drop
+     * into the pool. LINUX_CAM drops in v4l2, see input_cb.
+     */
+    if(RAW_IMG == input_info->source &&
+       TIOVX_MODULES_DROP_NONE != input_info->drop_policy)
+    {
+        input_pad->drop_policy = (DROP_POLICY)input_info->drop_policy;
+        input_pad->max_queued = input_info->max_queued;
+        if(0 == input_pad->max_queued)
+        {
+            input_pad->max_queued = (input_pad->bufq_depth > 1) ?
+                                    input_pad->bufq_depth - 1 : 1;
+        }
+
+        /* Leave buffers to hold or drop beyond those in the graph */
+        if(input_pad->max_bufq_depth <= input_pad->max_queued)
+        {
+            input_pad->max_bufq_depth = input_pad->max_queued + 1;
+        }
+    }
     input_block->input_pad = input_pad;
 
     return status;
@@ -64,6 +64,7 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <yaml_parser.h>
+#include <flow_cache.h>
 
 #include <TI/tivx.h>
 #include <app_init.h>
@@ -82,6 +83,13 @@ int main(int argc, char *argv[])
     cmd_args.verbose = false;
     cmd_args.gen_data = false;
     cmd_args.dump_dot = false;
+    cmd_args.multi_graph = false;
+    cmd_args.trace_file[0] = '\0';
+    cmd_args.metrics_socket[0] = '\0';
+    cmd_args.bufq_file[0] = '\0';
+    cmd_args.calibrate_frames = 0;
+    cmd_args.cache_file[0] = '\0';
+    cmd_args.profile_file[0] = '\0';
 
     int32_t long_index;
     int32_t opt;
@@ -91,10 +99,17 @@ int main(int argc, char *argv[])
         {"verbose",   no_argument,       0, 'v' },
         {"datasheet", no_argument,       0, 'g' },
         {"dump",      no_argument,       0, 'd' },
+        {"multi-graph", no_argument,     0, 'm' },
+        {"trace",     required_argument, 0, 't' },
+        {"metrics",   required_argument, 0, 's' },
+        {"bufq",      required_argument, 0, 'b' },
+        {"calibrate", required_argument, 0, 'c' },
+        {"cache",     required_argument, 0, 'k' },
+        {"profile",   required_argument, 0, 'p' },
         {0,           0,                 0,  0  }
     };
 
-    while ((opt = getopt_long(argc, argv,"-hvgdl:",
+    while ((opt = getopt_long(argc, argv,"-hvgdmt:s:b:c:k:p:l:",
                    long_options, &long_index )) != -1)
     {
         switch (opt)
@@ -111,6 +126,32 @@ int main(int argc, char *argv[])
             case 'd' :
                 cmd_args.dump_dot = true;
                 break;
+            case 'm' :
+                cmd_args.multi_graph = true;
+                break;
+            case 't' :
+                snprintf(cmd_args.trace_file, sizeof(cmd_args.trace_file),
+                         "%s", optarg);
+                break;
+            case 's' :
+                snprintf(cmd_args.metrics_socket,
+                         sizeof(cmd_args.metrics_socket), "%s", optarg);
+                break;
+            case 'b' :
+                snprintf(cmd_args.bufq_file, sizeof(cmd_args.bufq_file),
+                         "%s", optarg);
+                break;
+            case 'c' :
+                cmd_args.calibrate_frames = atoi(optarg);
+                break;
+            case 'k' :
+                snprintf(cmd_args.cache_file, sizeof(cmd_args.cache_file),
+                         "%s", optarg);
+                break;
+            case 'p' :
+                snprintf(cmd_args.profile_file, sizeof(cmd_args.profile_file),
+                         "%s", optarg);
+                break;
             case 'h' :
             default:
                 printf("# \n");
@@ -121,6 +162,13 @@ int main(int argc, char *argv[])
                 printf("#  [--verbose    |-v]\n");
                 printf("#  [--datasheet  |-g]\n");
                 printf("#  [--dump       |-d]\n");
+                printf("#  [--multi-graph|-m]\n");
+                printf("#  [--trace FILE |-t]\n");
+                printf("#  [--metrics SOCKET|-s]\n");
+                printf("#  [--bufq FILE  |-b]\n");
+                printf("#  [--calibrate FRAMES|-c]\n");
+                printf("#  [--cache FILE |-k]\n");
+                printf("#  [--profile FILE|-p]\n");
                 printf("#  [--help       |-h]\n");
                 printf("# \n");
                 printf("# (C) Texas Instruments 2024\n");
@@ -132,14 +180,35 @@ int main(int argc, char *argv[])
         }
     }
 
-    status = parse_yaml_file(cmd_args.config_file,
+    /* Flows resolved on a previous start skip parsing */
+    if ('\0' != cmd_args.cache_file[0] &&
+        0 == load_flow_cache(cmd_args.cache_file,
+                             cmd_args.config_file,
                              flow_infos,
                              MAX_FLOWS,
-                             &num_flows);
-    if (0 != status)
+                             &num_flows))
     {
-        TIOVX_APPS_ERROR("Could not parse %s.\n", cmd_args.config_file);
-        return status;
+        TIOVX_APPS_PRINTF("Using flows cached in %s.\n", cmd_args.cache_file);
+    }
+    else
+    {
+        status = parse_yaml_file(cmd_args.config_file,
+                                 flow_infos,
+                                 MAX_FLOWS,
+                                 &num_flows);
+        if (0 != status)
+        {
+            TIOVX_APPS_ERROR("Could not parse %s.\n", cmd_args.config_file);
+            return status;
+        }
+
+        if ('\0' != cmd_args.cache_file[0])
+        {
+            save_flow_cache(cmd_args.cache_file,
+                            cmd_args.config_file,
+                            flow_infos,
+                            num_flows);
+        }
     }
 
     status = appInit();
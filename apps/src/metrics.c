@@ -0,0 +1,303 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <apps/include/metrics.h>
+
+#include <stdlib.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+/* Time a client gets to send its request before Prometheus text is sent */
+#define METRICS_REQUEST_TIMEOUT_MS 100
+
+/* Time a blocked write to a client may take before the client is dropped */
+#define METRICS_SEND_TIMEOUT_MS 1000
+
+static uint64_t metrics_get_time_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Label values come from the config, like node and flow names. Both
+ * formats escape backslash, quote and newline the same way, JSON also
+ * needs the other control characters escaped.
+ */
+static void metrics_write_value(MetricsWriter *writer, const char *val)
+{
+    const char *c;
+
+    for(c = val; '\0' != *c; c++)
+    {
+        if('\\' == *c || '"' == *c)
+        {
+            fputc('\\', writer->fp);
+            fputc(*c, writer->fp);
+        }
+        else if('\n' == *c)
+        {
+            fputs("\\n", writer->fp);
+        }
+        else if(writer->json && (unsigned char)*c < 0x20)
+        {
+            fprintf(writer->fp, "\\u%04x", (unsigned char)*c);
+        }
+        else
+        {
+            fputc(*c, writer->fp);
+        }
+    }
+}
+
+void metrics_add(MetricsWriter *writer, MetricsType type, const char *name,
+                 double value, uint32_t num_labels, ...)
+{
+    va_list args;
+    const char *key, *val;
+    uint32_t i;
+
+    va_start(args, num_labels);
+
+    if(writer->json)
+    {
+        fprintf(writer->fp, "{\"ts\":%lu,\"name\":\"%s\"",
+                (unsigned long)writer->ts_ms, name);
+        for(i = 0; i < num_labels; i++)
+        {
+            key = va_arg(args, const char *);
+            val = va_arg(args, const char *);
+            fprintf(writer->fp, ",\"%s\":\"", key);
+            metrics_write_value(writer, val);
+            fputc('"', writer->fp);
+        }
+        fprintf(writer->fp, ",\"value\":%g}\n", value);
+    }
+    else
+    {
+        /* Samples of one metric are added together, so one TYPE line */
+        if(NULL == writer->last_name || 0 != strcmp(writer->last_name, name))
+        {
+            fprintf(writer->fp, "# TYPE %s %s\n", name,
+                    (METRICS_COUNTER == type) ? "counter" : "gauge");
+            writer->last_name = name;
+        }
+
+        fprintf(writer->fp, "%s", name);
+        for(i = 0; i < num_labels; i++)
+        {
+            key = va_arg(args, const char *);
+            val = va_arg(args, const char *);
+            fprintf(writer->fp, "%s%s=\"", (0 == i) ? "{" : ",", key);
+            metrics_write_value(writer, val);
+            fputc('"', writer->fp);
+        }
+        fprintf(writer->fp, "%s %g\n", (0 == num_labels) ? "" : "}", value);
+    }
+
+    va_end(args);
+}
+
+static void metrics_serve_client(MetricsServer *server, int fd)
+{
+    MetricsWriter writer;
+    struct timeval tv;
+    char request[256];
+    ssize_t len;
+    bool http;
+
+    tv.tv_sec = 0;
+    tv.tv_usec = METRICS_REQUEST_TIMEOUT_MS * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    /* A client that stops reading must not hold up the server or stop */
+    tv.tv_sec = METRICS_SEND_TIMEOUT_MS / 1000;
+    tv.tv_usec = (METRICS_SEND_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    len = recv(fd, request, sizeof(request) - 1, 0);
+    if(len < 0)
+    {
+        len = 0;
+    }
+    request[len] = '\0';
+
+    writer.fp = fdopen(fd, "w");
+    if(NULL == writer.fp)
+    {
+        close(fd);
+        return;
+    }
+
+    http = (0 == strncmp(request, "GET ", 4));
+    writer.json = (NULL != strstr(request, "json"));
+    writer.last_name = NULL;
+    writer.ts_ms = metrics_get_time_ms();
+
+    if(http)
+    {
+        fprintf(writer.fp, "HTTP/1.0 200 OK\r\nContent-Type: %s\r\n\r\n",
+                writer.json ? "application/x-ndjson" :
+                              "text/plain; version=0.0.4");
+    }
+
+    server->collect(&writer, server->priv);
+
+    fclose(writer.fp);
+}
+
+static void *metrics_server_thread(void *arg)
+{
+    MetricsServer *server = (MetricsServer *)arg;
+    int fd;
+
+    while(server->running)
+    {
+        fd = accept(server->fd, NULL, NULL);
+        if(fd < 0)
+        {
+            continue;
+        }
+
+        metrics_serve_client(server, fd);
+    }
+
+    return NULL;
+}
+
+int32_t metrics_server_start(MetricsServer *server, const char *path,
+                             MetricsCollect collect, void *priv)
+{
+    struct sockaddr_un addr;
+    struct timeval tv;
+
+    if(strlen(path) >= sizeof(addr.sun_path))
+    {
+        TIOVX_APPS_ERROR("Metrics socket path too long: %s\n", path);
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    snprintf(server->path, sizeof(server->path), "%s", path);
+    server->collect = collect;
+    server->priv = priv;
+
+    server->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server->fd < 0)
+    {
+        TIOVX_APPS_ERROR("Unable to create metrics socket\n");
+        return -1;
+    }
+
+    /* Wake up accept regularly to check for stop */
+    tv.tv_sec = 0;
+    tv.tv_usec = 500000;
+    setsockopt(server->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    unlink(path);
+    if(0 != bind(server->fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+       0 != listen(server->fd, 4))
+    {
+        TIOVX_APPS_ERROR("Unable to listen on %s\n", path);
+        close(server->fd);
+        return -1;
+    }
+
+    /* A scraper closing early must not kill the app */
+    signal(SIGPIPE, SIG_IGN);
+
+    server->running = true;
+    if(0 != pthread_create(&server->thread, NULL, metrics_server_thread,
+                           server))
+    {
+        TIOVX_APPS_ERROR("Unable to create metrics thread\n");
+        server->running = false;
+        close(server->fd);
+        unlink(path);
+        return -1;
+    }
+
+    return 0;
+}
+
+void metrics_server_stop(MetricsServer *server)
+{
+    if(!server->running)
+    {
+        return;
+    }
+
+    server->running = false;
+    pthread_join(server->thread, NULL);
+    close(server->fd);
+    unlink(server->path);
+}
@@ -260,14 +260,14 @@ void print_perf(GraphObj *graph, EdgeAIPerfStats *perf_stats_handle)
 
         for(uint32_t i = 0; i < graph->num_nodes; i++)
         {
-            if(TIOVX_TIDL == graph->node_list[i].node_type)
+            if(TIOVX_TIDL == graph->node_list[i]->node_type)
             {
                 vx_perf_t perf;
-                vxQueryNode(graph->node_list[i].tiovx_node,
+                vxQueryNode(graph->node_list[i]->tiovx_node,
                             VX_NODE_PERFORMANCE,
                             &perf,
                             sizeof(perf));
-                printf("%s - %0.3f ms\n", graph->node_list[i].name, perf.avg/1000000.0);
+                printf("%s - %0.3f ms\n", graph->node_list[i]->name, perf.avg/1000000.0);
             }
         }
 
@@ -352,10 +352,10 @@ void generate_datasheet(GraphObj *graph, EdgeAIPerfStats *perf_stats_handle)
 
         for(uint32_t i = 0; i < graph->num_nodes; i++)
         {
-            if(TIOVX_TIDL == graph->node_list[i].node_type)
+            if(TIOVX_TIDL == graph->node_list[i]->node_type)
             {
                 vx_perf_t perf;
-                vxQueryNode(graph->node_list[i].tiovx_node,
+                vxQueryNode(graph->node_list[i]->tiovx_node,
                             VX_NODE_PERFORMANCE,
                             &perf,
                             sizeof(perf));
@@ -367,3 +367,276 @@ void generate_datasheet(GraphObj *graph, EdgeAIPerfStats *perf_stats_handle)
         fclose(fptr);
     }
 }
+
+void write_perf_metrics(MetricsWriter *writer, EdgeAIPerfStats *perf_stats_handle)
+{
+    Stats *stats = &perf_stats_handle->stats;
+    char label[32];
+
+    metrics_add(writer, METRICS_GAUGE, "tiovx_cpu_load_percent",
+                (float)stats->cpu_load.cpu_load/100, 1, "cpu", "mpu");
+
+#if defined(SOC_AM62A) || defined(SOC_J721E) || defined(SOC_J721S2) || defined(SOC_J784S4) || defined(SOC_J722S) || defined(SOC_J742S2)
+    for (uint32_t i = 0; i < APP_IPC_CPU_MAX; i++)
+    {
+        const char *cpu_name = appIpcGetCpuName(i);
+        if (appIpcIsCpuEnabled (i) &&
+            (NULL != strstr (cpu_name, "c7x") ||
+            NULL != strstr (cpu_name, "mcu")))
+        {
+            metrics_add(writer, METRICS_GAUGE, "tiovx_cpu_load_percent",
+                        (float)stats->cpu_loads[i].cpu_load/100,
+                        1, "cpu", cpu_name);
+        }
+    }
+
+    for (uint32_t i = 0; i < stats->hwa_count ; i++)
+    {
+        app_perf_stats_hwa_load_t *hwaLoad;
+        uint64_t load;
+        for (uint32_t j = 0; j < APP_PERF_HWA_MAX; j++)
+        {
+            app_perf_hwa_id_t id = (app_perf_hwa_id_t) j;
+            hwaLoad = &stats->hwa_loads[i].hwa_stats[id];
+
+            if (hwaLoad->active_time > 0 &&
+                hwaLoad->pixels_processed > 0 &&
+                hwaLoad->total_time > 0)
+            {
+                load = (hwaLoad->active_time * 10000) / hwaLoad->total_time;
+                metrics_add(writer, METRICS_GAUGE, "tiovx_hwa_load_percent",
+                            (float)load/100,
+                            1, "hwa", appPerfStatsGetHwaName (id));
+            }
+        }
+    }
+
+    /* Second pass, samples of a metric must not be split by another */
+    for (uint32_t i = 0; i < stats->hwa_count ; i++)
+    {
+        app_perf_stats_hwa_load_t *hwaLoad;
+        for (uint32_t j = 0; j < APP_PERF_HWA_MAX; j++)
+        {
+            app_perf_hwa_id_t id = (app_perf_hwa_id_t) j;
+            hwaLoad = &stats->hwa_loads[i].hwa_stats[id];
+
+            if (hwaLoad->active_time > 0 &&
+                hwaLoad->pixels_processed > 0 &&
+                hwaLoad->total_time > 0)
+            {
+                metrics_add(writer, METRICS_GAUGE, "tiovx_hwa_mpixels_per_second",
+                            hwaLoad->pixels_processed / hwaLoad->total_time,
+                            1, "hwa", appPerfStatsGetHwaName (id));
+            }
+        }
+    }
+#endif
+
+    metrics_add(writer, METRICS_GAUGE, "tiovx_ddr_bandwidth_mbps",
+                stats->ddr_load.read_bw_avg, 2, "dir", "read", "stat", "avg");
+    metrics_add(writer, METRICS_GAUGE, "tiovx_ddr_bandwidth_mbps",
+                stats->ddr_load.read_bw_peak, 2, "dir", "read", "stat", "peak");
+    metrics_add(writer, METRICS_GAUGE, "tiovx_ddr_bandwidth_mbps",
+                stats->ddr_load.write_bw_avg, 2, "dir", "write", "stat", "avg");
+    metrics_add(writer, METRICS_GAUGE, "tiovx_ddr_bandwidth_mbps",
+                stats->ddr_load.write_bw_peak, 2, "dir", "write", "stat", "peak");
+
+    for (uint32_t i = 0; i < NUM_THERMAL_ZONE; i++)
+    {
+        snprintf(label, sizeof(label), "%s", stats->soc_temp.thermal_zone_name[i]);
+        metrics_add(writer, METRICS_GAUGE, "tiovx_temperature_celsius",
+                    stats->soc_temp.thermal_zone_temp[i], 1, "zone", label);
+    }
+
+    metrics_add(writer, METRICS_GAUGE, "tiovx_fps", stats->fps, 0);
+}
+
+/* Stats of one floating pad, gathered before any sample is written */
+typedef struct {
+    const char  *graph_name;
+    const char  *node_name;
+    char        pad_name[16];
+    PadStats    stats;
+} PadMetrics;
+
+void write_graph_metrics(MetricsWriter *writer, GraphObj *graphs[],
+                         const char *graph_names[], uint32_t num_graphs)
+{
+    /* Prometheus needs all samples of a metric together, so every metric
+     * is written for all graphs and pads before the next one.
+     */
+    vx_perf_t perf;
+    PadMetrics *pads = NULL;
+    uint32_t num_pads = 0, max_pads = 0;
+    BufPool *buf_pool;
+    GraphObj *graph;
+    NodeObj *node;
+    Pad *pad;
+    uint32_t g, i, j;
+
+    for(g = 0; g < num_graphs; g++)
+    {
+        graph = graphs[g];
+        for(i = 0; i < graph->num_nodes; i++)
+        {
+            node = graph->node_list[i];
+            if((node->node_type == TIOVX_TEE) ||
+               (node->node_type == TIOVX_DELAY) ||
+               (node->node_type == TIOVX_FAKESINK))
+            {
+                continue;
+            }
+
+            vxQueryNode(node->tiovx_node,
+                        VX_NODE_PERFORMANCE,
+                        &perf,
+                        sizeof(perf));
+            metrics_add(writer, METRICS_GAUGE, "tiovx_node_latency_ms",
+                        perf.avg/1000000.0,
+                        2, "graph", graph_names[g], "node", node->name);
+        }
+    }
+
+    for(g = 0; g < num_graphs; g++)
+    {
+        vxQueryGraph(graphs[g]->tiovx_graph,
+                     VX_GRAPH_PERFORMANCE,
+                     &perf,
+                     sizeof(perf));
+        metrics_add(writer, METRICS_GAUGE, "tiovx_graph_latency_ms",
+                    perf.avg/1000000.0, 1, "graph", graph_names[g]);
+    }
+
+    /* Floating pads, only with collect_pad_stats set on the graph */
+    for(g = 0; g < num_graphs; g++)
+    {
+        graph = graphs[g];
+        for(i = 0; i < graph->num_nodes; i++)
+        {
+            node = graph->node_list[i];
+            for(j = 0; j < node->num_inputs + node->num_outputs; j++)
+            {
+                pad = (j < node->num_inputs) ? &node->sinks[j] :
+                                               &node->srcs[j - node->num_inputs];
+                buf_pool = pad->buf_pool;
+                if(NULL == buf_pool || !buf_pool->collect_stats)
+                {
+                    continue;
+                }
+
+                if(num_pads == max_pads)
+                {
+                    PadMetrics *grown;
+
+                    max_pads = (0 == max_pads) ? 16 : 2 * max_pads;
+                    grown = (PadMetrics *)realloc(pads, max_pads * sizeof(PadMetrics));
+                    if(NULL == grown)
+                    {
+                        free(pads);
+                        return;
+                    }
+                    pads = grown;
+                }
+
+                pads[num_pads].graph_name = graph_names[g];
+                pads[num_pads].node_name = node->name;
+                snprintf(pads[num_pads].pad_name, sizeof(pads[num_pads].pad_name),
+                         "%s%d", (SINK == pad->direction) ? "sink" : "src",
+                         pad->pad_index);
+                tiovx_modules_get_pad_stats(pad, &pads[num_pads].stats);
+                num_pads++;
+            }
+        }
+    }
+
+#define PAD_LABELS(p) "graph", (p)->graph_name, "node", (p)->node_name, \
+                      "pad", (p)->pad_name
+
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_GAUGE, "tiovx_pad_latency_us",
+                    pads[i].stats.graph_p50_us, 4, PAD_LABELS(&pads[i]),
+                    "quantile", "0.5");
+        metrics_add(writer, METRICS_GAUGE, "tiovx_pad_latency_us",
+                    pads[i].stats.graph_p95_us, 4, PAD_LABELS(&pads[i]),
+                    "quantile", "0.95");
+        metrics_add(writer, METRICS_GAUGE, "tiovx_pad_latency_us",
+                    pads[i].stats.graph_p99_us, 4, PAD_LABELS(&pads[i]),
+                    "quantile", "0.99");
+    }
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_GAUGE, "tiovx_pad_queue_depth",
+                    pads[i].stats.queue_depth, 3, PAD_LABELS(&pads[i]));
+    }
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_GAUGE, "tiovx_pad_queue_depth_avg",
+                    pads[i].stats.avg_queue_depth, 3, PAD_LABELS(&pads[i]));
+    }
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_COUNTER, "tiovx_pad_underruns_total",
+                    pads[i].stats.num_underruns, 3, PAD_LABELS(&pads[i]));
+    }
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_COUNTER, "tiovx_pad_acquire_waits_total",
+                    pads[i].stats.num_acquire_waits, 3, PAD_LABELS(&pads[i]));
+    }
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_COUNTER, "tiovx_pad_dequeue_empty_total",
+                    pads[i].stats.num_dequeue_empty, 3, PAD_LABELS(&pads[i]));
+    }
+    for(i = 0; i < num_pads; i++)
+    {
+        metrics_add(writer, METRICS_COUNTER, "tiovx_pad_dropped_total",
+                    pads[i].stats.num_dropped, 3, PAD_LABELS(&pads[i]));
+    }
+
+#undef PAD_LABELS
+
+    free(pads);
+}
+
+void reset_graph_pad_stats(GraphObj *graph)
+{
+    Pad *pad;
+
+    for(uint32_t i = 0; i < graph->num_nodes; i++)
+    {
+        NodeObj *node = graph->node_list[i];
+
+        for(uint32_t j = 0; j < node->num_inputs + node->num_outputs; j++)
+        {
+            pad = (j < node->num_inputs) ? &node->sinks[j] :
+                                           &node->srcs[j - node->num_inputs];
+            if(NULL != pad->buf_pool && NULL == pad->peer_pad)
+            {
+                tiovx_modules_reset_pad_stats(pad);
+            }
+        }
+    }
+}
+
+void print_bufq_depths(GraphObj *graph, const char *graph_name)
+{
+    BufqDepthHint hints[graph->num_graph_params + 1];
+    int32_t num_hints;
+
+    num_hints = tiovx_modules_recommend_bufq_depths(graph, hints,
+                                                    graph->num_graph_params);
+
+    printf("Buffer depths of %s\n", graph_name);
+    for(int32_t i = 0; i < num_hints; i++)
+    {
+        printf("    %s %s[%d] - %d -> %d, stalls %0.2f%%\n",
+               hints[i].pad->node->name,
+               (SINK == hints[i].pad->direction) ? "sink" : "src",
+               hints[i].pad->pad_index,
+               hints[i].bufq_depth,
+               hints[i].recommended,
+               hints[i].stall_ratio * 100);
+    }
+}
@@ -60,9 +60,18 @@
  *
  */
 
+#include <sys/stat.h>
+#include <errno.h>
+
 #include <apps/include/output_block.h>
 #include <apps/include/misc.h>
 
+/* Mosaic input fed through a bridge. One buffer is held by the bridge slot
+ * and two stay queued, so the mosaic has a frame to compose while the next
+ * one is swapped in from the other graph.
+ */
+#define MOSAIC_BRIDGE_BUFQ_DEPTH (3)
+
 #if defined(SOC_J784S4) || defined(SOC_J742S2)
 static char *g_encode_devices[] = {"/dev/video1", "/dev/video3"};
 static uint8_t g_encode_devices_idx = 0;
@@ -76,6 +85,8 @@ void initialize_output_block(OutputBlock *output_block)
     for(uint32_t i = 0; i < TIVX_IMG_MOSAIC_MAX_INPUTS; i++)
     {
         output_block->input_pads[i] = NULL;
+        output_block->bridge_pads[i] = NULL;
+        output_block->input_subflows[i] = NULL;
     }
 
     output_block->num_inputs = 0;
@@ -117,6 +128,7 @@ int32_t connect_pad_to_output_block(OutputBlock *output_block,
     }
 
     output_block->input_pads[output_block->num_inputs] = pad;
+    output_block->input_subflows[output_block->num_inputs] = subflow_info;
 
     mosaic_cfg->num_inputs++;
     output_block->num_inputs++;
@@ -144,6 +156,19 @@ int32_t create_output_block(GraphObj *graph, OutputBlock *output_block)
 
     output_info = output_block->output_info;
 
+    /* Done here rather than while parsing, flows loaded from the cache
+     * skip the parser.
+     */
+    if(IMG_DIR == output_info->sink && !output_info->image_pack)
+    {
+        if(0 != mkdir(output_info->output_path, 0755) && EEXIST != errno)
+        {
+            TIOVX_APPS_ERROR("Error creating directory %s.\n",
+                             output_info->output_path);
+            return -1;
+        }
+    }
+
     /* Mosaic. */
     {
         TIOVXMosaicNodeCfg mosaic_cfg;
@@ -188,23 +213,29 @@ int32_t create_output_block(GraphObj *graph, OutputBlock *output_block)
 
         mosaic_node->srcs[0].bufq_depth = 4;
 
-        /* Link Input pads to Mosaic */
-        if(output_info->overlay_perf)
+        /* Link Input pads to Mosaic. Pads created in another graph are
+         * left floating, they are fed through a bridge at runtime.
+         */
+        for (i = 0; i < output_block->num_inputs; i++)
         {
-            for (i = 0; i < mosaic_cfg.num_inputs - 1; i++)
+            if(output_block->input_pads[i]->node->graph == graph)
             {
                 tiovx_modules_link_pads(output_block->input_pads[i],
                                         &mosaic_node->sinks[i]);
             }
+            else
+            {
+                mosaic_node->sinks[i].bufq_depth = MOSAIC_BRIDGE_BUFQ_DEPTH;
+                output_block->bridge_pads[i] = &mosaic_node->sinks[i];
+            }
+        }
+
+        if(output_info->overlay_perf)
+        {
             output_block->perf_overlay_pad = &mosaic_node->sinks[mosaic_cfg.num_inputs - 1];
         }
         else
         {
-            for (i = 0; i < mosaic_cfg.num_inputs; i++)
-            {
-                tiovx_modules_link_pads(output_block->input_pads[i],
-                                        &mosaic_node->sinks[i]);
-            }
             output_block->perf_overlay_pad = NULL;
         }
 
@@ -127,6 +127,116 @@ NodeObj* tiovx_modules_get_node_by_name(GraphObj *graph, char *name);
  */
 void tiovx_modules_print_performance(GraphObj *graph);
 
+/*! \brief Function to query memory usage of the buffer pools in graph.
+ *
+ * \param [in] graph Graph object \ref _GraphObj.
+ * \param [out] stats Memory statistics \ref MemStats.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_get_mem_stats(GraphObj *graph, MemStats *stats);
+
+/*! \brief Function to print memory usage of each floating pad in graph.
+ *
+ * \param [in] graph Graph object \ref _GraphObj.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_print_mem_stats(GraphObj *graph);
+
+/*! \brief Function to query latency and queue statistics of a floating pad.
+ *
+ * Statistics are only recorded if collect_pad_stats was set on the graph
+ * before verify.
+ *
+ * \param [in] pad Floating pad \ref _Pad.
+ * \param [out] stats Pad statistics \ref PadStats.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_get_pad_stats(Pad *pad, PadStats *stats);
+
+/*! \brief Function to restart the statistics of a floating pad.
+ *
+ * \param [in] pad Floating pad \ref _Pad.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_reset_pad_stats(Pad *pad);
+
+/*! \brief Function to print statistics of each floating pad in graph.
+ *
+ * \param [in] graph Graph object \ref _GraphObj.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_print_pad_stats(GraphObj *graph);
+
+/*! \brief Function to recommend a buffer queue depth for each floating
+ *         pad of a graph from its statistics. A pad whose producer stalled
+ *         for buffers gets one more than it had or grew to, a pad that
+ *         never used all its buffers gets fewer.
+ *
+ * \param [in] graph Graph object with pad statistics \ref _GraphObj.
+ * \param [out] hints Array of recommendations \ref BufqDepthHint.
+ * \param [in] max_hints Number of entries in hints.
+ *
+ * \return Number of recommendations filled
+ *
+ * \ingroup tiovx_modules
+ */
+vx_int32 tiovx_modules_recommend_bufq_depths(GraphObj *graph,
+                                             BufqDepthHint *hints,
+                                             vx_int32 max_hints);
+
+/*! \brief Function to write the recommended buffer queue depths of a graph,
+ *         one line per floating pad prefixed with name.
+ *
+ * \param [in] graph Graph object with pad statistics \ref _GraphObj.
+ * \param [in] name Name identifying the graph in the file.
+ * \param [in] fp File to append to.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_save_bufq_depths(GraphObj *graph, const char *name,
+                                         FILE *fp);
+
+/*! \brief Function to apply buffer queue depths written by
+ *         tiovx_modules_save_bufq_depths. Must be called after all nodes
+ *         are added and before verify, the graph must be built the same way
+ *         as when the depths were saved. Pads set up to grow keep their
+ *         max_bufq_depth, a larger saved depth is limited to it.
+ *
+ * \param [in,out] graph Graph object \ref _GraphObj.
+ * \param [in] name Name identifying the graph in the file.
+ * \param [in] fp File to read.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_load_bufq_depths(GraphObj *graph, const char *name,
+                                         FILE *fp);
+
+/*! \brief Function to print time spent in each graph construction phase
+ *         and per node, from initialize_graph till the end of verify.
+ *
+ * \param [in] graph Verified graph object \ref _GraphObj.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_print_startup_profile(GraphObj *graph);
+
+/*! \brief Function to write the startup profile of a graph as one JSON
+ *         object with phase and per node times in microseconds.
+ *
+ * \param [in] graph Verified graph object \ref _GraphObj.
+ * \param [in] name Name identifying the graph in the output.
+ * \param [in] fp File to append to.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_write_startup_profile(GraphObj *graph,
+                                              const char *name, FILE *fp);
+
 /*! \brief Acquire a free buffer from a buffer pool.
  *
  * \param [in] buf_pool Buffer pool \ref _BufPool.
@@ -137,6 +247,29 @@ void tiovx_modules_print_performance(GraphObj *graph);
  */
 Buf* tiovx_modules_acquire_buf(BufPool *buf_pool);
 
+/*! \brief Acquire a free buffer from a buffer pool without blocking.
+ *
+ * \param [in] buf_pool Buffer pool \ref _BufPool.
+ *
+ * \return Free Buffer \ref _Buf, NULL if none is free
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_try_acquire_buf(BufPool *buf_pool);
+
+/*! \brief Acquire a free buffer from a buffer pool, waiting at most
+ *         timeout_ms. TIOVX_MODULES_WAIT_FOREVER blocks like
+ *         tiovx_modules_acquire_buf.
+ *
+ * \param [in] buf_pool Buffer pool \ref _BufPool.
+ * \param [in] timeout_ms Timeout in milliseconds.
+ *
+ * \return Free Buffer \ref _Buf, NULL on timeout
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_acquire_buf_timeout(BufPool *buf_pool, vx_uint32 timeout_ms);
+
 /*! \brief Release a previously acquired buffer back to its pool.
  *
  * \param [in] buf Buffer to be released \ref _Buf.
@@ -145,6 +278,35 @@ Buf* tiovx_modules_acquire_buf(BufPool *buf_pool);
  */
 vx_status tiovx_modules_release_buf(Buf *buf);
 
+/*! \brief Wrap external DMA-buf fds as a buffer of an import pool.
+ *
+ * The pool must come from a pad with import_mem set. One fd and offset is
+ * consumed per memory plane of each channel, in order. The memory must be
+ * physically contiguous (CMA, V4L2 VIDIOC_EXPBUF, DRM dumb buffers). The
+ * returned buffer is acquired and can be enqueued like any other.
+ *
+ * \param [in] buf_pool Import buffer pool \ref _BufPool.
+ * \param [in] fds DMA-buf fds, one per plane.
+ * \param [in] offsets Byte offset of each plane inside its fd.
+ * \param [in] num_fds Number of entries in fds and offsets.
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_import_buf(BufPool *buf_pool, vx_int32 *fds,
+                              vx_uint32 *offsets, vx_uint32 num_fds);
+
+/*! \brief Detach the fds of an imported buffer and return it to its pool.
+ *
+ * The buffer must be held by the caller, from the import or a dequeue,
+ * otherwise VX_FAILURE is returned. The fds remain owned by the caller and
+ * are not closed.
+ *
+ * \param [in] buf Imported buffer \ref _Buf.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_unimport_buf(Buf *buf);
+
 /*! \brief Function to clean the graph at the end of the application.
  *
  * \param [in] buf Buffer to be released \ref _Buf.
@@ -154,6 +316,11 @@ vx_status tiovx_modules_release_buf(Buf *buf);
 vx_status tiovx_modules_clean_graph(GraphObj *graph);
 
 /*! \brief Function to enqueue a buffer to OpenVX graph.
+ *
+ * With a drop policy set on the pad, the buffer may be held back till the
+ * graph has room or released to the pool instead, see \ref DROP_POLICY.
+ * A buffer the graph queue has no room for is released to the pool and
+ * VX_FAILURE is returned.
  *
  * \param [in] buf Buffer to be enqueued \ref _Buf.
  *
@@ -161,6 +328,19 @@ vx_status tiovx_modules_clean_graph(GraphObj *graph);
  */
 vx_status tiovx_modules_enqueue_buf(Buf *buf);
 
+/*! \brief Function to enqueue several buffers of a pool to OpenVX graph
+ *         with one framework call.
+ *
+ * Buffers the graph queue has no room for are released to the pool and
+ * VX_FAILURE is returned.
+ *
+ * \param [in] bufs Buffers to be enqueued, all from the same pool \ref _Buf.
+ * \param [in] num_bufs Number of buffers in bufs.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_enqueue_bufs(Buf **bufs, vx_uint32 num_bufs);
+
 /*! \brief dequeue a buffer from OpenVX graph.
  *
  * \param [in] buf_pool Buffer pool \ref _BufPool.
@@ -171,6 +351,78 @@ vx_status tiovx_modules_enqueue_buf(Buf *buf);
  */
 Buf* tiovx_modules_dequeue_buf(BufPool *buf_pool);
 
+/*! \brief dequeue a buffer from OpenVX graph if one is done, without
+ *         blocking.
+ *
+ * \param [in] buf_pool Buffer pool \ref _BufPool.
+ *
+ * \return Dequeued Buffer \ref _Buf, NULL if none is done
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_try_dequeue_buf(BufPool *buf_pool);
+
+/*! \brief dequeue a buffer from OpenVX graph, waiting at most timeout_ms.
+ *
+ * \param [in] buf_pool Buffer pool \ref _BufPool.
+ * \param [in] timeout_ms Timeout in milliseconds.
+ *
+ * \return Dequeued Buffer \ref _Buf, NULL on timeout
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_dequeue_buf_timeout(BufPool *buf_pool, vx_uint32 timeout_ms);
+
+/*! \brief dequeue a buffer from whichever of the given pools completes
+ *         first, waiting at most timeout_ms. Pools are checked in order,
+ *         the pool of the returned buffer is buf->pool.
+ *
+ * If every pool belongs to a graph with use_param_events set and a runtime
+ * is reading events, the wait sleeps on graph parameter consumed events.
+ * Otherwise the done queues are polled.
+ *
+ * \param [in] buf_pools Buffer pools \ref _BufPool.
+ * \param [in] num_pools Number of pools in buf_pools.
+ * \param [in] timeout_ms Timeout in milliseconds.
+ *
+ * \return Dequeued Buffer \ref _Buf, NULL on timeout
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_dequeue_any_buf(BufPool **buf_pools, vx_uint32 num_pools,
+                                   vx_uint32 timeout_ms);
+
+/*! \brief dequeue up to max_bufs buffers from OpenVX graph. Blocks till
+ *         at least one buffer is available.
+ *
+ * \param [in] buf_pool Buffer pool \ref _BufPool.
+ * \param [out] bufs Dequeued buffers \ref _Buf.
+ * \param [in] max_bufs Size of bufs.
+ *
+ * \return Number of buffers dequeued
+ *
+ * \ingroup tiovx_modules
+ */
+vx_uint32 tiovx_modules_dequeue_bufs(BufPool *buf_pool, Buf **bufs,
+                                     vx_uint32 max_bufs);
+
+/*! \brief Register or unregister a reader of the context event queue.
+ *         While one is registered, timed dequeues on graphs with
+ *         use_param_events wait for tiovx_modules_signal_param_event
+ *         instead of polling.
+ *
+ * \param [in] active vx_true_e to register, vx_false_e to unregister.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_set_param_event_source(vx_bool active);
+
+/*! \brief Wake timed dequeues after a graph parameter consumed event.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_signal_param_event(void);
+
 /*! \brief Function to schedule graph, if mode set to manual.
  *
  * \param [in] buf Buffer to be enqueued \ref _Buf.
@@ -206,6 +458,18 @@ vx_status tiovx_modules_release_node(NodeObj *node);
  */
 vx_status tiovx_modules_buf_swap_mem(Buf *buf1, Buf *buf2);
 
+/*! \brief Function to check that 2 exemplars have the same type and
+ *         layout, so buffers made from them can swap memory.
+ *
+ * \param [in] exemplar1 Exemplar 1.
+ * \param [in] exemplar2 Exemplar 2.
+ *
+ * \return vx_true_e if they match
+ *
+ * \ingroup tiovx_modules
+ */
+vx_bool tiovx_modules_compare_exemplars(vx_reference exemplar1, vx_reference exemplar2);
+
 #ifdef __cplusplus
 }
 #endif
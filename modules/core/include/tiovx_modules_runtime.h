@@ -0,0 +1,391 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _TIOVX_MODULES_RUNTIME
+#define _TIOVX_MODULES_RUNTIME
+
+#include "tiovx_modules.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \brief Callback invoked by the runtime with a buffer dequeued from a pad.
+ *        Returns the buffer to enqueue back to the same pad, this can be a
+ *        different buffer of the same pool. Returning NULL stops the pad.
+ */
+typedef Buf* (*RuntimeCallback)(Buf *buf, void *priv);
+
+typedef struct _Runtime Runtime;
+
+/*!
+ * \brief Structure describing a rate control. A frame is accepted once
+ *        every decimation frames and no sooner than the period of fps,
+ *        all other frames are skipped.
+ */
+typedef struct {
+    /*! \brief Accept one of every decimation frames, 0 or 1 accepts all */
+    vx_uint32           decimation;
+
+    /*! \brief Target frame rate, 0 for no limit */
+    vx_float32          fps;
+
+    /*! \brief Period between accepted frames derived from fps */
+    vx_uint64           period_us;
+
+    /*! \brief Earliest time of next accepted frame */
+    vx_uint64           next_us;
+
+    /*! \brief Number of frames seen */
+    vx_uint64           num_frames;
+
+    /*! \brief Number of frames skipped */
+    vx_uint64           num_skipped;
+} RateControl;
+
+/*!
+ * \brief Structure describing a pad driven by the runtime.
+ */
+typedef struct {
+    /*! \brief Runtime the pad is registered with \ref _Runtime */
+    Runtime             *runtime;
+
+    /*! \brief Floating pad serviced by this worker \ref _Pad */
+    Pad                 *pad;
+
+    /*! \brief Callback called for every dequeued buffer */
+    RuntimeCallback     cb;
+
+    /*! \brief Private data passed to the callback */
+    void                *priv;
+
+    /*! \brief Worker thread of this pad */
+    pthread_t           thread;
+
+    /*! \brief Posted by the reactor when the graph is done with a buffer */
+    sem_t               sem;
+
+    /*! \brief Number of buffers serviced */
+    vx_uint64           num_bufs;
+
+    /*! \brief Set if rate is applied to the pad */
+    vx_bool             use_rate;
+
+    /*! \brief Rate control of the pad \ref RateControl */
+    RateControl         rate;
+} RuntimePad;
+
+/*!
+ * \brief Structure describing an event driven graph runtime. A reactor
+ *        thread waits on graph parameter events and wakes one worker
+ *        thread per registered pad, so each source and sink runs at its
+ *        own pace.
+ */
+struct _Runtime {
+    /*! \brief Graph driven by the runtime \ref _GraphObj */
+    GraphObj            *graph;
+
+    /*! \brief Registered pads \ref RuntimePad */
+    RuntimePad          *pads;
+
+    /*! \brief Number of registered pads */
+    vx_int32            num_pads;
+
+    /*! \brief Registered pad for each graph parameter index */
+    RuntimePad          **param_map;
+
+    /*! \brief Thread waiting on OpenVX events */
+    pthread_t           reactor;
+
+    /*! \brief Set while workers are running */
+    vx_bool             running;
+
+    /*! \brief Set once any pad callback returned NULL */
+    vx_bool             finished;
+
+    /*! \brief Mutex for running and finished */
+    pthread_mutex_t     lock;
+
+    /*! \brief Signalled when finished is set */
+    pthread_cond_t      cond;
+
+    /*! \brief Next started runtime, events of all graphs share the
+     *         context queue and are dispatched through this list
+     */
+    Runtime             *next;
+};
+
+/*!
+ * \brief Structure describing a zero copy handoff from a floating src pad
+ *        of one graph to a floating sink pad of another graph. The latest
+ *        produced buffer is kept in a slot, so the producer never waits
+ *        on the consumer and each graph runs at its own rate.
+ */
+typedef struct {
+    /*! \brief Floating src pad of the producer graph \ref _Pad */
+    Pad                 *src_pad;
+
+    /*! \brief Floating sink pad of the consumer graph \ref _Pad */
+    Pad                 *sink_pad;
+
+    /*! \brief Buffer of sink pad pool holding the latest frame */
+    Buf                 *slot;
+
+    /*! \brief Set if slot holds a frame not yet handed to the consumer */
+    vx_bool             fresh;
+
+    /*! \brief Time the consumer waits for a new frame before repeating */
+    vx_uint32           timeout_ms;
+
+    /*! \brief Number of frames handed over by the producer */
+    vx_uint64           num_pushed;
+
+    /*! \brief Number of frames overwritten before the consumer took them */
+    vx_uint64           num_dropped;
+
+    /*! \brief Number of times the consumer repeated a frame */
+    vx_uint64           num_repeated;
+
+    /*! \brief Rate at which produced frames are handed over */
+    RateControl         rate;
+
+    /*! \brief Mutex for slot */
+    pthread_mutex_t     lock;
+
+    /*! \brief Signalled when a fresh frame is pushed */
+    pthread_cond_t      cond;
+} Bridge;
+
+/*! \brief Function to initialize a rate control.
+ *
+ * \param [out] rate Rate control \ref RateControl.
+ * \param [in] decimation Accept one of every decimation frames, 0 or 1
+ *                        accepts all.
+ * \param [in] fps Target frame rate, 0 for no limit.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_rate_control_init(RateControl *rate, vx_uint32 decimation,
+                                     vx_float32 fps);
+
+/*! \brief Function to decide if the current frame is accepted.
+ *
+ * \param [in,out] rate Rate control \ref RateControl.
+ *
+ * \return vx_true_e if the frame is accepted
+ *
+ * \ingroup tiovx_modules
+ */
+vx_bool tiovx_modules_rate_control_accept(RateControl *rate);
+
+/*! \brief Function to initialize a runtime for a graph. The graph must have
+ *         use_param_events set before tiovx_modules_verify_graph.
+ *
+ * \param [out] runtime Runtime \ref _Runtime.
+ * \param [in] graph Verified graph object \ref _GraphObj.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_runtime_init(Runtime *runtime, GraphObj *graph);
+
+/*! \brief Function to register a callback for a floating input pad. The
+ *         callback gets buffers the graph has consumed and returns the
+ *         buffer to feed next.
+ *
+ * \param [in,out] runtime Runtime \ref _Runtime.
+ * \param [in] pad Floating sink pad of a node \ref _Pad.
+ * \param [in] cb Callback \ref RuntimeCallback.
+ * \param [in] priv Private data passed to cb.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_runtime_add_source(Runtime *runtime, Pad *pad,
+                                           RuntimeCallback cb, void *priv);
+
+/*! \brief Function to register a callback for a floating output pad. The
+ *         callback gets buffers the graph has produced and returns the
+ *         buffer to hand back to the graph.
+ *
+ * \param [in,out] runtime Runtime \ref _Runtime.
+ * \param [in] pad Floating src pad of a node \ref _Pad.
+ * \param [in] cb Callback \ref RuntimeCallback.
+ * \param [in] priv Private data passed to cb.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_runtime_add_sink(Runtime *runtime, Pad *pad,
+                                         RuntimeCallback cb, void *priv);
+
+/*! \brief Function to limit the rate of a registered pad. Frames of a
+ *         sink pad that are skipped go back to the graph without calling
+ *         the callback. For a source pad the callback is called again with
+ *         the skipped buffer, so it must block till the next frame as
+ *         capture and decode sources do.
+ *
+ * \param [in,out] runtime Runtime \ref _Runtime.
+ * \param [in] pad Registered pad \ref _Pad.
+ * \param [in] decimation Accept one of every decimation frames, 0 or 1
+ *                        accepts all.
+ * \param [in] fps Target frame rate, 0 for no limit.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_runtime_set_rate(Runtime *runtime, Pad *pad,
+                                         vx_uint32 decimation, vx_float32 fps);
+
+/*! \brief Function to start the reactor and all pad workers. Buffers must
+ *         already be primed to the graph. If a thread cannot be created
+ *         the ones already started are joined and VX_FAILURE is returned.
+ *
+ * \param [in,out] runtime Runtime \ref _Runtime.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_runtime_start(Runtime *runtime);
+
+/*! \brief Function to wait till any pad stops or timeout_ms expires.
+ *
+ * \param [in] runtime Runtime \ref _Runtime.
+ * \param [in] timeout_ms Timeout in milliseconds.
+ *
+ * \return vx_true_e if a pad has stopped
+ *
+ * \ingroup tiovx_modules
+ */
+vx_bool tiovx_modules_runtime_wait(Runtime *runtime, vx_uint32 timeout_ms);
+
+/*! \brief Function to stop all workers, wait for the graph to go idle
+ *         and release the buffers still queued to it on registered pads.
+ *
+ * \param [in,out] runtime Runtime \ref _Runtime.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_runtime_stop(Runtime *runtime);
+
+/*! \brief Function to free a stopped runtime.
+ *
+ * \param [in,out] runtime Runtime \ref _Runtime.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_runtime_deinit(Runtime *runtime);
+
+/*! \brief Function to initialize a bridge between two graphs. Both graphs
+ *         must be verified and the pads must have the same exemplar. Memory
+ *         moves between the two pools, so neither graph can use a memory
+ *         arena and neither pad can import memory.
+ *
+ * \param [out] bridge Bridge \ref Bridge.
+ * \param [in] src_pad Floating src pad of producer graph \ref _Pad.
+ * \param [in] sink_pad Floating sink pad of consumer graph \ref _Pad.
+ * \param [in] timeout_ms Time consumer waits for a new frame before it
+ *                        repeats the buffer it had.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_bridge_init(Bridge *bridge, Pad *src_pad,
+                                    Pad *sink_pad, vx_uint32 timeout_ms);
+
+/*! \brief Function to limit the rate at which a bridge hands over frames.
+ *         Skipped frames go back to the producer and the consumer repeats
+ *         the frame it had.
+ *
+ * \param [in,out] bridge Bridge \ref Bridge.
+ * \param [in] decimation Accept one of every decimation frames, 0 or 1
+ *                        accepts all.
+ * \param [in] fps Target frame rate, 0 for no limit.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_bridge_set_rate(Bridge *bridge, vx_uint32 decimation,
+                                   vx_float32 fps);
+
+/*! \brief Runtime sink callback for the src pad of a bridge. Swaps the
+ *         produced frame into the slot and returns the buffer to the
+ *         producer graph. priv is the \ref Bridge.
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_bridge_push(Buf *buf, void *priv);
+
+/*! \brief Runtime source callback for the sink pad of a bridge. Swaps the
+ *         latest frame from the slot into the consumed buffer and returns
+ *         it to the consumer graph. priv is the \ref Bridge.
+ *
+ * \ingroup tiovx_modules
+ */
+Buf* tiovx_modules_bridge_pull(Buf *buf, void *priv);
+
+/*! \brief Function to free a bridge. Both runtimes must be stopped.
+ *
+ * \param [in,out] bridge Bridge \ref Bridge.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_bridge_deinit(Bridge *bridge);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_TIOVX_MODULES_RUNTIME
@@ -0,0 +1,186 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _TIOVX_MODULES_TRACE
+#define _TIOVX_MODULES_TRACE
+
+#include "tiovx_modules_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIOVX_MODULES_TRACE_NAME_LEN        (48u)
+#define TIOVX_MODULES_TRACE_DEFAULT_EVENTS  (65536u)
+
+/*!
+ * \brief Structure describing one trace event, stored in the ring of the
+ *        thread that recorded it and written out in Chrome trace format.
+ */
+typedef struct {
+    /*! \brief Event name */
+    char                name[TIOVX_MODULES_TRACE_NAME_LEN];
+
+    /*! \brief Event category, must be a string literal */
+    const char          *cat;
+
+    /*! \brief Chrome trace phase, X complete, i instant, b/e async span */
+    char                phase;
+
+    /*! \brief Thread id the event is shown on */
+    vx_int32            tid;
+
+    /*! \brief Start time in us */
+    vx_uint64           ts_us;
+
+    /*! \brief Duration in us, used by complete events */
+    vx_uint64           dur_us;
+
+    /*! \brief Id matching begin and end of async spans */
+    vx_uint64           id;
+} TraceEvent;
+
+/*! \brief Function to start tracing. Every thread records into its own ring
+ *         of num_events events, the oldest events are overwritten. The
+ *         trace is written to path on tiovx_modules_trace_stop, at exit and
+ *         whenever the process gets SIGUSR2.
+ *
+ * \param [in] path Output file in Chrome trace JSON format.
+ * \param [in] num_events Events kept per thread, 0 for default.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_trace_start(const char *path, vx_uint32 num_events);
+
+/*! \brief Function to stop tracing and write the trace. Waits for threads
+ *         inside a record call, then frees the rings of all threads.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_trace_stop(void);
+
+/*! \brief Function to write the events recorded so far.
+ *
+ * \param [in] path Output file in Chrome trace JSON format.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_status tiovx_modules_trace_dump(const char *path);
+
+/*! \brief Returns vx_true_e while tracing is started.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_bool tiovx_modules_trace_enabled(void);
+
+/*! \brief Returns the current time in us, in the clock used by traces.
+ *
+ * \ingroup tiovx_modules
+ */
+vx_uint64 tiovx_modules_trace_time(void);
+
+/*! \brief Function to record an event on the calling thread. Does nothing
+ *         if tracing is not started.
+ *
+ * \param [in] cat Category, must be a string literal.
+ * \param [in] name Event name, truncated to TIOVX_MODULES_TRACE_NAME_LEN.
+ * \param [in] phase Chrome trace phase.
+ * \param [in] ts_us Start time in us from tiovx_modules_trace_time.
+ * \param [in] dur_us Duration in us for complete events.
+ * \param [in] id Id of async spans.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_trace_event(const char *cat, const char *name, char phase,
+                               vx_uint64 ts_us, vx_uint64 dur_us,
+                               vx_uint64 id);
+
+/*! \brief Function to record a complete event on a named track instead of
+ *         the calling thread, used for nodes running on remote cores.
+ *
+ * \param [in,out] track Track id, 0 allocates a new track named name.
+ * \param [in] cat Category, must be a string literal.
+ * \param [in] name Event and track name.
+ * \param [in] ts_us Start time in us from tiovx_modules_trace_time.
+ * \param [in] dur_us Duration in us.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_trace_track_event(vx_int32 *track, const char *cat,
+                                     const char *name, vx_uint64 ts_us,
+                                     vx_uint64 dur_us);
+
+/*! \brief Function to write a string as a quoted JSON string, escaping
+ *         quotes, backslashes and control characters.
+ *
+ * \param [in] fp Output file.
+ * \param [in] str String to write.
+ *
+ * \ingroup tiovx_modules
+ */
+void tiovx_modules_trace_write_string(FILE *fp, const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_TIOVX_MODULES_TRACE
@@ -87,12 +87,9 @@ extern "C" {
 
 #define CLR(o) memset(o, 0, sizeof(*o))
 
-#define TIOVX_MODULES_MAX_BUFQ_DEPTH      (16u)
 #define TIOVX_MODULES_MAX_NODE_INPUTS     (16u)
 #define TIOVX_MODULES_MAX_NODE_OUTPUTS    (8u)
-#define TIOVX_MODULES_MAX_NODES           (128u)
 #define TIOVX_MODULES_MAX_NUM_CHANNELS    (16u)
-#define TIOVX_MODULES_MAX_GRAPH_PARAMS    (16u)
 
 #define TIOVX_MODULES_MAX_TENSOR_DIMS     (4u)
 #define TIOVX_MODULES_MAX_TENSORS         (8u)
@@ -105,6 +102,10 @@ extern "C" {
 #define TIOVX_MODULES_DEFAULT_BUFQ_DEPTH      (2u)
 #define TIOVX_MODULES_DEFAULT_NUM_CHANNELS    (1u)
 #define TIOVX_MODULES_MAX_REF_HANDLES     (16u)
+#define TIOVX_MODULES_MEM_ARENA_ALIGN     (4096u)
+#define TIOVX_MODULES_WAIT_FOREVER        (0xFFFFFFFFu)
+#define TIOVX_MODULES_STATS_NUM_BUCKETS   (32u)
+#define TIOVX_MODULES_TUNE_STALL_RATIO    (0.01f)
 
 #if defined(TARGET_OS_QNX)
 #define TIOVX_MODULES_DATA_PATH "/ti_fs/edgeai/edgeai-test-data/"
@@ -122,6 +123,52 @@ typedef enum {
     SINK,
 } PAD_DIRECTION;
 
+/*!
+ * \brief Enum for what enqueue does with buffers once max_queued buffers
+ *        of a pad are in the graph.
+ */
+typedef enum {
+    /*! \brief Enqueue to the graph till the queue is full */
+    TIOVX_MODULES_DROP_NONE = 0,
+
+    /*! \brief Release the buffers being enqueued */
+    TIOVX_MODULES_DROP_NEWEST,
+
+    /*! \brief Hold up to max_pending buffers, releasing the oldest */
+    TIOVX_MODULES_DROP_OLDEST,
+
+    /*! \brief Hold only the most recent buffer, releasing the older */
+    TIOVX_MODULES_KEEP_LATEST,
+} DROP_POLICY;
+
+/*!
+ * \brief Phases of graph construction timed by the startup profile.
+ */
+typedef enum {
+    /*! \brief Context creation and kernel loads */
+    TIOVX_MODULES_PHASE_CONTEXT = 0,
+    /*! \brief init_node of all nodes, called from add_node */
+    TIOVX_MODULES_PHASE_INIT_NODES,
+    /*! \brief load_node of all nodes. Loads run concurrently with buffer
+     *         pool allocation, the graph time is split between the two by
+     *         their share of the per node times.
+     */
+    TIOVX_MODULES_PHASE_LOAD_NODES,
+    /*! \brief create_node of all nodes */
+    TIOVX_MODULES_PHASE_CREATE_NODES,
+    /*! \brief Buffer pool allocation and graph parameters of floating pads */
+    TIOVX_MODULES_PHASE_BUFPOOLS,
+    /*! \brief Memory arena creation and fill */
+    TIOVX_MODULES_PHASE_MEM_ARENA,
+    /*! \brief Schedule config and event registration */
+    TIOVX_MODULES_PHASE_SCHEDULE,
+    /*! \brief vxVerifyGraph */
+    TIOVX_MODULES_PHASE_VERIFY,
+    /*! \brief post_verify_graph of all nodes */
+    TIOVX_MODULES_PHASE_POST_VERIFY,
+    TIOVX_MODULES_NUM_PHASES,
+} STARTUP_PHASE;
+
 typedef struct _Pad         Pad;
 typedef struct _NodeObj     NodeObj;
 typedef struct _GraphObj    GraphObj;
@@ -146,8 +193,115 @@ struct _Buf {
 
     /*! \brief Number of channels */
     vx_int32            num_channels;
+
+    /*! \brief Set if memory is mapped from external DMA-buf fds */
+    vx_bool             imported;
+
+    /*! \brief Set while the app holds the buffer from acquire, dequeue or
+     *         import, till it is released or enqueued
+     */
+    vx_bool             held;
+
+    /*! \brief Time of the last enqueue in us, used for pad statistics */
+    vx_uint64           enqueue_ts;
+
+    /*! \brief Time the app got the buffer by acquire or dequeue in us, 0 if
+     *         the app does not hold it. Used for pad statistics.
+     */
+    vx_uint64           hold_ts;
 };
 
+/*!
+ * \brief Latency histogram with power of two buckets in microseconds.
+ *        Bucket i counts samples in [2^(i-1), 2^i) us, bucket 0 counts 0 us.
+ */
+typedef struct {
+    /*! \brief Samples per bucket */
+    vx_uint64           buckets[TIOVX_MODULES_STATS_NUM_BUCKETS];
+
+    /*! \brief Number of samples */
+    vx_uint64           count;
+
+    /*! \brief Sum of all samples in us */
+    vx_uint64           sum_us;
+
+    /*! \brief Largest sample in us */
+    vx_uint64           max_us;
+} LatencyHist;
+
+/*!
+ * \brief Counters kept by a buffer pool when pad statistics are enabled.
+ *        Updated with atomics so lock free pools stay lock free.
+ */
+typedef struct {
+    /*! \brief Time from enqueue to dequeue \ref LatencyHist */
+    LatencyHist         graph_latency;
+
+    /*! \brief Time the app holds a buffer, from acquire or dequeue to
+     *         enqueue or release \ref LatencyHist
+     */
+    LatencyHist         hold_latency;
+
+    /*! \brief Buffers currently enqueued to the graph */
+    vx_int32            queue_depth;
+
+    /*! \brief Largest queue_depth seen */
+    vx_int32            max_queue_depth;
+
+    /*! \brief Sum of queue_depth after each enqueue */
+    vx_uint64           queue_depth_sum;
+
+    /*! \brief Number of enqueue calls */
+    vx_uint64           num_enqueues;
+
+    /*! \brief Enqueues that found the queue empty, the graph was starved */
+    vx_uint64           num_underruns;
+
+    /*! \brief Acquires that found no free buffer */
+    vx_uint64           num_acquire_waits;
+
+    /*! \brief Acquires that returned no buffer */
+    vx_uint64           num_acquire_fails;
+
+    /*! \brief Non blocking or timed dequeues that returned no buffer */
+    vx_uint64           num_dequeue_empty;
+
+    /*! \brief Largest number of buffers backed by memory */
+    vx_int32            max_allocated;
+
+    /*! \brief Time the statistics were last reset in us */
+    vx_uint64           start_ts;
+} BufPoolStats;
+
+/*!
+ * \brief Slot of a lock free buffer ring.
+ */
+typedef struct {
+    /*! \brief Sequence number used to hand over the slot between threads */
+    vx_uint32           seq;
+
+    /*! \brief Buffer stored in the slot \ref _Buf */
+    Buf                 *buf;
+} BufRingCell;
+
+/*!
+ * \brief Bounded multi producer multi consumer ring of buffers, used by
+ *        buffer pools created with lock_free set.
+ */
+typedef struct {
+    /*! \brief Ring slots \ref BufRingCell */
+    BufRingCell         *cells;
+
+    /*! \brief Number of slots, always a power of two */
+    vx_uint32           size;
+
+    /*! \brief Position of the next push */
+    vx_uint32           head;
+
+    /*! \brief Position of the next pop */
+    vx_uint32           tail;
+} BufRing;
+
 /*!
  * \brief Structure describing a Buffer pool.
  */
@@ -156,19 +310,34 @@ struct _BufPool {
     Pad                 *pad;
 
     /*! \brief List of buffers in the pool \ref _Buf */
-    Buf                 bufs[TIOVX_MODULES_MAX_BUFQ_DEPTH];
+    Buf                 *bufs;
 
-    /*! \brief Number of buffers in the pool */
+    /*! \brief Number of buffers allocated when the pool is created */
     vx_int32            bufq_depth;
 
+    /*! \brief Number of buffers the pool can grow to */
+    vx_int32            max_bufq_depth;
+
+    /*! \brief Number of buffers currently backed by memory */
+    vx_int32            num_allocated;
+
     /*! \brief Array that contains all free buffers \ref _Buf */
-    Buf                 *freeQ[TIOVX_MODULES_MAX_BUFQ_DEPTH];
+    Buf                 **freeQ;
 
     /*! \brief Number of buffers that are free */
     vx_int32            free_count;
 
+    /*! \brief Buffers without memory, available for growing the pool */
+    Buf                 **spareQ;
+
+    /*! \brief Number of buffers in spareQ */
+    vx_int32            spare_count;
+
+    /*! \brief Consecutive acquires that did not need the grown buffers */
+    vx_int32            idle_count;
+
     /*! \brief List of buffers that are enqueued \ref _Buf */
-    Buf                 *enqueuedQ[TIOVX_MODULES_MAX_BUFQ_DEPTH];
+    Buf                 **enqueuedQ;
 
     /*! \brief Head pointer for queue management */
     vx_int32            enqueue_head;
@@ -176,14 +345,62 @@ struct _BufPool {
     /*! \brief Tail pointer for queue management */
     vx_int32            enqueue_tail;
 
-    /*! \brief Ref list for graph param */
-    vx_reference        ref_list[TIOVX_MODULES_MAX_BUFQ_DEPTH];
+    /*! \brief Ref list for graph param, holds max_bufq_depth references */
+    vx_reference        *ref_list;
+
+    /*! \brief Bytes of memory currently backing the buffers of this pool */
+    vx_uint64           mem_size;
 
     /*! \brief Mutex for queue management */
     pthread_mutex_t     lock;
 
     /*! \brief Semaphore for acquire and release */
     sem_t               sem;
+
+    /*! \brief Use lock free rings instead of mutex protected queues */
+    vx_bool             lock_free;
+
+    /*! \brief Buffers get memory only by importing DMA-buf fds */
+    vx_bool             import_mem;
+
+    /*! \brief Ring of free buffers, used if lock_free is set */
+    BufRing             free_ring;
+
+    /*! \brief Ring of enqueued buffers, used if lock_free is set */
+    BufRing             enqueued_ring;
+
+    /*! \brief Number of threads sleeping on sem, used if lock_free is set */
+    vx_int32            num_waiters;
+
+    /*! \brief Drop policy, copied from the pad \ref DROP_POLICY */
+    DROP_POLICY         drop_policy;
+
+    /*! \brief Buffers the graph may hold before the drop policy applies */
+    vx_int32            max_queued;
+
+    /*! \brief Buffers held back for the graph with TIOVX_MODULES_DROP_OLDEST */
+    vx_int32            max_pending;
+
+    /*! \brief Buffers enqueued to the graph, used with a drop policy */
+    vx_int32            num_queued;
+
+    /*! \brief Buffers held back till the graph has room, oldest first */
+    Buf                 **pendingQ;
+
+    /*! \brief Index of the oldest buffer in pendingQ */
+    vx_int32            pending_head;
+
+    /*! \brief Number of buffers in pendingQ */
+    vx_int32            pending_count;
+
+    /*! \brief Number of buffers released by the drop policy */
+    vx_uint64           num_dropped;
+
+    /*! \brief Record pad statistics, copied from the graph */
+    vx_bool             collect_stats;
+
+    /*! \brief Pad statistics \ref BufPoolStats */
+    BufPoolStats        stats;
 };
 
 /*!
@@ -215,6 +432,12 @@ struct _Pad {
     /*! \brief Buffer queue depth */
     vx_int32            bufq_depth;
 
+    /*! \brief Maximum buffer queue depth. If greater than bufq_depth the
+     *         pool allocates memory for extra buffers on demand when acquire
+     *         would block and frees it again once the pad is idle.
+     */
+    vx_int32            max_bufq_depth;
+
     /*! \brief Buffer pool allocated for this pad */
     BufPool             *buf_pool;
 
@@ -224,6 +447,30 @@ struct _Pad {
 
     /*! \brief vx_bool Enqueue objext array instead of handle if set to true */
     vx_bool             enqueue_arr;
+
+    /*! \brief vx_bool Allocate a lock free buffer pool if set to true */
+    vx_bool             lock_free;
+
+    /*! \brief vx_bool Allocate no memory for the buffer pool if set to true.
+     *         Buffers are backed by external DMA-buf fds attached with
+     *         tiovx_modules_import_buf, up to max_bufq_depth of them.
+     */
+    vx_bool             import_mem;
+
+    /*! \brief What enqueue does once max_queued buffers are in the graph
+     *         \ref DROP_POLICY. Dropped buffers go back to the pool.
+     */
+    DROP_POLICY         drop_policy;
+
+    /*! \brief Buffers the graph may hold with a drop policy, 0 for
+     *         max_bufq_depth
+     */
+    vx_int32            max_queued;
+
+    /*! \brief Buffers held back with TIOVX_MODULES_DROP_OLDEST, 0 for
+     *         max_bufq_depth - max_queued
+     */
+    vx_int32            max_pending;
 };
 
 /*!
@@ -231,6 +478,10 @@ struct _Pad {
  */
 typedef struct {
     vx_status (*init_node)(NodeObj *node);
+    /* Optional, loads files into node data. Called from verify concurrently
+     * with other nodes, must not touch the graph or other nodes.
+     */
+    vx_status (*load_node)(NodeObj *node);
     vx_status (*create_node)(NodeObj *node);
     vx_status (*post_verify_graph)(NodeObj *node);
     vx_status (*delete_node)(NodeObj *node);
@@ -266,19 +517,177 @@ struct _NodeObj {
     /*! \brief Number of outputs to the Node */
     vx_int32            num_outputs;
 
-    /*! \brief List of input pads \ref _Pad */
-    Pad                 sinks[TIOVX_MODULES_MAX_NODE_INPUTS];
+    /*! \brief List of num_inputs input pads \ref _Pad */
+    Pad                 *sinks;
 
-    /*! \brief List of output pads \ref _Pad */
-    Pad                 srcs[TIOVX_MODULES_MAX_NODE_OUTPUTS];
+    /*! \brief List of num_outputs output pads \ref _Pad */
+    Pad                 *srcs;
 
     /*! \brief Module call backs \ref NodeCbs */
     NodeCbs             *cbs;
 
     /*! \brief Pointer to private data managed by modules */
     void                *node_priv;
+
+    /*! \brief Trace track of the node, 0 until the first traced run */
+    vx_int32            trace_track;
+
+    /*! \brief Number of runs of the node already traced */
+    vx_uint64           trace_num;
+
+    /*! \brief Time spent on the node in each startup phase in us,
+     *         \ref STARTUP_PHASE
+     */
+    vx_uint64           startup_us[TIOVX_MODULES_NUM_PHASES];
 };
 
+/*!
+ * \brief Free region of a memory arena.
+ */
+typedef struct {
+    /*! \brief Offset from the arena base */
+    vx_uint64           offset;
+
+    /*! \brief Size of the region in bytes */
+    vx_uint64           size;
+} MemArenaExtent;
+
+/*!
+ * \brief Single memory allocation shared by all buffer pools of a graph.
+ */
+typedef struct {
+    /*! \brief Base address of the arena, NULL if not created */
+    vx_uint8            *base;
+
+    /*! \brief Size of the arena in bytes */
+    vx_uint64           size;
+
+    /*! \brief Bytes currently handed out */
+    vx_uint64           used_bytes;
+
+    /*! \brief Maximum of used_bytes since creation */
+    vx_uint64           peak_bytes;
+
+    /*! \brief Number of slices currently handed out */
+    vx_int32            num_allocs;
+
+    /*! \brief Free regions sorted by offset \ref MemArenaExtent */
+    MemArenaExtent      *free_list;
+
+    /*! \brief Number of entries in free_list */
+    vx_int32            num_free;
+
+    /*! \brief Capacity of free_list */
+    vx_int32            max_free;
+
+    /*! \brief Mutex for arena management */
+    pthread_mutex_t     lock;
+} MemArena;
+
+/*!
+ * \brief Memory usage statistics of a graph.
+ */
+typedef struct {
+    /*! \brief Size of the arena in bytes, 0 if the arena is not used */
+    vx_uint64           total_bytes;
+
+    /*! \brief Bytes backing buffers of all pools */
+    vx_uint64           used_bytes;
+
+    /*! \brief Maximum bytes in use from the arena */
+    vx_uint64           peak_bytes;
+
+    /*! \brief Bytes of the arena not handed out */
+    vx_uint64           free_bytes;
+
+    /*! \brief Largest contiguous free region of the arena */
+    vx_uint64           largest_free_bytes;
+
+    /*! \brief 1 - largest_free_bytes / free_bytes, 0 means unfragmented */
+    vx_float32          fragmentation;
+
+    /*! \brief Number of slices currently handed out from the arena */
+    vx_int32            num_allocs;
+} MemStats;
+
+/*!
+ * \brief Latency and queue statistics of a floating pad.
+ */
+typedef struct {
+    /*! \brief Enqueue to dequeue latency percentiles in us */
+    vx_float32          graph_p50_us;
+    vx_float32          graph_p95_us;
+    vx_float32          graph_p99_us;
+
+    /*! \brief Largest enqueue to dequeue latency in us */
+    vx_uint64           graph_max_us;
+
+    /*! \brief Percentiles in us of the time the app holds a buffer */
+    vx_float32          hold_p50_us;
+    vx_float32          hold_p95_us;
+    vx_float32          hold_p99_us;
+
+    /*! \brief Number of buffers dequeued from the graph */
+    vx_uint64           num_dequeued;
+
+    /*! \brief Number of buffers enqueued to the graph */
+    vx_uint64           num_enqueued;
+
+    /*! \brief Buffers currently enqueued to the graph */
+    vx_int32            queue_depth;
+
+    /*! \brief Largest number of buffers enqueued at once */
+    vx_int32            max_queue_depth;
+
+    /*! \brief Average number of buffers enqueued, sampled at enqueue */
+    vx_float32          avg_queue_depth;
+
+    /*! \brief Enqueues that found the queue empty. Frequent underruns on
+     *         a sink pad mean the graph is starved of input.
+     */
+    vx_uint64           num_underruns;
+
+    /*! \brief Acquires that found no free buffer. Frequent waits mean
+     *         buffers are backed up in the graph or in the app.
+     */
+    vx_uint64           num_acquire_waits;
+
+    /*! \brief Acquires that returned no buffer */
+    vx_uint64           num_acquire_fails;
+
+    /*! \brief Non blocking or timed dequeues that returned no buffer */
+    vx_uint64           num_dequeue_empty;
+
+    /*! \brief Buffers released by the drop policy of the pad */
+    vx_uint64           num_dropped;
+
+    /*! \brief Largest number of buffers backed by memory, above the
+     *         bufq_depth if the pool had to grow
+     */
+    vx_int32            max_allocated;
+
+    /*! \brief Time covered by the statistics in us */
+    vx_uint64           elapsed_us;
+} PadStats;
+
+/*!
+ * \brief Buffer queue depth recommended for a floating pad from its
+ *        statistics, see tiovx_modules_recommend_bufq_depths.
+ */
+typedef struct {
+    /*! \brief Pad the recommendation is for \ref _Pad */
+    Pad                 *pad;
+
+    /*! \brief Current buffer queue depth of the pad */
+    vx_int32            bufq_depth;
+
+    /*! \brief Recommended buffer queue depth */
+    vx_int32            recommended;
+
+    /*! \brief Underruns and acquire waits per enqueue */
+    vx_float32          stall_ratio;
+} BufqDepthHint;
+
 struct _GraphObj {
     /*! \brief OpenVX context used for creating all OpenVX references */
     vx_context                          tiovx_context;
@@ -286,21 +695,66 @@ struct _GraphObj {
     /*! \brief Actual OpenVX graph */
     vx_graph                            tiovx_graph;
 
-    /*! \brief Graph params list */
-    vx_graph_parameter_queue_params_t   graph_params_list[TIOVX_MODULES_MAX_GRAPH_PARAMS];
+    /*! \brief Graph params list, grown as floating pads are added */
+    vx_graph_parameter_queue_params_t   *graph_params_list;
 
     /*! \brief Number of graph params */
     vx_int32                            num_graph_params;
 
+    /*! \brief Capacity of graph_params_list */
+    vx_int32                            max_graph_params;
+
     /*! \brief Number of nodes in the graph */
     vx_int32                            num_nodes;
 
-    /*! \brief List of nodes in the graph */
-    NodeObj                             node_list[TIOVX_MODULES_MAX_NODES];
+    /*! \brief Capacity of node_list */
+    vx_int32                            max_nodes;
+
+    /*! \brief List of nodes in the graph, nodes never move once added */
+    NodeObj                             **node_list;
 
     /* \brief Schedule mode (AUTO or MANUAL) */
     vx_enum                             schedule_mode;
     pthread_mutex_t                     lock;
+
+    /*! \brief Back all buffer pools with one allocation if set before
+     *         verify. Buffers are then slices of one DMA-buf, so modules
+     *         that import them by fd must honour the plane offset.
+     */
+    vx_bool                             use_mem_arena;
+
+    /*! \brief Memory arena, created in verify if use_mem_arena is set */
+    MemArena                            mem_arena;
+
+    /*! \brief Register a consumed event for every graph parameter in
+     *         verify, needed by the event driven runtime.
+     */
+    vx_bool                             use_param_events;
+
+    /*! \brief App value of the event of graph parameter 0, unique across
+     *         graphs sharing the context. Set in verify.
+     */
+    vx_uint32                           event_base;
+
+    /*! \brief Record latency and queue statistics in every buffer pool if
+     *         set before verify, see tiovx_modules_get_pad_stats.
+     */
+    vx_bool                             collect_pad_stats;
+
+    /*! \brief Time spent in each startup phase in us \ref STARTUP_PHASE */
+    vx_uint64                           startup_us[TIOVX_MODULES_NUM_PHASES];
+
+    /*! \brief Time initialize_graph started and verify ended in us */
+    vx_uint64                           startup_begin_us;
+    vx_uint64                           startup_end_us;
+
+    /*! \brief Print the startup profile at the end of verify if set */
+    vx_bool                             print_startup_profile;
+
+    /*! \brief Threads loading nodes and allocating buffer pools in verify,
+     *         0 for one per online CPU and 1 to do it in the caller.
+     */
+    vx_int32                            num_verify_threads;
 };
 
 typedef struct {
@@ -60,93 +60,983 @@
  *
  */
 #include "tiovx_modules.h"
+#include "tiovx_modules_trace.h"
 #include <edgeai_tiovx_img_proc.h>
 #include <TI/hwa_kernels.h>
 #include <TI/dl_kernels.h>
 #include <TI/video_io_kernels.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #define LOCK(a) pthread_mutex_lock(&a->lock)
 #define UNLOCK(a) pthread_mutex_unlock(&a->lock)
 
+/* Number of retries on an empty free ring before sleeping on the semaphore */
+#define TIOVX_MODULES_BUF_RING_SPIN_COUNT (64u)
+
+/* Sleep between polls of the graph done queues in timed dequeue */
+#define TIOVX_MODULES_DEQUEUE_POLL_US (500u)
+
+/* Longest wait on graph parameter events before the done queues are checked */
+#define TIOVX_MODULES_PARAM_EVENT_WAIT_MS (100u)
+
+/* Number of acquires without needing grown buffers before one is freed */
+#define TIOVX_MODULES_BUFPOOL_IDLE_COUNT (64u)
+
 extern NodeCbs gNodeCbs[TIOVX_MODULES_NUM_MODULES];
 
-vx_status tiovx_modules_initialize_graph(GraphObj *graph)
-{
-    vx_status status = VX_FAILURE;
+/* Next free event app value, graphs in a process share one context */
+static vx_uint32 g_event_base = 0;
+
+/*
+ * Graph parameter events are read off the context queue by runtime
+ * reactors, which bump the sequence so timed dequeues can sleep on it.
+ */
+static pthread_mutex_t g_param_event_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_param_event_cond = PTHREAD_COND_INITIALIZER;
+static vx_uint64 g_param_event_seq = 0;
+static vx_int32 g_num_param_event_sources = 0;
+
+/* Initial capacity of node and graph param tables, doubled when full */
+#define TIOVX_MODULES_INIT_TABLE_SIZE (16)
+
+/* Max threads loading nodes in verify, the loads are mostly file I/O */
+#define TIOVX_MODULES_MAX_VERIFY_THREADS (8)
+
+typedef struct {
+    GraphObj *graph;
+    vx_int32 next_node;
+    vx_status status;
+} VerifyLoadCtx;
+
+static vx_uint64 tiovx_modules_get_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (vx_uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static vx_status tiovx_modules_grow_table(void **table, vx_int32 *capacity,
+                                          size_t entry_size)
+{
+    vx_status status = VX_FAILURE;
+    vx_int32 new_capacity;
+    void *new_table = NULL;
+
+    new_capacity = (0 == *capacity) ? TIOVX_MODULES_INIT_TABLE_SIZE :
+                                      (*capacity * 2);
+    new_table = realloc(*table, new_capacity * entry_size);
+    if (NULL == new_table) {
+        TIOVX_MODULE_ERROR("Table alloc failed\n");
+        return VX_ERROR_NO_MEMORY;
+    }
+
+    *table = new_table;
+    *capacity = new_capacity;
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+/* Shrink a pad list to the pads the module used. Linked peers point back
+ * to the pads, so they are fixed up after the move.
+ */
+static vx_status tiovx_modules_trim_pads(Pad **pads, vx_int32 num_pads)
+{
+    vx_status status = VX_FAILURE;
+    Pad *trimmed = NULL;
+
+    if (num_pads > 0) {
+        trimmed = (Pad *)malloc(num_pads * sizeof(Pad));
+        if (NULL == trimmed) {
+            TIOVX_MODULE_ERROR("Pad alloc failed\n");
+            return VX_ERROR_NO_MEMORY;
+        }
+
+        memcpy(trimmed, *pads, num_pads * sizeof(Pad));
+        for (vx_int32 i = 0; i < num_pads; i++) {
+            if (NULL != trimmed[i].peer_pad) {
+                trimmed[i].peer_pad->peer_pad = &trimmed[i];
+            }
+        }
+    }
+
+    free(*pads);
+    *pads = trimmed;
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+static void tiovx_modules_free_node_obj(NodeObj *node)
+{
+    free(node->sinks);
+    free(node->srcs);
+    free(node);
+}
+
+vx_status tiovx_modules_initialize_graph(GraphObj *graph)
+{
+    vx_status status = VX_FAILURE;
+
+    CLR(graph);
+    graph->startup_begin_us = tiovx_modules_get_time_us();
+    graph->tiovx_context = vxCreateContext();
+
+    tivxHwaLoadKernels(graph->tiovx_context);
+    tivxEdgeaiImgProcLoadKernels(graph->tiovx_context);
+    tivxTIDLLoadKernels(graph->tiovx_context);
+    tivxVideoIOLoadKernels(graph->tiovx_context);
+    tivxExtLoadKernels(graph->tiovx_context);
+
+    graph->tiovx_graph = vxCreateGraph(graph->tiovx_context);
+    graph->schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_MANUAL;
+    pthread_mutex_init(&graph->lock, NULL);
+
+    graph->startup_us[TIOVX_MODULES_PHASE_CONTEXT] =
+                        tiovx_modules_get_time_us() - graph->startup_begin_us;
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+NodeObj* tiovx_modules_add_node(GraphObj *graph, NODE_TYPES node_type, void *cfg)
+{
+    vx_status status = VX_FAILURE;
+    NodeObj *node = NULL;
+    vx_uint64 start;
+
+    LOCK(graph);
+
+    if (graph->num_nodes == graph->max_nodes) {
+        status = tiovx_modules_grow_table((void **)&graph->node_list,
+                                          &graph->max_nodes,
+                                          sizeof(NodeObj *));
+        if (VX_SUCCESS != status) {
+            UNLOCK(graph);
+            return NULL;
+        }
+    }
+
+    /* Pads are allocated for the maximum, init_node sets the real count */
+    node = (NodeObj *)calloc(1, sizeof(NodeObj));
+    if (NULL != node) {
+        node->sinks = (Pad *)calloc(TIOVX_MODULES_MAX_NODE_INPUTS, sizeof(Pad));
+        node->srcs = (Pad *)calloc(TIOVX_MODULES_MAX_NODE_OUTPUTS, sizeof(Pad));
+    }
+
+    if (NULL == node || NULL == node->sinks || NULL == node->srcs) {
+        TIOVX_MODULE_ERROR("Node alloc failed\n");
+        if (NULL != node) {
+            tiovx_modules_free_node_obj(node);
+        }
+        UNLOCK(graph);
+        return NULL;
+    }
+
+    node->graph = graph;
+    node->node_index = graph->num_nodes;
+    node->cbs = &gNodeCbs[node_type];
+    node->node_cfg = malloc(node->cbs->get_cfg_size());
+    node->node_type = node_type;
+
+    if (node->cbs->get_priv_size) {
+        node->node_priv = malloc(node->cbs->get_priv_size());
+    }
+
+    for (uint8_t i = 0; i < TIOVX_MODULES_MAX_NODE_INPUTS; i++) {
+        node->sinks[i].direction = SINK;
+        node->sinks[i].num_channels = TIOVX_MODULES_DEFAULT_NUM_CHANNELS;
+        node->sinks[i].bufq_depth = TIOVX_MODULES_DEFAULT_BUFQ_DEPTH;
+        node->sinks[i].graph_parameter_index = -1;
+        node->sinks[i].node_parameter_index = -1;
+    }
+
+    for (uint8_t i = 0; i < TIOVX_MODULES_MAX_NODE_OUTPUTS; i++) {
+        node->srcs[i].direction = SRC;
+        node->srcs[i].num_channels = TIOVX_MODULES_DEFAULT_NUM_CHANNELS;
+        node->srcs[i].bufq_depth = TIOVX_MODULES_DEFAULT_BUFQ_DEPTH;
+        node->srcs[i].graph_parameter_index = -1;
+        node->srcs[i].node_parameter_index = -1;
+    }
+
+    memcpy(node->node_cfg, cfg, node->cbs->get_cfg_size());
+
+    start = tiovx_modules_get_time_us();
+    status = node->cbs->init_node(node);
+    node->startup_us[TIOVX_MODULES_PHASE_INIT_NODES] =
+                                        tiovx_modules_get_time_us() - start;
+    graph->startup_us[TIOVX_MODULES_PHASE_INIT_NODES] +=
+                                node->startup_us[TIOVX_MODULES_PHASE_INIT_NODES];
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_trim_pads(&node->sinks, node->num_inputs);
+    }
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_trim_pads(&node->srcs, node->num_outputs);
+    }
+
+    if (VX_SUCCESS != status) {
+        TIOVX_MODULE_ERROR("Node Init failed, Node Type: %d\n", node_type);
+        free(node->node_cfg);
+        free(node->node_priv);
+        tiovx_modules_free_node_obj(node);
+        node = NULL;
+    } else {
+        graph->node_list[graph->num_nodes] = node;
+        graph->num_nodes += 1;
+    }
+
+    UNLOCK(graph);
+
+    return node;
+}
+
+/*
+ * Bounded MPMC ring (sequence numbered slots). The size is rounded up to a
+ * power of two so that the free running head and tail positions wrap
+ * consistently.
+ */
+static vx_status tiovx_modules_buf_ring_init(BufRing *ring, vx_uint32 depth)
+{
+    vx_status status = VX_FAILURE;
+    vx_uint32 size = 1;
+
+    while (size < depth) {
+        size <<= 1;
+    }
+
+    ring->cells = (BufRingCell *)malloc(size * sizeof(BufRingCell));
+    if (NULL == ring->cells) {
+        TIOVX_MODULE_ERROR("Ring alloc failed\n");
+        return status;
+    }
+
+    for (vx_uint32 i = 0; i < size; i++) {
+        ring->cells[i].seq = i;
+        ring->cells[i].buf = NULL;
+    }
+
+    ring->size = size;
+    ring->head = 0;
+    ring->tail = 0;
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+static void tiovx_modules_buf_ring_deinit(BufRing *ring)
+{
+    free(ring->cells);
+    ring->cells = NULL;
+    ring->size = 0;
+}
+
+static vx_bool tiovx_modules_buf_ring_push(BufRing *ring, Buf *buf)
+{
+    BufRingCell *cell = NULL;
+    vx_uint32 pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+    for (;;) {
+        cell = &ring->cells[pos & (ring->size - 1)];
+        vx_uint32 seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        vx_int32 diff = (vx_int32)(seq - pos);
+
+        if (0 == diff) {
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return vx_false_e;
+        } else {
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->buf = buf;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+    return vx_true_e;
+}
+
+static Buf* tiovx_modules_buf_ring_pop(BufRing *ring)
+{
+    BufRingCell *cell = NULL;
+    Buf *buf = NULL;
+    vx_uint32 pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    for (;;) {
+        cell = &ring->cells[pos & (ring->size - 1)];
+        vx_uint32 seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        vx_int32 diff = (vx_int32)(seq - (pos + 1));
+
+        if (0 == diff) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return NULL;
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    buf = cell->buf;
+    __atomic_store_n(&cell->seq, pos + ring->size, __ATOMIC_RELEASE);
+
+    return buf;
+}
+
+static vx_int32 tiovx_modules_buf_ring_count(BufRing *ring)
+{
+    vx_uint32 head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    vx_uint32 tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    return (vx_int32)(head - tail);
+}
+
+#define ALIGN_UP(x, a) ((((x) + (a) - 1) / (a)) * (a))
+
+static void* tiovx_modules_mem_arena_alloc(MemArena *arena, vx_uint64 size)
+{
+    void *addr = NULL;
+
+    size = ALIGN_UP(size, TIOVX_MODULES_MEM_ARENA_ALIGN);
+
+    pthread_mutex_lock(&arena->lock);
+
+    /*
+     * Adjacent free regions are always merged, so there is at most one
+     * more free region than live allocations. Capping the allocations
+     * keeps the free list from ever overflowing.
+     */
+    for (vx_int32 i = 0; i < arena->num_free &&
+                         arena->num_allocs + 1 < arena->max_free; i++) {
+        MemArenaExtent *ext = &arena->free_list[i];
+
+        if (ext->size < size) {
+            continue;
+        }
+
+        addr = arena->base + ext->offset;
+        ext->offset += size;
+        ext->size -= size;
+
+        if (0 == ext->size) {
+            memmove(&arena->free_list[i], &arena->free_list[i + 1],
+                    (arena->num_free - i - 1) * sizeof(MemArenaExtent));
+            arena->num_free--;
+        }
+
+        arena->used_bytes += size;
+        arena->num_allocs++;
+        if (arena->used_bytes > arena->peak_bytes) {
+            arena->peak_bytes = arena->used_bytes;
+        }
+        break;
+    }
+
+    pthread_mutex_unlock(&arena->lock);
+
+    if (NULL == addr) {
+        TIOVX_MODULE_ERROR("Memory arena exhausted, requested %lu bytes\n",
+                           (unsigned long)size);
+    }
+
+    return addr;
+}
+
+static void tiovx_modules_mem_arena_free(MemArena *arena, void *addr,
+                                         vx_uint64 size)
+{
+    vx_uint64 offset = (vx_uint8 *)addr - arena->base;
+    vx_int32 i = 0;
+
+    size = ALIGN_UP(size, TIOVX_MODULES_MEM_ARENA_ALIGN);
+
+    pthread_mutex_lock(&arena->lock);
+
+    /* Empty slices never took an extent, only drop the count */
+    if (0 == size) {
+        arena->num_allocs--;
+        pthread_mutex_unlock(&arena->lock);
+        return;
+    }
+
+    while (i < arena->num_free && arena->free_list[i].offset < offset) {
+        i++;
+    }
+
+    /* Merge with the previous and/or next free region where adjacent */
+    if (i > 0 && arena->free_list[i - 1].offset +
+                 arena->free_list[i - 1].size == offset) {
+        arena->free_list[i - 1].size += size;
+        if (i < arena->num_free &&
+            offset + size == arena->free_list[i].offset) {
+            arena->free_list[i - 1].size += arena->free_list[i].size;
+            memmove(&arena->free_list[i], &arena->free_list[i + 1],
+                    (arena->num_free - i - 1) * sizeof(MemArenaExtent));
+            arena->num_free--;
+        }
+    } else if (i < arena->num_free &&
+               offset + size == arena->free_list[i].offset) {
+        arena->free_list[i].offset = offset;
+        arena->free_list[i].size += size;
+    } else if (arena->num_free < arena->max_free) {
+        memmove(&arena->free_list[i + 1], &arena->free_list[i],
+                (arena->num_free - i) * sizeof(MemArenaExtent));
+        arena->free_list[i].offset = offset;
+        arena->free_list[i].size = size;
+        arena->num_free++;
+    } else {
+        /* Unreachable while allocations are capped, the extent stays used */
+        TIOVX_MODULE_ERROR("Memory arena free list full\n");
+        pthread_mutex_unlock(&arena->lock);
+        return;
+    }
+
+    arena->used_bytes -= size;
+    arena->num_allocs--;
+
+    pthread_mutex_unlock(&arena->lock);
+}
+
+static vx_bool tiovx_modules_mem_arena_owns(MemArena *arena, void *addr)
+{
+    return (NULL != arena->base &&
+            (vx_uint8 *)addr >= arena->base &&
+            (vx_uint8 *)addr < arena->base + arena->size) ?
+           vx_true_e : vx_false_e;
+}
+
+static void tiovx_modules_free_addrs(MemArena *arena, void **addr,
+                                     vx_uint32 *size, vx_uint32 num_entries,
+                                     vx_uint64 *mem_size)
+{
+    for (vx_uint32 i = 0; i < num_entries; i++) {
+        if (NULL == addr[i]) {
+            continue;
+        }
+
+        if (NULL != arena &&
+            vx_true_e == tiovx_modules_mem_arena_owns(arena, addr[i])) {
+            tiovx_modules_mem_arena_free(arena, addr[i], size[i]);
+        } else {
+            tivxMemFree(addr[i], size[i], TIVX_MEM_EXTERNAL);
+        }
+        addr[i] = NULL;
+        *mem_size -= size[i];
+    }
+}
+
+vx_status tiovx_modules_reference_alloc_mem(vx_reference ref,
+                                            MemArena *arena,
+                                            vx_uint64 *mem_size)
+{
+    vx_status status = VX_FAILURE;
+    void *addr[TIOVX_MODULES_MAX_REF_HANDLES] = {NULL};
+    vx_uint32 size[TIOVX_MODULES_MAX_REF_HANDLES], num_entries;
+
+    status = tivxReferenceExportHandle(ref, addr, size,
+                                       TIOVX_MODULES_MAX_REF_HANDLES,
+                                       &num_entries);
+    if(status != VX_SUCCESS)
+    {
+        TIOVX_MODULE_ERROR("Error exporting handles\n");
+        return status;
+    }
+
+    for(int i = 0; i < num_entries; i++)
+    {
+        if (NULL != arena && NULL != arena->base)
+        {
+            addr[i] = tiovx_modules_mem_arena_alloc(arena, size[i]);
+        }
+        else
+        {
+            addr[i] = tivxMemAlloc(size[i], TIVX_MEM_EXTERNAL);
+        }
+
+        if (NULL == addr[i])
+        {
+            TIOVX_MODULE_ERROR("Error allocating memory\n");
+            tiovx_modules_free_addrs(arena, addr, size, i, mem_size);
+            return VX_ERROR_NO_MEMORY;
+        }
+        *mem_size += size[i];
+    }
+
+    status = tivxReferenceImportHandle(ref, (const void **)addr,
+                                       size, num_entries);
+    if(status != VX_SUCCESS)
+    {
+        TIOVX_MODULE_ERROR("Error importing handles\n");
+        tiovx_modules_free_addrs(arena, addr, size, num_entries, mem_size);
+    }
+
+    return status;
+}
+
+static vx_status tiovx_modules_reference_free_mem(vx_reference ref,
+                                                   MemArena *arena,
+                                                   vx_uint64 *mem_size)
+{
+    vx_status status = VX_FAILURE;
+    void *addr[TIOVX_MODULES_MAX_REF_HANDLES] = {NULL};
+    vx_uint32 size[TIOVX_MODULES_MAX_REF_HANDLES], num_entries;
+
+    status = tivxReferenceExportHandle(ref, addr, size,
+                                       TIOVX_MODULES_MAX_REF_HANDLES,
+                                       &num_entries);
+    if(status != VX_SUCCESS)
+    {
+        TIOVX_MODULE_ERROR("Error exporting handles\n");
+        return status;
+    }
+
+    tiovx_modules_free_addrs(arena, addr, size, num_entries, mem_size);
+
+    status = tivxReferenceImportHandle(ref, (const void **)addr,
+                                       size, num_entries);
+    if(status != VX_SUCCESS)
+    {
+        TIOVX_MODULE_ERROR("Error importing handles\n");
+    }
+
+    return status;
+}
+
+static vx_status tiovx_modules_buf_alloc_mem(Buf *buf)
+{
+    vx_status status = VX_FAILURE;
+    MemArena *arena = &buf->pool->pad->node->graph->mem_arena;
+
+    for (uint8_t j=0; j < buf->num_channels; j++) {
+        vx_reference ref = vxGetObjectArrayItem(buf->arr, j);
+        status = tiovx_modules_reference_alloc_mem(ref, arena,
+                                                   &buf->pool->mem_size);
+        vxReleaseReference(&ref);
+        if(status != VX_SUCCESS)
+        {
+            TIOVX_MODULE_ERROR("Memory alloc failed\n");
+
+            /* Leave no channel half backed, the buffer stays reusable */
+            while (j > 0) {
+                j--;
+                ref = vxGetObjectArrayItem(buf->arr, j);
+                tiovx_modules_reference_free_mem(ref, arena,
+                                                 &buf->pool->mem_size);
+                vxReleaseReference(&ref);
+            }
+            break;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * Detach imported memory from a buffer. The mappings of the DMA-buf fds
+ * belong to the TIOVX memory layer, so they are left to it.
+ */
+static vx_status tiovx_modules_buf_unimport_mem(Buf *buf)
+{
+    vx_status status = VX_FAILURE;
+    void *addr[TIOVX_MODULES_MAX_REF_HANDLES] = {NULL};
+    vx_uint32 size[TIOVX_MODULES_MAX_REF_HANDLES], num_entries;
+
+    for (uint8_t j=0; j < buf->num_channels; j++) {
+        vx_reference ref = vxGetObjectArrayItem(buf->arr, j);
+        status = tivxReferenceExportHandle(ref, addr, size,
+                                           TIOVX_MODULES_MAX_REF_HANDLES,
+                                           &num_entries);
+        if (VX_SUCCESS == status) {
+            memset(addr, 0, sizeof(addr));
+            status = tivxReferenceImportHandle(ref, (const void **)addr,
+                                               size, num_entries);
+        }
+        vxReleaseReference(&ref);
+        if(status != VX_SUCCESS)
+        {
+            TIOVX_MODULE_ERROR("Detaching imported memory failed\n");
+            break;
+        }
+    }
+
+    buf->imported = vx_false_e;
+
+    return status;
+}
+
+static vx_status tiovx_modules_buf_free_mem(Buf *buf)
+{
+    vx_status status = VX_FAILURE;
+    MemArena *arena = &buf->pool->pad->node->graph->mem_arena;
+
+    if (buf->imported) {
+        return tiovx_modules_buf_unimport_mem(buf);
+    }
+
+    for (uint8_t j=0; j < buf->num_channels; j++) {
+        vx_reference ref = vxGetObjectArrayItem(buf->arr, j);
+        status = tiovx_modules_reference_free_mem(ref, arena,
+                                                  &buf->pool->mem_size);
+        vxReleaseReference(&ref);
+        if(status != VX_SUCCESS)
+        {
+            TIOVX_MODULE_ERROR("Memory free failed\n");
+            break;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * Back one spare buffer with memory. Returns NULL if the pool is already at
+ * max_bufq_depth.
+ */
+static Buf* tiovx_modules_grow_bufpool(BufPool *buf_pool)
+{
+    Buf *buf = NULL;
+
+    /* Import pools only get memory from tiovx_modules_import_buf */
+    if (buf_pool->import_mem) {
+        return NULL;
+    }
+
+    LOCK(buf_pool);
+
+    if (0 == buf_pool->spare_count) {
+        UNLOCK(buf_pool);
+        return NULL;
+    }
+
+    buf_pool->spare_count--;
+    buf = buf_pool->spareQ[buf_pool->spare_count];
+
+    if (VX_SUCCESS != tiovx_modules_buf_alloc_mem(buf)) {
+        /*
+         * Only a buffer with no memory attached goes back to the spares,
+         * one that can't be cleaned is retired so it is never reused.
+         */
+        if (VX_SUCCESS == tiovx_modules_buf_free_mem(buf)) {
+            buf_pool->spare_count++;
+        } else {
+            TIOVX_MODULE_ERROR("Retiring buffer %d of pool\n", buf->buf_index);
+        }
+        UNLOCK(buf_pool);
+        return NULL;
+    }
+
+    buf_pool->num_allocated++;
+    buf_pool->idle_count = 0;
+    if (buf_pool->num_allocated > buf_pool->stats.max_allocated) {
+        buf_pool->stats.max_allocated = buf_pool->num_allocated;
+    }
+
+    UNLOCK(buf_pool);
+
+    TIOVX_MODULE_PRINTF("Pool grown to %d buffers\n", buf_pool->num_allocated);
+
+    return buf;
+}
+
+/* Free the memory of a buffer taken out of the free queue. Lock must be held */
+static void tiovx_modules_shrink_bufpool(BufPool *buf_pool, Buf *buf)
+{
+    tiovx_modules_buf_free_mem(buf);
+    buf_pool->spareQ[buf_pool->spare_count] = buf;
+    buf_pool->spare_count++;
+    buf_pool->num_allocated--;
+    buf_pool->idle_count = 0;
+
+    TIOVX_MODULE_PRINTF("Pool shrunk to %d buffers\n", buf_pool->num_allocated);
+}
+
+static void tiovx_modules_check_idle_lock_free(BufPool *buf_pool)
+{
+    Buf *buf = NULL;
+
+    if (buf_pool->import_mem ||
+        __atomic_load_n(&buf_pool->num_allocated, __ATOMIC_RELAXED) <=
+                                                        buf_pool->bufq_depth) {
+        return;
+    }
+
+    if (tiovx_modules_buf_ring_count(&buf_pool->free_ring) <= 0) {
+        __atomic_store_n(&buf_pool->idle_count, 0, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if (__atomic_add_fetch(&buf_pool->idle_count, 1, __ATOMIC_RELAXED) <
+                                        (vx_int32)TIOVX_MODULES_BUFPOOL_IDLE_COUNT) {
+        return;
+    }
+
+    LOCK(buf_pool);
+    if (buf_pool->num_allocated > buf_pool->bufq_depth) {
+        buf = tiovx_modules_buf_ring_pop(&buf_pool->free_ring);
+        if (NULL != buf) {
+            tiovx_modules_shrink_bufpool(buf_pool, buf);
+        }
+    }
+    UNLOCK(buf_pool);
+}
+
+/*
+ * Wait on a semaphore till deadline, NULL deadline waits forever.
+ * Returns 0 if the semaphore was taken.
+ */
+static int tiovx_modules_sem_wait_until(sem_t *sem,
+                                        const struct timespec *deadline)
+{
+    int ret;
+
+    do {
+        if (NULL == deadline) {
+            ret = sem_wait(sem);
+        } else {
+            ret = sem_timedwait(sem, deadline);
+        }
+    } while (0 != ret && EINTR == errno);
+
+    return ret;
+}
+
+static struct timespec* tiovx_modules_get_deadline(vx_uint32 timeout_ms,
+                                                   struct timespec *deadline)
+{
+    if (TIOVX_MODULES_WAIT_FOREVER == timeout_ms) {
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+
+    return deadline;
+}
+
+static void tiovx_modules_stats_max(vx_uint64 *max, vx_uint64 val)
+{
+    vx_uint64 cur = __atomic_load_n(max, __ATOMIC_RELAXED);
+
+    while (val > cur &&
+           !__atomic_compare_exchange_n(max, &cur, val, vx_true_e,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+static void tiovx_modules_hist_add(LatencyHist *hist, vx_uint64 us)
+{
+    vx_uint32 bucket = 0;
+
+    if (us > 0) {
+        bucket = 64 - __builtin_clzll(us);
+        if (bucket >= TIOVX_MODULES_STATS_NUM_BUCKETS) {
+            bucket = TIOVX_MODULES_STATS_NUM_BUCKETS - 1;
+        }
+    }
+
+    __atomic_add_fetch(&hist->buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&hist->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&hist->sum_us, us, __ATOMIC_RELAXED);
+    tiovx_modules_stats_max(&hist->max_us, us);
+}
+
+/* Interpolate the percentile inside the bucket it falls in */
+static vx_float32 tiovx_modules_hist_percentile(LatencyHist *hist,
+                                                vx_float32 pct)
+{
+    vx_uint64 count = __atomic_load_n(&hist->count, __ATOMIC_RELAXED);
+    vx_uint64 max_us = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    vx_float64 target = pct * count, cumulative = 0;
+    vx_float64 lower, upper, result = max_us;
+
+    if (0 == count) {
+        return 0;
+    }
+
+    for (vx_uint32 i = 0; i < TIOVX_MODULES_STATS_NUM_BUCKETS; i++) {
+        vx_uint64 num = __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+
+        if (num > 0 && cumulative + num >= target) {
+            lower = (0 == i) ? 0 : (vx_float64)(1ull << (i - 1));
+            upper = (0 == i) ? 1 : (vx_float64)(1ull << i);
+            result = lower + (upper - lower) * (target - cumulative) / num;
+            break;
+        }
+        cumulative += num;
+    }
+
+    if (result > max_us) {
+        result = max_us;
+    }
 
-    CLR(graph);
-    graph->tiovx_context = vxCreateContext();
+    return result;
+}
 
-    tivxHwaLoadKernels(graph->tiovx_context);
-    tivxEdgeaiImgProcLoadKernels(graph->tiovx_context);
-    tivxTIDLLoadKernels(graph->tiovx_context);
-    tivxVideoIOLoadKernels(graph->tiovx_context);
-    tivxExtLoadKernels(graph->tiovx_context);
+static void tiovx_modules_stats_hold_end(BufPool *buf_pool, Buf *buf,
+                                         vx_uint64 now)
+{
+    if (0 != buf->hold_ts) {
+        tiovx_modules_hist_add(&buf_pool->stats.hold_latency,
+                               now - buf->hold_ts);
+        buf->hold_ts = 0;
+    }
+}
 
-    graph->tiovx_graph = vxCreateGraph(graph->tiovx_context);
-    graph->schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_MANUAL;
-    pthread_mutex_init(&graph->lock, NULL);
+static void tiovx_modules_stats_enqueue(BufPool *buf_pool, Buf **bufs,
+                                        vx_uint32 num_bufs)
+{
+    BufPoolStats *stats = &buf_pool->stats;
+    vx_uint64 now = tiovx_modules_get_time_us();
+    vx_int32 depth, max_depth;
 
-    status = VX_SUCCESS;
+    for (vx_uint32 i = 0; i < num_bufs; i++) {
+        tiovx_modules_stats_hold_end(buf_pool, bufs[i], now);
+        bufs[i]->enqueue_ts = now;
+    }
 
-    return status;
+    depth = __atomic_add_fetch(&stats->queue_depth, num_bufs,
+                               __ATOMIC_RELAXED);
+    if (depth == (vx_int32)num_bufs) {
+        __atomic_add_fetch(&stats->num_underruns, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_add_fetch(&stats->num_enqueues, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->queue_depth_sum, depth, __ATOMIC_RELAXED);
+    max_depth = __atomic_load_n(&stats->max_queue_depth, __ATOMIC_RELAXED);
+    while (depth > max_depth &&
+           !__atomic_compare_exchange_n(&stats->max_queue_depth, &max_depth,
+                                        depth, vx_true_e, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED));
 }
 
-NodeObj* tiovx_modules_add_node(GraphObj *graph, NODE_TYPES node_type, void *cfg)
+static void tiovx_modules_stats_dequeue(BufPool *buf_pool, Buf **bufs,
+                                        vx_uint32 num_bufs)
 {
-    vx_status status = VX_FAILURE;
+    BufPoolStats *stats = &buf_pool->stats;
+    vx_uint64 now = tiovx_modules_get_time_us();
 
-    LOCK(graph);
-    NodeObj *node = &(graph->node_list[graph->num_nodes]);
+    for (vx_uint32 i = 0; i < num_bufs; i++) {
+        tiovx_modules_hist_add(&stats->graph_latency,
+                               now - bufs[i]->enqueue_ts);
+        bufs[i]->hold_ts = now;
+    }
 
-    node->graph = graph;
-    node->node_index = graph->num_nodes;
-    node->cbs = &gNodeCbs[node_type];
-    node->node_cfg = malloc(node->cbs->get_cfg_size());
-    node->node_type = node_type;
+    __atomic_sub_fetch(&stats->queue_depth, num_bufs, __ATOMIC_RELAXED);
+}
 
-    if (node->cbs->get_priv_size) {
-        node->node_priv = malloc(node->cbs->get_priv_size());
+static Buf* tiovx_modules_acquire_buf_lock_free(BufPool *buf_pool,
+                                                vx_uint32 timeout_ms)
+{
+    Buf *buf = NULL;
+    struct timespec ts, *deadline = NULL;
+    vx_uint32 spin_count = (0 == timeout_ms) ?
+                           1 : TIOVX_MODULES_BUF_RING_SPIN_COUNT;
+
+    for (vx_uint32 i = 0; i < spin_count; i++) {
+        buf = tiovx_modules_buf_ring_pop(&buf_pool->free_ring);
+        if (NULL != buf) {
+            tiovx_modules_check_idle_lock_free(buf_pool);
+            return buf;
+        }
     }
 
-    for (uint8_t i = 0; i < TIOVX_MODULES_MAX_NODE_INPUTS; i++) {
-        node->sinks[i].direction = SINK;
-        node->sinks[i].num_channels = TIOVX_MODULES_DEFAULT_NUM_CHANNELS;
-        node->sinks[i].bufq_depth = TIOVX_MODULES_DEFAULT_BUFQ_DEPTH;
-        node->sinks[i].graph_parameter_index = -1;
-        node->sinks[i].node_parameter_index = -1;
+    if (buf_pool->collect_stats) {
+        __atomic_add_fetch(&buf_pool->stats.num_acquire_waits, 1,
+                           __ATOMIC_RELAXED);
     }
 
-    for (uint8_t i = 0; i < TIOVX_MODULES_MAX_NODE_OUTPUTS; i++) {
-        node->srcs[i].direction = SRC;
-        node->srcs[i].num_channels = TIOVX_MODULES_DEFAULT_NUM_CHANNELS;
-        node->srcs[i].bufq_depth = TIOVX_MODULES_DEFAULT_BUFQ_DEPTH;
-        node->srcs[i].graph_parameter_index = -1;
-        node->srcs[i].node_parameter_index = -1;
+    buf = tiovx_modules_grow_bufpool(buf_pool);
+    if (NULL != buf || 0 == timeout_ms) {
+        return buf;
     }
 
-    memcpy(node->node_cfg, cfg, node->cbs->get_cfg_size());
+    deadline = tiovx_modules_get_deadline(timeout_ms, &ts);
 
-    status = node->cbs->init_node(node);
-    if (VX_SUCCESS != status) {
-        TIOVX_MODULE_ERROR("Node Init failed, Node Type: %d\n", node_type);
-        CLR(node);
-        node = NULL;
-    } else {
-        graph->num_nodes += 1;
+    /*
+     * Register as waiter before the final check, release posts the
+     * semaphore only when it sees a waiter, so no wakeup is lost.
+     */
+    for (;;) {
+        int ret = 0;
+
+        __atomic_add_fetch(&buf_pool->num_waiters, 1, __ATOMIC_SEQ_CST);
+        buf = tiovx_modules_buf_ring_pop(&buf_pool->free_ring);
+        if (NULL == buf) {
+            ret = tiovx_modules_sem_wait_until(&buf_pool->sem, deadline);
+            buf = tiovx_modules_buf_ring_pop(&buf_pool->free_ring);
+        }
+        __atomic_sub_fetch(&buf_pool->num_waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (NULL != buf || 0 != ret) {
+            break;
+        }
     }
 
-    UNLOCK(graph);
+    return buf;
+}
 
-    return node;
+static vx_status tiovx_modules_release_buf_lock_free(Buf *buf)
+{
+    vx_status status = VX_FAILURE;
+    BufPool *buf_pool = buf->pool;
+
+    if (vx_false_e == tiovx_modules_buf_ring_push(&buf_pool->free_ring, buf)) {
+        TIOVX_MODULE_ERROR("Free queue full\n");
+        return status;
+    }
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&buf_pool->num_waiters, __ATOMIC_SEQ_CST) > 0) {
+        sem_post(&buf_pool->sem);
+    }
+
+    status = VX_SUCCESS;
+
+    return status;
 }
 
-Buf* tiovx_modules_acquire_buf(BufPool *buf_pool)
+static Buf* tiovx_modules_acquire_buf_mutex(BufPool *buf_pool,
+                                            vx_uint32 timeout_ms)
 {
     Buf *buf = NULL;
+    struct timespec ts;
+
+    if (0 != sem_trywait(&buf_pool->sem)) {
+        if (buf_pool->collect_stats) {
+            __atomic_add_fetch(&buf_pool->stats.num_acquire_waits, 1,
+                               __ATOMIC_RELAXED);
+        }
+
+        buf = tiovx_modules_grow_bufpool(buf_pool);
+        if (NULL != buf || 0 == timeout_ms) {
+            return buf;
+        }
+
+        if (0 != tiovx_modules_sem_wait_until(&buf_pool->sem,
+                            tiovx_modules_get_deadline(timeout_ms, &ts))) {
+            return NULL;
+        }
+    }
 
-    sem_wait(&buf_pool->sem);
     LOCK(buf_pool);
 
     if (!buf_pool->free_count) {
@@ -158,15 +1048,79 @@ Buf* tiovx_modules_acquire_buf(BufPool *buf_pool)
     buf_pool->free_count--;
     buf = buf_pool->freeQ[buf_pool->free_count];
 
+    if (!buf_pool->import_mem &&
+        buf_pool->num_allocated > buf_pool->bufq_depth) {
+        if (buf_pool->free_count > 0) {
+            buf_pool->idle_count++;
+        } else {
+            buf_pool->idle_count = 0;
+        }
+
+        if (buf_pool->idle_count >= TIOVX_MODULES_BUFPOOL_IDLE_COUNT &&
+            0 == sem_trywait(&buf_pool->sem)) {
+            buf_pool->free_count--;
+            tiovx_modules_shrink_bufpool(buf_pool,
+                                         buf_pool->freeQ[buf_pool->free_count]);
+        }
+    }
+
     UNLOCK(buf_pool);
 
     return buf;
 }
 
+Buf* tiovx_modules_acquire_buf_timeout(BufPool *buf_pool, vx_uint32 timeout_ms)
+{
+    Buf *buf = NULL;
+
+    if (buf_pool->lock_free) {
+        buf = tiovx_modules_acquire_buf_lock_free(buf_pool, timeout_ms);
+    } else {
+        buf = tiovx_modules_acquire_buf_mutex(buf_pool, timeout_ms);
+    }
+
+    if (NULL != buf) {
+        buf->held = vx_true_e;
+    }
+
+    if (buf_pool->collect_stats) {
+        if (NULL == buf) {
+            __atomic_add_fetch(&buf_pool->stats.num_acquire_fails, 1,
+                               __ATOMIC_RELAXED);
+        } else {
+            buf->hold_ts = tiovx_modules_get_time_us();
+        }
+    }
+
+    return buf;
+}
+
+Buf* tiovx_modules_acquire_buf(BufPool *buf_pool)
+{
+    return tiovx_modules_acquire_buf_timeout(buf_pool,
+                                             TIOVX_MODULES_WAIT_FOREVER);
+}
+
+Buf* tiovx_modules_try_acquire_buf(BufPool *buf_pool)
+{
+    return tiovx_modules_acquire_buf_timeout(buf_pool, 0);
+}
+
 vx_status tiovx_modules_release_buf(Buf *buf)
 {
     vx_status status = VX_FAILURE;
 
+    buf->held = vx_false_e;
+
+    if (buf->pool->collect_stats) {
+        tiovx_modules_stats_hold_end(buf->pool, buf,
+                                     tiovx_modules_get_time_us());
+    }
+
+    if (buf->pool->lock_free) {
+        return tiovx_modules_release_buf_lock_free(buf);
+    }
+
     LOCK(buf->pool);
 
     buf->pool->freeQ[buf->pool->free_count] = buf;
@@ -180,33 +1134,113 @@ vx_status tiovx_modules_release_buf(Buf *buf)
     return status;
 }
 
-vx_status tiovx_modules_reference_alloc_mem(vx_reference ref)
+Buf* tiovx_modules_import_buf(BufPool *buf_pool, vx_int32 *fds,
+                              vx_uint32 *offsets, vx_uint32 num_fds)
 {
-    vx_status status = VX_FAILURE;
+    vx_status status = VX_SUCCESS;
     void *addr[TIOVX_MODULES_MAX_REF_HANDLES] = {NULL};
     vx_uint32 size[TIOVX_MODULES_MAX_REF_HANDLES], num_entries;
+    void *virt_addr = NULL, *phy_addr = NULL;
+    vx_uint32 k = 0;
+    Buf *buf = NULL;
 
-    status = tivxReferenceExportHandle(ref, addr, size,
-                                       TIOVX_MODULES_MAX_REF_HANDLES,
-                                       &num_entries);
-    if(status != VX_SUCCESS)
-    {
-        TIOVX_MODULE_ERROR("Error exporting handles\n");
-        return status;
+    if (vx_false_e == buf_pool->import_mem) {
+        TIOVX_MODULE_ERROR("Pool is not an import pool\n");
+        return NULL;
     }
 
-    for(int i = 0; i < num_entries; i++)
-    {
-        addr[i] = tivxMemAlloc(size[i], TIVX_MEM_EXTERNAL);
+    LOCK(buf_pool);
+    if (0 == buf_pool->spare_count) {
+        TIOVX_MODULE_ERROR("No buffer left to import into\n");
+        UNLOCK(buf_pool);
+        return NULL;
     }
+    buf_pool->spare_count--;
+    buf = buf_pool->spareQ[buf_pool->spare_count];
+    UNLOCK(buf_pool);
 
-    status = tivxReferenceImportHandle(ref, (const void **)addr,
-                                       size, num_entries);
-    if(status != VX_SUCCESS)
-    {
-        TIOVX_MODULE_ERROR("Error importing handles\n");
+    buf->imported = vx_true_e;
+
+    /* One fd and offset per exported handle entry, channel by channel */
+    for (uint8_t j=0; j < buf->num_channels && VX_SUCCESS == status; j++) {
+        vx_reference ref = vxGetObjectArrayItem(buf->arr, j);
+
+        status = tivxReferenceExportHandle(ref, addr, size,
+                                           TIOVX_MODULES_MAX_REF_HANDLES,
+                                           &num_entries);
+        for (vx_uint32 i = 0; i < num_entries && VX_SUCCESS == status; i++) {
+            if (k >= num_fds) {
+                TIOVX_MODULE_ERROR("Too few fds for buffer\n");
+                status = VX_ERROR_INVALID_PARAMETERS;
+                break;
+            }
+
+            status = tivxMemTranslateFd((uint64_t)fds[k], offsets[k] + size[i],
+                                        &virt_addr, &phy_addr);
+            if (VX_SUCCESS != status) {
+                TIOVX_MODULE_ERROR("Mapping fd %d failed\n", fds[k]);
+                break;
+            }
+
+            addr[i] = (vx_uint8 *)virt_addr + offsets[k];
+            k++;
+        }
+
+        if (VX_SUCCESS == status) {
+            status = tivxReferenceImportHandle(ref, (const void **)addr,
+                                               size, num_entries);
+        }
+        vxReleaseReference(&ref);
+    }
+
+    if (VX_SUCCESS == status && k != num_fds) {
+        TIOVX_MODULE_ERROR("Buffer needs %d fds, got %d\n", k, num_fds);
+        status = VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    LOCK(buf_pool);
+    if (VX_SUCCESS != status) {
+        tiovx_modules_buf_unimport_mem(buf);
+        buf_pool->spareQ[buf_pool->spare_count] = buf;
+        buf_pool->spare_count++;
+        buf = NULL;
+    } else {
+        buf_pool->num_allocated++;
+        buf->held = vx_true_e;
+    }
+    UNLOCK(buf_pool);
+
+    if (NULL != buf && buf_pool->collect_stats) {
+        buf->hold_ts = tiovx_modules_get_time_us();
+    }
+
+    return buf;
+}
+
+vx_status tiovx_modules_unimport_buf(Buf *buf)
+{
+    vx_status status = VX_FAILURE;
+    BufPool *buf_pool = buf->pool;
+
+    if (vx_false_e == buf->imported) {
+        TIOVX_MODULE_ERROR("Buffer is not imported\n");
+        return status;
     }
 
+    /* A buffer still in the free queue or the graph would be owned twice */
+    if (vx_false_e == buf->held) {
+        TIOVX_MODULE_ERROR("Buffer is not held by the caller\n");
+        return status;
+    }
+
+    LOCK(buf_pool);
+    buf->held = vx_false_e;
+    status = tiovx_modules_buf_unimport_mem(buf);
+    buf_pool->spareQ[buf_pool->spare_count] = buf;
+    buf_pool->spare_count++;
+    buf_pool->num_allocated--;
+    UNLOCK(buf_pool);
+
     return status;
 }
 
@@ -259,19 +1293,86 @@ vx_status tiovx_modules_buf_swap_mem(Buf *buf1, Buf *buf2)
 
     if (buf1->pool->pad->num_channels != buf2->pool->pad->num_channels) {
         TIOVX_MODULE_ERROR("Num channels do not match\n");
+        return status;
     }
 
     for (uint8_t i=0; i < buf1->pool->pad->num_channels; i++) {
         vx_reference ref1 = vxGetObjectArrayItem(buf1->arr, i);
         vx_reference ref2 = vxGetObjectArrayItem(buf2->arr, i);
         status = tiovx_modules_reference_swap_mem(ref1, ref2);
+        vxReleaseReference(&ref1);
+        vxReleaseReference(&ref2);
         if(status != VX_SUCCESS)
         {
             TIOVX_MODULE_ERROR("Failed with staus %d\n", status);
             return status;
         }
-        vxReleaseReference(&ref1);
-        vxReleaseReference(&ref2);
+    }
+
+    return status;
+}
+
+void tiovx_modules_free_bufpool(BufPool *buf_pool)
+{
+    vx_bool has_mem;
+
+    if (NULL != buf_pool->bufs)
+    {
+        for(vx_int32 i = 0; i < buf_pool->max_bufq_depth ; i++) {
+            if (NULL == buf_pool->bufs[i].arr) {
+                continue;
+            }
+
+            has_mem = vx_true_e;
+            for (vx_int32 j = 0; j < buf_pool->spare_count; j++) {
+                if (buf_pool->spareQ[j] == &buf_pool->bufs[i]) {
+                    has_mem = vx_false_e;
+                    break;
+                }
+            }
+            if (has_mem) {
+                tiovx_modules_buf_free_mem(&buf_pool->bufs[i]);
+            }
+
+            vxReleaseReference(&buf_pool->bufs[i].handle);
+            vxReleaseObjectArray(&buf_pool->bufs[i].arr);
+        }
+    }
+
+    if (buf_pool->lock_free)
+    {
+        tiovx_modules_buf_ring_deinit(&buf_pool->free_ring);
+        tiovx_modules_buf_ring_deinit(&buf_pool->enqueued_ring);
+    }
+
+    pthread_mutex_destroy(&buf_pool->lock);
+    sem_destroy(&buf_pool->sem);
+
+    free(buf_pool->bufs);
+    free(buf_pool->freeQ);
+    free(buf_pool->spareQ);
+    free(buf_pool->enqueuedQ);
+    free(buf_pool->pendingQ);
+    free(buf_pool->ref_list);
+    free(buf_pool);
+}
+
+static vx_status tiovx_modules_fill_bufpool(BufPool *buf_pool)
+{
+    vx_status status = VX_SUCCESS;
+    Buf *buf = NULL;
+
+    for(vx_int32 i = 0; i < buf_pool->bufq_depth; i++)
+    {
+        buf = tiovx_modules_grow_bufpool(buf_pool);
+        if (NULL == buf)
+        {
+            TIOVX_MODULE_ERROR("Memory alloc failed\n");
+            status = VX_ERROR_NO_MEMORY;
+            break;
+        }
+
+        tiovx_modules_release_buf(buf);
     }
 
     return status;
@@ -280,17 +1381,84 @@ vx_status tiovx_modules_buf_swap_mem(Buf *buf1, Buf *buf2)
 BufPool* tiovx_modules_allocate_bufpool(Pad *pad)
 {
     vx_status status = VX_FAILURE;
-    BufPool* buf_pool = (BufPool *)malloc(sizeof(BufPool));
+    BufPool* buf_pool = (BufPool *)calloc(1, sizeof(BufPool));
+    vx_int32 max_bufq_depth = pad->bufq_depth;
+
+    if (NULL == buf_pool)
+    {
+        TIOVX_MODULE_ERROR("Bufpool alloc failed\n");
+        return NULL;
+    }
+
+    if (pad->max_bufq_depth > pad->bufq_depth)
+    {
+        max_bufq_depth = pad->max_bufq_depth;
+    }
 
     buf_pool->pad = pad;
     buf_pool->bufq_depth = pad->bufq_depth;
+    buf_pool->max_bufq_depth = max_bufq_depth;
+    buf_pool->num_allocated = 0;
     buf_pool->free_count = 0;
+    buf_pool->spare_count = 0;
+    buf_pool->idle_count = 0;
     buf_pool->enqueue_head = 0;
     buf_pool->enqueue_tail = 0;
+    buf_pool->lock_free = pad->lock_free;
+    buf_pool->import_mem = pad->import_mem;
+    buf_pool->num_waiters = 0;
+    buf_pool->drop_policy = pad->drop_policy;
+    buf_pool->max_queued = (pad->max_queued > 0 &&
+                            pad->max_queued < max_bufq_depth) ?
+                           pad->max_queued : max_bufq_depth;
+    /* By default DROP_OLDEST holds every buffer the graph has no room for */
+    buf_pool->max_pending = 1;
+    if (TIOVX_MODULES_DROP_OLDEST == pad->drop_policy) {
+        buf_pool->max_pending = (pad->max_pending > 0) ?
+                                pad->max_pending :
+                                max_bufq_depth - buf_pool->max_queued;
+        if (buf_pool->max_pending > max_bufq_depth) {
+            buf_pool->max_pending = max_bufq_depth;
+        } else if (buf_pool->max_pending < 1) {
+            buf_pool->max_pending = 1;
+        }
+    }
+    buf_pool->collect_stats = pad->node->graph->collect_pad_stats;
+    buf_pool->stats.start_ts = tiovx_modules_get_time_us();
     pthread_mutex_init(&buf_pool->lock, NULL);
     sem_init(&buf_pool->sem, 0, 0);
 
-    for(uint8_t i = 0; i < pad->bufq_depth ; i++)
+    buf_pool->bufs = (Buf *)calloc(max_bufq_depth, sizeof(Buf));
+    buf_pool->freeQ = (Buf **)calloc(max_bufq_depth, sizeof(Buf *));
+    buf_pool->spareQ = (Buf **)calloc(max_bufq_depth, sizeof(Buf *));
+    buf_pool->enqueuedQ = (Buf **)calloc(max_bufq_depth + 1, sizeof(Buf *));
+    buf_pool->pendingQ = (Buf **)calloc(max_bufq_depth, sizeof(Buf *));
+    buf_pool->ref_list = (vx_reference *)calloc(max_bufq_depth,
+                                                sizeof(vx_reference));
+    if (NULL == buf_pool->bufs || NULL == buf_pool->freeQ ||
+        NULL == buf_pool->spareQ || NULL == buf_pool->enqueuedQ ||
+        NULL == buf_pool->pendingQ || NULL == buf_pool->ref_list)
+    {
+        TIOVX_MODULE_ERROR("Bufpool alloc failed\n");
+        goto err;
+    }
+
+    if (buf_pool->lock_free)
+    {
+        status = tiovx_modules_buf_ring_init(&buf_pool->free_ring,
+                                             max_bufq_depth);
+        if (VX_SUCCESS == status)
+        {
+            status = tiovx_modules_buf_ring_init(&buf_pool->enqueued_ring,
+                                                 max_bufq_depth);
+        }
+        if (VX_SUCCESS != status)
+        {
+            goto err;
+        }
+    }
+
+    for(vx_int32 i = 0; i < max_bufq_depth ; i++)
     {
 
         buf_pool->bufs[i].arr = vxCreateObjectArray(
@@ -319,33 +1487,31 @@ BufPool* tiovx_modules_allocate_bufpool(Pad *pad)
             buf_pool->ref_list[i] = (vx_reference)buf_pool->bufs[i].handle;
         }
 
-        for (uint8_t j=0; j < pad->num_channels; j++) {
-            vx_reference ref = vxGetObjectArrayItem(buf_pool->bufs[i].arr, j);
-            status = tiovx_modules_reference_alloc_mem(ref);
-            if(status != VX_SUCCESS)
-            {
-                TIOVX_MODULE_ERROR("Memory alloc failed\n");
-                goto err;
-            }
-            vxReleaseReference(&ref);
-        }
+    }
+
+    /* Buffers get memory when the pool is filled or grows, lowest index first */
+    for(vx_int32 i = max_bufq_depth - 1; i >= 0; i--)
+    {
+        buf_pool->spareQ[buf_pool->spare_count] = &buf_pool->bufs[i];
+        buf_pool->spare_count++;
+    }
 
-        tiovx_modules_release_buf(&buf_pool->bufs[i]);
+    /* With a memory arena the pool is filled once the arena is created */
+    if (vx_false_e == pad->node->graph->use_mem_arena &&
+        vx_false_e == pad->import_mem)
+    {
+        status = tiovx_modules_fill_bufpool(buf_pool);
+        if(status != VX_SUCCESS)
+        {
+            goto err;
+        }
     }
 
     return buf_pool;
 
 err:
-    free(buf_pool);
-    return NULL;
-}
-
-void tiovx_modules_free_bufpool(BufPool *buf_pool)
-{
-    for(uint8_t i = 0; i < buf_pool->bufq_depth ; i++) {
-        vxReleaseReference(&buf_pool->bufs[i].handle);
-        vxReleaseObjectArray(&buf_pool->bufs[i].arr);
-    }
+    tiovx_modules_free_bufpool(buf_pool);
+    return NULL;
 }
 
 vx_bool tiovx_modules_compare_images(vx_image image1, vx_image image2)
@@ -702,11 +1868,20 @@ vx_status tiovx_modules_add_to_graph_params(Pad *pad)
                                                     graph->tiovx_graph,
                                                     node->tiovx_node,
                                                     pad->node_parameter_index);
+    if (graph->num_graph_params == graph->max_graph_params) {
+        status = tiovx_modules_grow_table((void **)&graph->graph_params_list,
+                                          &graph->max_graph_params,
+                                          sizeof(vx_graph_parameter_queue_params_t));
+        if (VX_SUCCESS != status) {
+            return status;
+        }
+    }
+
     pad->graph_parameter_index = graph->num_graph_params;
     graph->graph_params_list[graph->num_graph_params].graph_parameter_index =
                                                         graph->num_graph_params;
     graph->graph_params_list[graph->num_graph_params].refs_list_size =
-                                                               pool->bufq_depth;
+                                                           pool->max_bufq_depth;
     graph->graph_params_list[graph->num_graph_params].refs_list =
                                                                pool->ref_list;
     graph->num_graph_params++;
@@ -716,6 +1891,496 @@ vx_status tiovx_modules_add_to_graph_params(Pad *pad)
     return status;
 }
 
+/* Iterate over the buffer pools of all floating pads, start with *iter = 0 */
+static BufPool* tiovx_modules_next_bufpool(GraphObj *graph, vx_int32 *iter)
+{
+    vx_int32 pads_per_node = TIOVX_MODULES_MAX_NODE_INPUTS +
+                             TIOVX_MODULES_MAX_NODE_OUTPUTS;
+    NodeObj *node = NULL;
+    Pad *pad = NULL;
+    vx_int32 idx;
+
+    while (*iter < graph->num_nodes * pads_per_node) {
+        node = graph->node_list[*iter / pads_per_node];
+        idx = *iter % pads_per_node;
+        pad = NULL;
+        (*iter)++;
+
+        if (idx < node->num_inputs) {
+            pad = &node->sinks[idx];
+        } else if (idx >= TIOVX_MODULES_MAX_NODE_INPUTS &&
+                   idx - TIOVX_MODULES_MAX_NODE_INPUTS < node->num_outputs) {
+            pad = &node->srcs[idx - TIOVX_MODULES_MAX_NODE_INPUTS];
+        }
+
+        if (NULL != pad && NULL == pad->peer_pad && NULL != pad->buf_pool) {
+            return pad->buf_pool;
+        }
+    }
+
+    return NULL;
+}
+
+static vx_status tiovx_modules_get_buf_mem_size(Buf *buf, vx_uint64 *size,
+                                                vx_int32 *num_entries)
+{
+    vx_status status = VX_FAILURE;
+    void *addr[TIOVX_MODULES_MAX_REF_HANDLES] = {NULL};
+    vx_uint32 entry_size[TIOVX_MODULES_MAX_REF_HANDLES], entries;
+
+    *size = 0;
+    *num_entries = 0;
+
+    for (uint8_t j=0; j < buf->num_channels; j++) {
+        vx_reference ref = vxGetObjectArrayItem(buf->arr, j);
+        status = tivxReferenceExportHandle(ref, addr, entry_size,
+                                           TIOVX_MODULES_MAX_REF_HANDLES,
+                                           &entries);
+        vxReleaseReference(&ref);
+        if(status != VX_SUCCESS)
+        {
+            TIOVX_MODULE_ERROR("Error exporting handles\n");
+            return status;
+        }
+
+        for (vx_uint32 k = 0; k < entries; k++) {
+            *size += ALIGN_UP(entry_size[k], TIOVX_MODULES_MEM_ARENA_ALIGN);
+        }
+        *num_entries += entries;
+    }
+
+    return status;
+}
+
+/*
+ * Size the arena for every pool at its max_bufq_depth, allocate it in one
+ * go and then fill the pools from it.
+ */
+static vx_status tiovx_modules_create_mem_arena(GraphObj *graph)
+{
+    vx_status status = VX_SUCCESS;
+    MemArena *arena = &graph->mem_arena;
+    BufPool *buf_pool = NULL;
+    vx_uint64 total_size = 0, buf_size;
+    vx_int32 total_entries = 0, buf_entries;
+    vx_int32 iter = 0;
+
+    while (NULL != (buf_pool = tiovx_modules_next_bufpool(graph, &iter))) {
+        if (buf_pool->import_mem) {
+            continue;
+        }
+
+        status = tiovx_modules_get_buf_mem_size(&buf_pool->bufs[0],
+                                                &buf_size, &buf_entries);
+        if (VX_SUCCESS != status) {
+            return status;
+        }
+        total_size += buf_size * buf_pool->max_bufq_depth;
+        total_entries += buf_entries * buf_pool->max_bufq_depth;
+    }
+
+    if (0 == total_size) {
+        return status;
+    }
+
+    arena->free_list = (MemArenaExtent *)malloc((total_entries + 1) *
+                                                sizeof(MemArenaExtent));
+    arena->base = (vx_uint8 *)tivxMemAlloc(total_size, TIVX_MEM_EXTERNAL);
+    if (NULL == arena->base || NULL == arena->free_list) {
+        TIOVX_MODULE_ERROR("Memory arena alloc of %lu bytes failed\n",
+                           (unsigned long)total_size);
+        free(arena->free_list);
+        arena->free_list = NULL;
+        arena->base = NULL;
+        return VX_ERROR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&arena->lock, NULL);
+    arena->size = total_size;
+    arena->used_bytes = 0;
+    arena->peak_bytes = 0;
+    arena->num_allocs = 0;
+    arena->free_list[0].offset = 0;
+    arena->free_list[0].size = total_size;
+    arena->num_free = 1;
+    /* One live allocation per buffer entry plus the trailing free region */
+    arena->max_free = total_entries + 1;
+
+    iter = 0;
+    while (NULL != (buf_pool = tiovx_modules_next_bufpool(graph, &iter))) {
+        if (buf_pool->import_mem) {
+            continue;
+        }
+
+        status = tiovx_modules_fill_bufpool(buf_pool);
+        if (VX_SUCCESS != status) {
+            return status;
+        }
+    }
+
+    return status;
+}
+
+static void tiovx_modules_destroy_mem_arena(GraphObj *graph)
+{
+    MemArena *arena = &graph->mem_arena;
+
+    if (NULL == arena->base) {
+        return;
+    }
+
+    if (0 != arena->num_allocs) {
+        TIOVX_MODULE_ERROR("%d slices still in use\n", arena->num_allocs);
+    }
+
+    tivxMemFree(arena->base, arena->size, TIVX_MEM_EXTERNAL);
+    free(arena->free_list);
+    pthread_mutex_destroy(&arena->lock);
+    CLR(arena);
+}
+
+vx_status tiovx_modules_get_mem_stats(GraphObj *graph, MemStats *stats)
+{
+    vx_status status = VX_SUCCESS;
+    MemArena *arena = &graph->mem_arena;
+    BufPool *buf_pool = NULL;
+    vx_int32 iter = 0;
+
+    CLR(stats);
+
+    while (NULL != (buf_pool = tiovx_modules_next_bufpool(graph, &iter))) {
+        stats->used_bytes += buf_pool->mem_size;
+    }
+
+    if (NULL == arena->base) {
+        return status;
+    }
+
+    pthread_mutex_lock(&arena->lock);
+
+    stats->total_bytes = arena->size;
+    stats->peak_bytes = arena->peak_bytes;
+    stats->num_allocs = arena->num_allocs;
+    for (vx_int32 i = 0; i < arena->num_free; i++) {
+        stats->free_bytes += arena->free_list[i].size;
+        if (arena->free_list[i].size > stats->largest_free_bytes) {
+            stats->largest_free_bytes = arena->free_list[i].size;
+        }
+    }
+
+    pthread_mutex_unlock(&arena->lock);
+
+    if (stats->free_bytes > 0) {
+        stats->fragmentation = 1.0f - ((vx_float32)stats->largest_free_bytes /
+                                       (vx_float32)stats->free_bytes);
+    }
+
+    return status;
+}
+
+void tiovx_modules_print_mem_stats(GraphObj *graph)
+{
+    MemStats stats;
+    BufPool *buf_pool = NULL;
+    Pad *pad = NULL;
+    vx_int32 iter = 0;
+
+    tiovx_modules_get_mem_stats(graph, &stats);
+
+    printf("================================================\n\n");
+
+    while (NULL != (buf_pool = tiovx_modules_next_bufpool(graph, &iter))) {
+        pad = buf_pool->pad;
+        printf("%s %s[%d] - %d/%d buffers, %0.3f MB\n",
+               pad->node->name,
+               (SINK == pad->direction) ? "sink" : "src",
+               pad->pad_index,
+               buf_pool->num_allocated,
+               buf_pool->max_bufq_depth,
+               buf_pool->mem_size / (1024.0 * 1024.0));
+    }
+
+    printf("\n");
+    printf("Used - %0.3f MB\n", stats.used_bytes / (1024.0 * 1024.0));
+
+    if (stats.total_bytes > 0) {
+        printf("Arena - %0.3f MB, peak %0.3f MB, fragmentation %0.2f\n",
+               stats.total_bytes / (1024.0 * 1024.0),
+               stats.peak_bytes / (1024.0 * 1024.0),
+               stats.fragmentation);
+    }
+
+    printf("================================================\n\n");
+}
+
+vx_status tiovx_modules_get_pad_stats(Pad *pad, PadStats *stats)
+{
+    vx_status status = VX_FAILURE;
+    BufPool *buf_pool = pad->buf_pool;
+    BufPoolStats *pool_stats = NULL;
+    vx_uint64 num_enqueues;
+
+    CLR(stats);
+
+    if (NULL == buf_pool || vx_false_e == buf_pool->collect_stats) {
+        TIOVX_MODULE_ERROR("Pad statistics not collected\n");
+        return status;
+    }
+
+    pool_stats = &buf_pool->stats;
+
+    stats->graph_p50_us = tiovx_modules_hist_percentile(
+                                        &pool_stats->graph_latency, 0.50);
+    stats->graph_p95_us = tiovx_modules_hist_percentile(
+                                        &pool_stats->graph_latency, 0.95);
+    stats->graph_p99_us = tiovx_modules_hist_percentile(
+                                        &pool_stats->graph_latency, 0.99);
+    stats->graph_max_us = __atomic_load_n(&pool_stats->graph_latency.max_us,
+                                          __ATOMIC_RELAXED);
+    stats->hold_p50_us = tiovx_modules_hist_percentile(
+                                        &pool_stats->hold_latency, 0.50);
+    stats->hold_p95_us = tiovx_modules_hist_percentile(
+                                        &pool_stats->hold_latency, 0.95);
+    stats->hold_p99_us = tiovx_modules_hist_percentile(
+                                        &pool_stats->hold_latency, 0.99);
+
+    stats->num_dequeued = __atomic_load_n(&pool_stats->graph_latency.count,
+                                          __ATOMIC_RELAXED);
+    stats->queue_depth = __atomic_load_n(&pool_stats->queue_depth,
+                                         __ATOMIC_RELAXED);
+    stats->num_enqueued = stats->num_dequeued + stats->queue_depth;
+    stats->max_queue_depth = __atomic_load_n(&pool_stats->max_queue_depth,
+                                             __ATOMIC_RELAXED);
+
+    num_enqueues = __atomic_load_n(&pool_stats->num_enqueues,
+                                   __ATOMIC_RELAXED);
+    if (num_enqueues > 0) {
+        stats->avg_queue_depth = (vx_float32)__atomic_load_n(
+                                        &pool_stats->queue_depth_sum,
+                                        __ATOMIC_RELAXED) / num_enqueues;
+    }
+
+    stats->num_underruns = __atomic_load_n(&pool_stats->num_underruns,
+                                           __ATOMIC_RELAXED);
+    stats->num_acquire_waits = __atomic_load_n(&pool_stats->num_acquire_waits,
+                                               __ATOMIC_RELAXED);
+    stats->num_acquire_fails = __atomic_load_n(&pool_stats->num_acquire_fails,
+                                               __ATOMIC_RELAXED);
+    stats->num_dequeue_empty = __atomic_load_n(&pool_stats->num_dequeue_empty,
+                                               __ATOMIC_RELAXED);
+    stats->num_dropped = __atomic_load_n(&buf_pool->num_dropped,
+                                         __ATOMIC_RELAXED);
+    stats->max_allocated = __atomic_load_n(&pool_stats->max_allocated,
+                                           __ATOMIC_RELAXED);
+    stats->elapsed_us = tiovx_modules_get_time_us() - pool_stats->start_ts;
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+void tiovx_modules_reset_pad_stats(Pad *pad)
+{
+    BufPool *buf_pool = pad->buf_pool;
+    vx_int32 queue_depth;
+
+    if (NULL == buf_pool) {
+        return;
+    }
+
+    /* Buffers in the graph are still counted when they come back */
+    queue_depth = __atomic_load_n(&buf_pool->stats.queue_depth,
+                                  __ATOMIC_RELAXED);
+    CLR(&buf_pool->stats);
+    buf_pool->stats.queue_depth = queue_depth;
+    buf_pool->stats.max_allocated = __atomic_load_n(&buf_pool->num_allocated,
+                                                    __ATOMIC_RELAXED);
+    buf_pool->stats.start_ts = tiovx_modules_get_time_us();
+}
+
+void tiovx_modules_print_pad_stats(GraphObj *graph)
+{
+    PadStats stats;
+    BufPool *buf_pool = NULL;
+    Pad *pad = NULL;
+    vx_int32 iter = 0;
+
+    printf("================================================\n\n");
+
+    while (NULL != (buf_pool = tiovx_modules_next_bufpool(graph, &iter))) {
+        pad = buf_pool->pad;
+        if (VX_SUCCESS != tiovx_modules_get_pad_stats(pad, &stats)) {
+            continue;
+        }
+
+        printf("%s %s[%d]\n",
+               pad->node->name,
+               (SINK == pad->direction) ? "sink" : "src",
+               pad->pad_index);
+        printf("    latency p50/p95/p99 - %0.3f/%0.3f/%0.3f ms, "
+               "max %0.3f ms\n",
+               stats.graph_p50_us / 1000.0, stats.graph_p95_us / 1000.0,
+               stats.graph_p99_us / 1000.0, stats.graph_max_us / 1000.0);
+        printf("    held p50/p95/p99 - %0.3f/%0.3f/%0.3f ms\n",
+               stats.hold_p50_us / 1000.0, stats.hold_p95_us / 1000.0,
+               stats.hold_p99_us / 1000.0);
+        printf("    queue depth avg %0.2f, max %d\n",
+               stats.avg_queue_depth, stats.max_queue_depth);
+        printf("    underruns %" PRIu64 ", acquire waits %" PRIu64
+               ", dequeue empty %" PRIu64 ", dropped %" PRIu64 "\n",
+               stats.num_underruns, stats.num_acquire_waits,
+               stats.num_dequeue_empty, stats.num_dropped);
+    }
+
+    printf("================================================\n\n");
+}
+
+vx_int32 tiovx_modules_recommend_bufq_depths(GraphObj *graph,
+                                             BufqDepthHint *hints,
+                                             vx_int32 max_hints)
+{
+    PadStats stats;
+    BufPool *buf_pool = NULL;
+    BufqDepthHint *hint = NULL;
+    Pad *pad = NULL;
+    vx_uint64 num_stalls;
+    vx_int32 iter = 0, num_hints = 0;
+
+    while (num_hints < max_hints &&
+           NULL != (buf_pool = tiovx_modules_next_bufpool(graph, &iter))) {
+        if (buf_pool->import_mem ||
+            VX_SUCCESS != tiovx_modules_get_pad_stats(buf_pool->pad, &stats)) {
+            continue;
+        }
+
+        hint = &hints[num_hints];
+        hint->pad = buf_pool->pad;
+        hint->bufq_depth = buf_pool->bufq_depth;
+        hint->recommended = buf_pool->bufq_depth;
+        hint->stall_ratio = 0;
+        num_hints++;
+
+        if (0 == stats.num_enqueued) {
+            continue;
+        }
+
+        /*
+         * A stall is the producer of the pad waiting for a buffer. Graph
+         * inputs are produced by the app, so only acquire waits count. An
+         * empty queue on a graph output means the graph had nowhere to
+         * write, an empty queue on an input only means the source is slower.
+         */
+        num_stalls = stats.num_acquire_waits;
+        if (SRC == buf_pool->pad->direction) {
+            num_stalls += stats.num_underruns;
+        }
+        hint->stall_ratio = (vx_float32)num_stalls / stats.num_enqueued;
+
+        if (hint->stall_ratio > TIOVX_MODULES_TUNE_STALL_RATIO) {
+            hint->recommended = ((stats.max_allocated > buf_pool->bufq_depth) ?
+                                 stats.max_allocated : buf_pool->bufq_depth) + 1;
+        } else if (stats.max_allocated > buf_pool->bufq_depth) {
+            /* Pool had to grow, start at the size it settled on */
+            hint->recommended = stats.max_allocated;
+        } else if (stats.max_queue_depth + 1 < buf_pool->bufq_depth) {
+            /* Buffers never used, one more than the graph held is enough */
+            hint->recommended = stats.max_queue_depth + 1;
+        }
+
+        /* A pad set up to grow is not taken past the limit it was given */
+        pad = buf_pool->pad;
+        if (pad->max_bufq_depth > pad->bufq_depth &&
+            hint->recommended > pad->max_bufq_depth) {
+            hint->recommended = pad->max_bufq_depth;
+        }
+    }
+
+    return num_hints;
+}
+
+vx_status tiovx_modules_save_bufq_depths(GraphObj *graph, const char *name,
+                                         FILE *fp)
+{
+    BufqDepthHint hints[graph->num_graph_params + 1];
+    vx_int32 num_hints;
+    Pad *pad = NULL;
+
+    num_hints = tiovx_modules_recommend_bufq_depths(graph, hints,
+                                                    graph->num_graph_params);
+
+    for (vx_int32 i = 0; i < num_hints; i++) {
+        pad = hints[i].pad;
+        fprintf(fp, "%s %d %d %s %d %d # %s %d -> %d, stalls %0.4f\n",
+                name, pad->node->node_index, pad->node->node_type,
+                (SINK == pad->direction) ? "sink" : "src", pad->pad_index,
+                hints[i].recommended, pad->node->name, hints[i].bufq_depth,
+                hints[i].recommended, hints[i].stall_ratio);
+    }
+
+    return (ferror(fp)) ? VX_FAILURE : VX_SUCCESS;
+}
+
+vx_status tiovx_modules_load_bufq_depths(GraphObj *graph, const char *name,
+                                         FILE *fp)
+{
+    vx_status status = VX_SUCCESS;
+    char line[256], graph_name[64], direction[8];
+    vx_int32 node_index, node_type, pad_index, bufq_depth;
+    NodeObj *node = NULL;
+    Pad *pad = NULL;
+
+    rewind(fp);
+
+    while (NULL != fgets(line, sizeof(line), fp)) {
+        if ('#' == line[0] ||
+            6 != sscanf(line, "%63s %d %d %7s %d %d", graph_name, &node_index,
+                        &node_type, direction, &pad_index, &bufq_depth) ||
+            0 != strcmp(graph_name, name)) {
+            continue;
+        }
+
+        /* Depths only apply to the graph they were measured on */
+        if (node_index < 0 || node_index >= graph->num_nodes ||
+            graph->node_list[node_index]->node_type != node_type) {
+            TIOVX_MODULE_ERROR("Buffer depths of %s do not match the graph\n",
+                               name);
+            status = VX_FAILURE;
+            break;
+        }
+
+        node = graph->node_list[node_index];
+        if (0 == strcmp(direction, "sink") && pad_index < node->num_inputs) {
+            pad = &node->sinks[pad_index];
+        } else if (0 == strcmp(direction, "src") &&
+                   pad_index < node->num_outputs) {
+            pad = &node->srcs[pad_index];
+        } else {
+            TIOVX_MODULE_ERROR("Invalid pad %s[%d] of %s\n", direction,
+                               pad_index, node->name);
+            status = VX_FAILURE;
+            break;
+        }
+
+        if (bufq_depth < 1) {
+            TIOVX_MODULE_ERROR("Invalid buffer depth %d\n", bufq_depth);
+            status = VX_FAILURE;
+            break;
+        }
+
+        if (pad->max_bufq_depth > pad->bufq_depth &&
+            bufq_depth > pad->max_bufq_depth) {
+            TIOVX_MODULE_PRINTF("Buffer depth %d of %s %s[%d] limited to %d\n",
+                                bufq_depth, node->name, direction, pad_index,
+                                pad->max_bufq_depth);
+            bufq_depth = pad->max_bufq_depth;
+        }
+
+        pad->bufq_depth = bufq_depth;
+    }
+
+    return status;
+}
+
 void tiovx_modules_modify_node_names(GraphObj *graph)
 {
     vx_bool modified[graph->num_nodes];
@@ -724,7 +2389,7 @@ void tiovx_modules_modify_node_names(GraphObj *graph)
         modified[i] = vx_false_e;
     }
 
-    for (uint8_t i = 0; i < graph->num_nodes; i++) {
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
         uint8_t node_count = 0;
         vx_char i_node_name[VX_MAX_REFERENCE_NAME - 3];
 
@@ -732,13 +2397,13 @@ void tiovx_modules_modify_node_names(GraphObj *graph)
             continue;
         }
 
-        sprintf(i_node_name, graph->node_list[i].name);
+        sprintf(i_node_name, graph->node_list[i]->name);
 
-        for(uint8_t j = i+1; j < graph->num_nodes; j++) {
+        for(vx_int32 j = i+1; j < graph->num_nodes; j++) {
             vx_char j_node_name[VX_MAX_REFERENCE_NAME - 3];
-            sprintf(j_node_name, graph->node_list[j].name);
+            sprintf(j_node_name, graph->node_list[j]->name);
             if(0 == strcmp(i_node_name, j_node_name)) {
-                sprintf(graph->node_list[j].name,
+                sprintf(graph->node_list[j]->name,
                         "%s_%02d",
                         j_node_name,
                         ++node_count);
@@ -747,28 +2412,170 @@ void tiovx_modules_modify_node_names(GraphObj *graph)
         }
 
         if(node_count > 0) {
-            sprintf(graph->node_list[i].name, "%s_00", i_node_name);
+            sprintf(graph->node_list[i]->name, "%s_00", i_node_name);
         }
 
         modified[i] = vx_true_e;
     }
 }
 
+/* Load node data and allocate the buffer pools of its floating pads */
+static vx_status tiovx_modules_load_node(NodeObj *node)
+{
+    vx_status status = VX_SUCCESS;
+    Pad *pad = NULL;
+    vx_uint64 start, now;
+
+    start = tiovx_modules_get_time_us();
+    if (NULL != node->cbs->load_node) {
+        status = node->cbs->load_node(node);
+    }
+    now = tiovx_modules_get_time_us();
+    node->startup_us[TIOVX_MODULES_PHASE_LOAD_NODES] = now - start;
+
+    if (VX_SUCCESS != status) {
+        TIOVX_MODULE_ERROR("Loading Node failed: %s\n", node->name);
+        return status;
+    }
+
+    for (vx_int32 j = 0; j < node->num_inputs + node->num_outputs; j++) {
+        pad = (j < node->num_inputs) ? &node->sinks[j] :
+                                       &node->srcs[j - node->num_inputs];
+
+        if (NULL == pad->peer_pad) {
+            pad->buf_pool = tiovx_modules_allocate_bufpool(pad);
+            if (NULL == pad->buf_pool) {
+                status = VX_ERROR_NO_MEMORY;
+                break;
+            }
+        }
+    }
+
+    node->startup_us[TIOVX_MODULES_PHASE_BUFPOOLS] =
+                                        tiovx_modules_get_time_us() - now;
+
+    return status;
+}
+
+static void* tiovx_modules_load_nodes_thread(void *arg)
+{
+    VerifyLoadCtx *ctx = (VerifyLoadCtx *)arg;
+    vx_status status;
+    vx_int32 i;
+
+    while ((i = __atomic_fetch_add(&ctx->next_node, 1, __ATOMIC_RELAXED)) <
+           ctx->graph->num_nodes) {
+        status = tiovx_modules_load_node(ctx->graph->node_list[i]);
+        if (VX_SUCCESS != status) {
+            __atomic_store_n(&ctx->status, status, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Nodes are independent until create_node, so their file loads and buffer
+ * pools are spread over a few threads, the caller included.
+ */
+static vx_status tiovx_modules_load_nodes(GraphObj *graph)
+{
+    VerifyLoadCtx ctx;
+    pthread_t threads[TIOVX_MODULES_MAX_VERIFY_THREADS];
+    vx_int32 num_threads = graph->num_verify_threads;
+    vx_int32 num_started = 0;
+
+    ctx.graph = graph;
+    ctx.next_node = 0;
+    ctx.status = VX_SUCCESS;
+
+    if (num_threads <= 0) {
+        num_threads = (vx_int32)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (num_threads > TIOVX_MODULES_MAX_VERIFY_THREADS) {
+        num_threads = TIOVX_MODULES_MAX_VERIFY_THREADS;
+    }
+    if (num_threads > graph->num_nodes) {
+        num_threads = graph->num_nodes;
+    }
+
+    for (vx_int32 i = 1; i < num_threads; i++) {
+        if (0 != pthread_create(&threads[num_started], NULL,
+                                tiovx_modules_load_nodes_thread, &ctx)) {
+            break;
+        }
+        num_started++;
+    }
+
+    tiovx_modules_load_nodes_thread(&ctx);
+
+    for (vx_int32 i = 0; i < num_started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    return ctx.status;
+}
+
+/*
+ * Nodes load and allocate their pools concurrently, so the elapsed time is
+ * split between the two phases by the share of the work each took.
+ */
+static void tiovx_modules_split_load_time(GraphObj *graph, vx_uint64 elapsed_us)
+{
+    vx_uint64 load_us = 0, bufpools_us = 0;
+    NodeObj *node = NULL;
+
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
+        load_us += node->startup_us[TIOVX_MODULES_PHASE_LOAD_NODES];
+        bufpools_us += node->startup_us[TIOVX_MODULES_PHASE_BUFPOOLS];
+    }
+
+    if (load_us + bufpools_us > 0) {
+        bufpools_us = elapsed_us * bufpools_us / (load_us + bufpools_us);
+    }
+
+    graph->startup_us[TIOVX_MODULES_PHASE_LOAD_NODES] = elapsed_us - bufpools_us;
+    graph->startup_us[TIOVX_MODULES_PHASE_BUFPOOLS] = bufpools_us;
+}
+
 vx_status tiovx_modules_verify_graph(GraphObj *graph)
 {
     vx_status status = VX_FAILURE;
     NodeObj *node = NULL;
     Pad *pad = NULL;
+    vx_uint64 start, now;
 
-    for (uint8_t i = 0; i < graph->num_nodes; i++) {
-        node = &graph->node_list[i];
+    start = tiovx_modules_get_time_us();
+    status = tiovx_modules_load_nodes(graph);
+    tiovx_modules_split_load_time(graph, tiovx_modules_get_time_us() - start);
+    if(status != VX_SUCCESS)
+    {
+        TIOVX_MODULE_ERROR("Loading Nodes failed\n");
+        return status;
+    }
+
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
+
+        start = tiovx_modules_get_time_us();
         status = node->cbs->create_node(node);
+        now = tiovx_modules_get_time_us();
+        node->startup_us[TIOVX_MODULES_PHASE_CREATE_NODES] = now - start;
+        graph->startup_us[TIOVX_MODULES_PHASE_CREATE_NODES] +=
+                            node->startup_us[TIOVX_MODULES_PHASE_CREATE_NODES];
+
+        if(status != VX_SUCCESS)
+        {
+            TIOVX_MODULE_ERROR("Creating Node failed: %d\n", i);
+            return status;
+        }
 
+        /* Graph parameters are added in node order to keep their indices */
         for (uint8_t j = 0; j < node->num_inputs; j++) {
             pad = &node->sinks[j];
 
             if (NULL == pad->peer_pad) {
-                pad->buf_pool = tiovx_modules_allocate_bufpool(pad);
                 status = tiovx_modules_add_to_graph_params(pad);
             }
         }
@@ -777,23 +2584,61 @@ vx_status tiovx_modules_verify_graph(GraphObj *graph)
             pad = &node->srcs[j];
 
             if (NULL == pad->peer_pad) {
-                pad->buf_pool = tiovx_modules_allocate_bufpool(pad);
                 status = tiovx_modules_add_to_graph_params(pad);
             }
         }
 
+        graph->startup_us[TIOVX_MODULES_PHASE_BUFPOOLS] +=
+                                        tiovx_modules_get_time_us() - now;
+
+        if(status != VX_SUCCESS)
+        {
+            TIOVX_MODULE_ERROR("Adding graph parameters failed: %d\n", i);
+            return status;
+        }
+    }
+
+    start = tiovx_modules_get_time_us();
+
+    if (graph->use_mem_arena) {
+        status = tiovx_modules_create_mem_arena(graph);
         if(status != VX_SUCCESS)
         {
-            TIOVX_MODULE_ERROR("Creating Node failed: %d\n", i);
+            TIOVX_MODULE_ERROR("Creating memory arena failed\n");
             return status;
         }
     }
 
+    now = tiovx_modules_get_time_us();
+    graph->startup_us[TIOVX_MODULES_PHASE_MEM_ARENA] = now - start;
+    start = now;
+
     status = vxSetGraphScheduleConfig(graph->tiovx_graph,
                                       graph->schedule_mode,
                                       graph->num_graph_params,
                                       graph->graph_params_list);
 
+    if (graph->use_param_events) {
+        /* One extra value is reserved for the runtime stop event */
+        graph->event_base = __atomic_fetch_add(&g_event_base,
+                                               graph->num_graph_params + 1,
+                                               __ATOMIC_RELAXED);
+        for (vx_int32 i = 0; i < graph->num_graph_params; i++) {
+            status = vxRegisterEvent((vx_reference)graph->tiovx_graph,
+                                     VX_EVENT_GRAPH_PARAMETER_CONSUMED,
+                                     i, graph->event_base + i);
+            if(status != VX_SUCCESS)
+            {
+                TIOVX_MODULE_ERROR("Registering event failed: %d\n", i);
+                return status;
+            }
+        }
+    }
+
+    now = tiovx_modules_get_time_us();
+    graph->startup_us[TIOVX_MODULES_PHASE_SCHEDULE] = now - start;
+    start = now;
+
     status = vxVerifyGraph(graph->tiovx_graph);
     if(status != VX_SUCCESS)
     {
@@ -801,19 +2646,106 @@ vx_status tiovx_modules_verify_graph(GraphObj *graph)
         return status;
     }
 
-    for (uint8_t i = 0; i < graph->num_nodes; i++) {
-        node = &graph->node_list[i];
+    now = tiovx_modules_get_time_us();
+    graph->startup_us[TIOVX_MODULES_PHASE_VERIFY] = now - start;
+
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
 
         if (NULL != node->cbs->post_verify_graph) {
+            start = tiovx_modules_get_time_us();
             status = node->cbs->post_verify_graph(node);
+            node->startup_us[TIOVX_MODULES_PHASE_POST_VERIFY] =
+                                        tiovx_modules_get_time_us() - start;
+            graph->startup_us[TIOVX_MODULES_PHASE_POST_VERIFY] +=
+                            node->startup_us[TIOVX_MODULES_PHASE_POST_VERIFY];
         }
     }
 
     tiovx_modules_modify_node_names(graph);
 
+    graph->startup_end_us = tiovx_modules_get_time_us();
+    if (graph->print_startup_profile) {
+        tiovx_modules_print_startup_profile(graph);
+    }
+
     return status;
 }
 
+static const char *g_startup_phase_names[TIOVX_MODULES_NUM_PHASES] = {
+    "context", "init_nodes", "load_nodes", "create_nodes", "bufpools",
+    "mem_arena", "schedule", "verify", "post_verify"
+};
+
+void tiovx_modules_print_startup_profile(GraphObj *graph)
+{
+    NodeObj *node = NULL;
+    vx_uint64 total_us = graph->startup_end_us - graph->startup_begin_us;
+    vx_uint64 phases_us = 0;
+
+    printf("================================================\n\n");
+    printf("Startup - %0.3f ms\n", total_us / 1000.0);
+
+    for (vx_int32 i = 0; i < TIOVX_MODULES_NUM_PHASES; i++) {
+        printf("    %-12s - %0.3f ms\n", g_startup_phase_names[i],
+               graph->startup_us[i] / 1000.0);
+        phases_us += graph->startup_us[i];
+    }
+
+    /* Time the app spent between graph calls */
+    printf("    %-12s - %0.3f ms\n", "other",
+           (total_us > phases_us) ? (total_us - phases_us) / 1000.0 : 0);
+
+    printf("\n");
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
+        printf("%s - init %0.3f ms, load %0.3f ms, create %0.3f ms, "
+               "bufpools %0.3f ms, post verify %0.3f ms\n", node->name,
+               node->startup_us[TIOVX_MODULES_PHASE_INIT_NODES] / 1000.0,
+               node->startup_us[TIOVX_MODULES_PHASE_LOAD_NODES] / 1000.0,
+               node->startup_us[TIOVX_MODULES_PHASE_CREATE_NODES] / 1000.0,
+               node->startup_us[TIOVX_MODULES_PHASE_BUFPOOLS] / 1000.0,
+               node->startup_us[TIOVX_MODULES_PHASE_POST_VERIFY] / 1000.0);
+    }
+
+    printf("================================================\n\n");
+}
+
+vx_status tiovx_modules_write_startup_profile(GraphObj *graph,
+                                              const char *name, FILE *fp)
+{
+    NodeObj *node = NULL;
+
+    fprintf(fp, "{\"graph\":");
+    tiovx_modules_trace_write_string(fp, name);
+    fprintf(fp, ",\"total_us\":%" PRIu64 ",\"phases\":{",
+            graph->startup_end_us - graph->startup_begin_us);
+    for (vx_int32 i = 0; i < TIOVX_MODULES_NUM_PHASES; i++) {
+        fprintf(fp, "%s\"%s\":%" PRIu64, (0 == i) ? "" : ",",
+                g_startup_phase_names[i], graph->startup_us[i]);
+    }
+
+    fprintf(fp, "},\"nodes\":[");
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
+        fprintf(fp, "%s{\"name\":", (0 == i) ? "" : ",");
+        tiovx_modules_trace_write_string(fp, node->name);
+        fprintf(fp, ",\"type\":%d,\"init_us\":%" PRIu64
+                ",\"load_us\":%" PRIu64 ",\"create_us\":%" PRIu64
+                ",\"bufpools_us\":%" PRIu64 ",\"post_verify_us\":%" PRIu64,
+                node->node_type,
+                node->startup_us[TIOVX_MODULES_PHASE_INIT_NODES],
+                node->startup_us[TIOVX_MODULES_PHASE_LOAD_NODES],
+                node->startup_us[TIOVX_MODULES_PHASE_CREATE_NODES],
+                node->startup_us[TIOVX_MODULES_PHASE_BUFPOOLS],
+                node->startup_us[TIOVX_MODULES_PHASE_POST_VERIFY]);
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "]}");
+
+    return (ferror(fp)) ? VX_FAILURE : VX_SUCCESS;
+}
+
 vx_status tiovx_modules_export_graph(GraphObj *graph, char *path, char *prefix)
 {
     vx_status status = VX_FAILURE;
@@ -827,9 +2759,9 @@ NodeObj* tiovx_modules_get_node_by_name(GraphObj *graph, char *name)
 {
     NodeObj *node = NULL;
 
-    for (uint8_t i = 0; i < graph->num_nodes; i++) {
-        if(0 == strcmp(graph->node_list[i].name, name)) {
-            node = &graph->node_list[i];
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        if(0 == strcmp(graph->node_list[i]->name, name)) {
+            node = graph->node_list[i];
             break;
         }
     }
@@ -843,20 +2775,20 @@ void tiovx_modules_print_performance(GraphObj *graph)
 
     printf("================================================\n\n");
 
-    for (uint8_t i = 0; i < graph->num_nodes; i++) {
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
         vx_perf_t perf;
 
-        if((graph->node_list[i].node_type == TIOVX_TEE) ||
-           (graph->node_list[i].node_type == TIOVX_DELAY) ||
-           (graph->node_list[i].node_type == TIOVX_FAKESINK)) {
+        if((graph->node_list[i]->node_type == TIOVX_TEE) ||
+           (graph->node_list[i]->node_type == TIOVX_DELAY) ||
+           (graph->node_list[i]->node_type == TIOVX_FAKESINK)) {
             continue;
         }
 
-        vxQueryNode(graph->node_list[i].tiovx_node,
+        vxQueryNode(graph->node_list[i]->tiovx_node,
                     VX_NODE_PERFORMANCE,
                     &perf,
                     sizeof(perf));
-        printf("%s - %0.3f ms\n", graph->node_list[i].name, perf.avg/1000000.0);
+        printf("%s - %0.3f ms\n", graph->node_list[i]->name, perf.avg/1000000.0);
     }
 
     printf("\n");
@@ -869,80 +2801,528 @@ void tiovx_modules_print_performance(GraphObj *graph)
     printf("================================================\n\n");
 }
 
-vx_status tiovx_modules_enqueue_buf(Buf *buf)
+/* Buffers show as async spans per pad, from enqueue to dequeue */
+static void tiovx_modules_trace_bufs(BufPool *buf_pool, Buf **bufs,
+                                     vx_uint32 num_bufs, char phase)
 {
-    vx_status status = VX_FAILURE;
-    BufPool *buf_pool = buf->pool;
     Pad *pad = buf_pool->pad;
-    GraphObj *graph = pad->node->graph;
-    vx_reference *enqueue_list;
+    vx_uint64 now = tiovx_modules_trace_time();
+    char name[TIOVX_MODULES_TRACE_NAME_LEN];
 
-    LOCK(buf->pool);
+    snprintf(name, sizeof(name), "%s %s%d", pad->node->name,
+             (SINK == pad->direction) ? "sink" : "src", pad->pad_index);
+
+    for (vx_uint32 i = 0; i < num_bufs; i++) {
+        tiovx_modules_trace_event("buf", name, phase, now, 0,
+                                  (vx_uint64)(uintptr_t)bufs[i]);
+    }
+}
+
+/*
+ * Record the last run of every node that ran since the previous call. Only
+ * the latest run is known, runs in between are missed if the graph is
+ * dequeued less often than nodes run.
+ */
+static void tiovx_modules_trace_nodes(GraphObj *graph)
+{
+    NodeObj *node = NULL;
+    vx_perf_t perf;
+
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
+
+        if((node->node_type == TIOVX_TEE) ||
+           (node->node_type == TIOVX_DELAY) ||
+           (node->node_type == TIOVX_FAKESINK)) {
+            continue;
+        }
+
+        if (VX_SUCCESS != vxQueryNode(node->tiovx_node, VX_NODE_PERFORMANCE,
+                                      &perf, sizeof(perf))) {
+            continue;
+        }
+
+        if (perf.num == __atomic_exchange_n(&node->trace_num, perf.num,
+                                            __ATOMIC_RELAXED)) {
+            continue;
+        }
+
+        tiovx_modules_trace_track_event(&node->trace_track, "node",
+                                        node->name, perf.beg / 1000,
+                                        (perf.end - perf.beg) / 1000);
+    }
+}
+
+/*
+ * Hand buffers to the graph, all buffers must belong to one pool. Returns the
+ * number of buffers handed over, the rest stay with the caller.
+ */
+static vx_uint32 tiovx_modules_submit_bufs(Buf **bufs, vx_uint32 num_bufs)
+{
+    BufPool *buf_pool = NULL;
+    Pad *pad = NULL;
+    GraphObj *graph = NULL;
+    vx_int32 queue_size, num_queued;
+    vx_uint32 i;
+
+    if (0 == num_bufs) {
+        return 0;
+    }
+
+    buf_pool = bufs[0]->pool;
+    pad = buf_pool->pad;
+    graph = pad->node->graph;
+    queue_size = buf_pool->max_bufq_depth + 1;
+
+    vx_reference enqueue_list[num_bufs];
+
+    if (buf_pool->lock_free) {
+        /* The whole batch is rejected if it can't fit, as with the lock */
+        num_queued = tiovx_modules_buf_ring_count(&buf_pool->enqueued_ring);
+        if (num_queued + num_bufs > buf_pool->max_bufq_depth) {
+            TIOVX_MODULE_ERROR("Queue Full\n");
+            return 0;
+        }
+
+        /* Only a racing producer can fill the ring after the check */
+        for (i = 0; i < num_bufs; i++) {
+            if (vx_false_e ==
+                tiovx_modules_buf_ring_push(&buf_pool->enqueued_ring, bufs[i])) {
+                TIOVX_MODULE_ERROR("Queue Full\n");
+                break;
+            }
+        }
+        num_bufs = i;
+    } else {
+        LOCK(buf_pool);
+
+        num_queued = (buf_pool->enqueue_head - buf_pool->enqueue_tail +
+                      queue_size) % queue_size;
+        if (num_queued + num_bufs > buf_pool->max_bufq_depth) {
+            TIOVX_MODULE_ERROR("Queue Full\n");
+            UNLOCK(buf_pool);
+            return 0;
+        }
+
+        for (i = 0; i < num_bufs; i++) {
+            buf_pool->enqueuedQ[buf_pool->enqueue_head] = bufs[i];
+            buf_pool->enqueue_head = (buf_pool->enqueue_head + 1) % queue_size;
+        }
 
-    if (buf_pool->enqueue_tail ==
-                    (buf_pool->enqueue_head + 1) % (buf_pool->bufq_depth + 1)) {
-        TIOVX_MODULE_ERROR("Queue Full\n");
         UNLOCK(buf_pool);
-        return status;
     }
 
-    buf_pool->enqueuedQ[buf_pool->enqueue_head] = buf;
-    buf_pool->enqueue_head = (buf_pool->enqueue_head + 1) %
-                                                    (buf_pool->bufq_depth + 1);
+    for (i = 0; i < num_bufs; i++) {
+        if (pad->enqueue_arr)
+        {
+            enqueue_list[i] = (vx_reference)bufs[i]->arr;
+        }
+        else
+        {
+            enqueue_list[i] = bufs[i]->handle;
+        }
+    }
 
-    UNLOCK(buf->pool);
+    if (num_bufs > 0 && buf_pool->collect_stats) {
+        tiovx_modules_stats_enqueue(buf_pool, bufs, num_bufs);
+    }
 
-    if (pad->enqueue_arr)
-    {
-        enqueue_list = (vx_reference *)&buf->arr;
+    if (tiovx_modules_trace_enabled()) {
+        tiovx_modules_trace_bufs(buf_pool, bufs, num_bufs, 'b');
     }
-    else
-    {
-        enqueue_list = (vx_reference *)&buf->handle;
+
+    if (num_bufs > 0) {
+        vxGraphParameterEnqueueReadyRef(graph->tiovx_graph,
+                                        pad->graph_parameter_index,
+                                        enqueue_list, num_bufs);
     }
 
-    vxGraphParameterEnqueueReadyRef(graph->tiovx_graph,
-                                    pad->graph_parameter_index,
-                                    enqueue_list, 1);
+    return num_bufs;
+}
 
-    status = VX_SUCCESS;
+/* Buffers the graph did not take go back to the pool, so none is lost */
+static vx_status tiovx_modules_release_unsubmitted(Buf **bufs,
+                                                   vx_uint32 num_bufs,
+                                                   vx_uint32 num_submitted)
+{
+    for (vx_uint32 i = num_submitted; i < num_bufs; i++) {
+        tiovx_modules_release_buf(bufs[i]);
+    }
+
+    return (num_submitted == num_bufs) ? VX_SUCCESS : VX_FAILURE;
+}
+
+vx_status tiovx_modules_enqueue_bufs(Buf **bufs, vx_uint32 num_bufs)
+{
+    vx_status status = VX_SUCCESS;
+    BufPool *buf_pool = NULL;
+    vx_uint32 i, num_submit = 0, num_drop = 0, num_done;
+    vx_int32 slot;
+
+    if (0 == num_bufs) {
+        return VX_SUCCESS;
+    }
+
+    buf_pool = bufs[0]->pool;
+
+    for (i = 0; i < num_bufs; i++) {
+        if (bufs[i]->pool != buf_pool) {
+            TIOVX_MODULE_ERROR("Buffers belong to different pools\n");
+            return VX_FAILURE;
+        }
+    }
+
+    for (i = 0; i < num_bufs; i++) {
+        bufs[i]->held = vx_false_e;
+    }
+
+    if (TIOVX_MODULES_DROP_NONE == buf_pool->drop_policy) {
+        return tiovx_modules_release_unsubmitted(bufs, num_bufs,
+                        tiovx_modules_submit_bufs(bufs, num_bufs));
+    }
+
+    Buf *submit_list[num_bufs];
+    Buf *drop_list[num_bufs];
+
+    LOCK(buf_pool);
+
+    for (i = 0; i < num_bufs; i++) {
+        /* Waiting buffers are older, they go to the graph first */
+        if (0 == buf_pool->pending_count &&
+            buf_pool->num_queued < buf_pool->max_queued) {
+            submit_list[num_submit++] = bufs[i];
+            buf_pool->num_queued++;
+        } else if (TIOVX_MODULES_DROP_NEWEST == buf_pool->drop_policy) {
+            drop_list[num_drop++] = bufs[i];
+        } else {
+            if (buf_pool->pending_count == buf_pool->max_pending) {
+                drop_list[num_drop++] =
+                        buf_pool->pendingQ[buf_pool->pending_head];
+                buf_pool->pending_head = (buf_pool->pending_head + 1) %
+                                         buf_pool->max_bufq_depth;
+                buf_pool->pending_count--;
+            }
+
+            slot = (buf_pool->pending_head + buf_pool->pending_count) %
+                   buf_pool->max_bufq_depth;
+            buf_pool->pendingQ[slot] = bufs[i];
+            buf_pool->pending_count++;
+        }
+    }
+
+    buf_pool->num_dropped += num_drop;
+
+    UNLOCK(buf_pool);
+
+    if (num_submit > 0) {
+        num_done = tiovx_modules_submit_bufs(submit_list, num_submit);
+        if (num_done < num_submit) {
+            LOCK(buf_pool);
+            buf_pool->num_queued -= num_submit - num_done;
+            UNLOCK(buf_pool);
+            status = tiovx_modules_release_unsubmitted(submit_list, num_submit,
+                                                       num_done);
+        }
+    }
+
+    for (i = 0; i < num_drop; i++) {
+        tiovx_modules_release_buf(drop_list[i]);
+    }
 
     return status;
 }
 
-Buf* tiovx_modules_dequeue_buf(BufPool *buf_pool)
+/* The graph returned num_done buffers, move waiting buffers in their place */
+static void tiovx_modules_flush_pending(BufPool *buf_pool, vx_uint32 num_done)
+{
+    Buf *submit_list[buf_pool->max_bufq_depth];
+    vx_uint32 num_submit = 0, num_submitted;
+
+    LOCK(buf_pool);
+
+    buf_pool->num_queued -= num_done;
+    while (buf_pool->pending_count > 0 &&
+           buf_pool->num_queued < buf_pool->max_queued) {
+        submit_list[num_submit++] = buf_pool->pendingQ[buf_pool->pending_head];
+        buf_pool->pending_head = (buf_pool->pending_head + 1) %
+                                 buf_pool->max_bufq_depth;
+        buf_pool->pending_count--;
+        buf_pool->num_queued++;
+    }
+
+    UNLOCK(buf_pool);
+
+    if (num_submit > 0) {
+        /* Buffers the graph did not take are dropped, not lost */
+        num_submitted = tiovx_modules_submit_bufs(submit_list, num_submit);
+        if (num_submitted < num_submit) {
+            LOCK(buf_pool);
+            buf_pool->num_queued -= num_submit - num_submitted;
+            buf_pool->num_dropped += num_submit - num_submitted;
+            UNLOCK(buf_pool);
+            tiovx_modules_release_unsubmitted(submit_list, num_submit,
+                                              num_submitted);
+        }
+    }
+}
+
+vx_status tiovx_modules_enqueue_buf(Buf *buf)
+{
+    return tiovx_modules_enqueue_bufs(&buf, 1);
+}
+
+/* Pop num_refs buffers dequeued from the graph off the enqueued queue */
+static vx_uint32 tiovx_modules_pop_enqueued(BufPool *buf_pool, Buf **bufs,
+                                            vx_uint32 num_refs)
+{
+    vx_int32 queue_size = buf_pool->max_bufq_depth + 1;
+    vx_uint32 i;
+
+    if (buf_pool->lock_free) {
+        for (i = 0; i < num_refs; i++) {
+            bufs[i] = tiovx_modules_buf_ring_pop(&buf_pool->enqueued_ring);
+            if (NULL == bufs[i]) {
+                TIOVX_MODULE_ERROR("Queue Empty\n");
+                break;
+            }
+        }
+        return i;
+    }
+
+    LOCK(buf_pool);
+
+    for (i = 0; i < num_refs; i++) {
+        if (buf_pool->enqueue_tail == buf_pool->enqueue_head) {
+            TIOVX_MODULE_ERROR("Queue Empty\n");
+            break;
+        }
+
+        bufs[i] = buf_pool->enqueuedQ[buf_pool->enqueue_tail];
+        buf_pool->enqueue_tail = (buf_pool->enqueue_tail + 1) % queue_size;
+    }
+
+    UNLOCK(buf_pool);
+
+    return i;
+}
+
+vx_uint32 tiovx_modules_dequeue_bufs(BufPool *buf_pool, Buf **bufs,
+                                     vx_uint32 max_bufs)
 {
     Pad *pad = buf_pool->pad;
     GraphObj *graph = pad->node->graph;
-    vx_object_array ref = NULL;
     vx_uint32 num_refs = 0;
 
+    if (0 == max_bufs) {
+        return 0;
+    }
+
+    vx_reference refs[max_bufs];
+
     vxGraphParameterDequeueDoneRef(graph->tiovx_graph,
                                    pad->graph_parameter_index,
-                                   (vx_reference *)&ref, 1, &num_refs);
+                                   refs, max_bufs, &num_refs);
 
-    LOCK(buf_pool);
+    num_refs = tiovx_modules_pop_enqueued(buf_pool, bufs, num_refs);
+    for (vx_uint32 i = 0; i < num_refs; i++) {
+        bufs[i]->held = vx_true_e;
+    }
 
-    if (buf_pool->enqueue_tail == buf_pool->enqueue_head) {
-        TIOVX_MODULE_ERROR("Queue Empty\n");
-        UNLOCK(buf_pool);
-        return NULL;
+    if (num_refs > 0 && TIOVX_MODULES_DROP_NONE != buf_pool->drop_policy) {
+        tiovx_modules_flush_pending(buf_pool, num_refs);
+    }
+
+    if (buf_pool->collect_stats) {
+        tiovx_modules_stats_dequeue(buf_pool, bufs, num_refs);
     }
 
-    Buf *buf = buf_pool->enqueuedQ[buf_pool->enqueue_tail];
-    buf_pool->enqueue_tail = (buf_pool->enqueue_tail + 1) %
-                                                    (buf_pool->bufq_depth + 1);
+    if (tiovx_modules_trace_enabled()) {
+        tiovx_modules_trace_bufs(buf_pool, bufs, num_refs, 'e');
+        tiovx_modules_trace_nodes(graph);
+    }
 
-    UNLOCK(buf_pool);
+    return num_refs;
+}
+
+Buf* tiovx_modules_dequeue_buf(BufPool *buf_pool)
+{
+    Buf *buf = NULL;
+
+    if (0 == tiovx_modules_dequeue_bufs(buf_pool, &buf, 1)) {
+        return NULL;
+    }
 
     return buf;
 }
 
+static vx_uint32 tiovx_modules_get_num_done(BufPool *buf_pool)
+{
+    Pad *pad = buf_pool->pad;
+    GraphObj *graph = pad->node->graph;
+    vx_uint32 num_refs = 0;
+
+    vxGraphParameterCheckDoneRef(graph->tiovx_graph,
+                                 pad->graph_parameter_index,
+                                 &num_refs);
+
+    return num_refs;
+}
+
+static void tiovx_modules_stats_dequeue_empty(BufPool *buf_pool)
+{
+    if (buf_pool->collect_stats) {
+        __atomic_add_fetch(&buf_pool->stats.num_dequeue_empty, 1,
+                           __ATOMIC_RELAXED);
+    }
+}
+
+Buf* tiovx_modules_try_dequeue_buf(BufPool *buf_pool)
+{
+    if (0 == tiovx_modules_get_num_done(buf_pool)) {
+        tiovx_modules_stats_dequeue_empty(buf_pool);
+        return NULL;
+    }
+
+    return tiovx_modules_dequeue_buf(buf_pool);
+}
+
+void tiovx_modules_set_param_event_source(vx_bool active)
+{
+    pthread_mutex_lock(&g_param_event_lock);
+    g_num_param_event_sources += active ? 1 : -1;
+    /* Waiters fall back to polling once no source is left */
+    pthread_cond_broadcast(&g_param_event_cond);
+    pthread_mutex_unlock(&g_param_event_lock);
+}
+
+void tiovx_modules_signal_param_event(void)
+{
+    pthread_mutex_lock(&g_param_event_lock);
+    g_param_event_seq++;
+    pthread_cond_broadcast(&g_param_event_cond);
+    pthread_mutex_unlock(&g_param_event_lock);
+}
+
+static vx_uint64 tiovx_modules_get_param_event_seq(void)
+{
+    vx_uint64 seq;
+
+    pthread_mutex_lock(&g_param_event_lock);
+    seq = g_param_event_seq;
+    pthread_mutex_unlock(&g_param_event_lock);
+
+    return seq;
+}
+
+/*
+ * Sleep till a graph parameter event newer than seq or the deadline.
+ * Returns vx_false_e without waiting if nothing reads the events, the
+ * caller must poll then.
+ */
+static vx_bool tiovx_modules_wait_param_event(vx_uint64 seq,
+                                              const struct timespec *deadline)
+{
+    vx_bool waited = vx_false_e;
+    int ret = 0;
+
+    pthread_mutex_lock(&g_param_event_lock);
+    while (g_num_param_event_sources > 0 && seq == g_param_event_seq &&
+           ETIMEDOUT != ret) {
+        waited = vx_true_e;
+        ret = pthread_cond_timedwait(&g_param_event_cond,
+                                     &g_param_event_lock, deadline);
+    }
+    if (seq != g_param_event_seq) {
+        waited = vx_true_e;
+    }
+    pthread_mutex_unlock(&g_param_event_lock);
+
+    return waited;
+}
+
+Buf* tiovx_modules_dequeue_any_buf(BufPool **buf_pools, vx_uint32 num_pools,
+                                   vx_uint32 timeout_ms)
+{
+    struct timespec start, now, deadline;
+    vx_uint64 elapsed_ms = 0, seq = 0;
+    vx_uint32 wait_ms;
+    vx_bool use_events = vx_true_e;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (vx_uint32 i = 0; i < num_pools; i++) {
+        if (vx_false_e == buf_pools[i]->pad->node->graph->use_param_events) {
+            use_events = vx_false_e;
+        }
+    }
+
+    /*
+     * OpenVX has no timed wait on graph parameters. With param events the
+     * wait is on the consumed events, else the done queues are polled with
+     * a short sleep between rounds.
+     */
+    for (;;) {
+        /* Read before checking so an event in between is not missed */
+        if (use_events) {
+            seq = tiovx_modules_get_param_event_seq();
+        }
+
+        for (vx_uint32 i = 0; i < num_pools; i++) {
+            if (tiovx_modules_get_num_done(buf_pools[i]) > 0) {
+                return tiovx_modules_dequeue_buf(buf_pools[i]);
+            }
+        }
+
+        if (0 == timeout_ms) {
+            break;
+        }
+
+        if (TIOVX_MODULES_WAIT_FOREVER != timeout_ms) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 +
+                         (now.tv_nsec - start.tv_nsec) / 1000000;
+            if (elapsed_ms >= timeout_ms) {
+                break;
+            }
+        }
+
+        /* Waits are capped so a missed event only delays the dequeue */
+        wait_ms = TIOVX_MODULES_PARAM_EVENT_WAIT_MS;
+        if (TIOVX_MODULES_WAIT_FOREVER != timeout_ms &&
+            timeout_ms - elapsed_ms < wait_ms) {
+            wait_ms = timeout_ms - elapsed_ms;
+        }
+
+        if (vx_false_e == use_events ||
+            vx_false_e == tiovx_modules_wait_param_event(seq,
+                            tiovx_modules_get_deadline(wait_ms, &deadline))) {
+            usleep(TIOVX_MODULES_DEQUEUE_POLL_US);
+        }
+    }
+
+    for (vx_uint32 i = 0; i < num_pools; i++) {
+        tiovx_modules_stats_dequeue_empty(buf_pools[i]);
+    }
+
+    return NULL;
+}
+
+Buf* tiovx_modules_dequeue_buf_timeout(BufPool *buf_pool, vx_uint32 timeout_ms)
+{
+    if (TIOVX_MODULES_WAIT_FOREVER == timeout_ms) {
+        return tiovx_modules_dequeue_buf(buf_pool);
+    }
+
+    return tiovx_modules_dequeue_any_buf(&buf_pool, 1, timeout_ms);
+}
+
 vx_status tiovx_modules_schedule_graph(GraphObj *graph)
 {
     vx_status status = VX_SUCCESS;
     if (graph->schedule_mode == VX_GRAPH_SCHEDULE_MODE_QUEUE_MANUAL)
     {
+        tiovx_modules_trace_event("graph", "schedule", 'i',
+                                  tiovx_modules_trace_time(), 0, 0);
         status = vxScheduleGraph(graph->tiovx_graph);
     }
     return status;
@@ -1005,14 +3385,15 @@ vx_status tiovx_modules_clean_graph(GraphObj *graph)
     NodeObj *node = NULL;
     Pad *pad = NULL;
 
-    for (uint8_t i = 0; i < graph->num_nodes; i++) {
-        node = &(graph->node_list[i]);
+    for (vx_int32 i = 0; i < graph->num_nodes; i++) {
+        node = graph->node_list[i];
 
         for (uint8_t j = 0; j < node->num_inputs; j++) {
             pad = &node->sinks[j];
             vxReleaseReference(&pad->exemplar);
             vxReleaseObjectArray(&pad->exemplar_arr);
-            if (pad->peer_pad == NULL) {
+            /* A failed load can leave floating pads without a pool */
+            if (pad->peer_pad == NULL && pad->buf_pool != NULL) {
                 tiovx_modules_free_bufpool(pad->buf_pool);
             }
         }
@@ -1021,14 +3402,20 @@ vx_status tiovx_modules_clean_graph(GraphObj *graph)
             pad = &node->srcs[j];
             vxReleaseReference(&pad->exemplar);
             vxReleaseObjectArray(&pad->exemplar_arr);
-            if (pad->peer_pad == NULL) {
+            if (pad->peer_pad == NULL && pad->buf_pool != NULL) {
                 tiovx_modules_free_bufpool(pad->buf_pool);
             }
         }
 
         tiovx_modules_delete_node(node);
+        tiovx_modules_free_node_obj(node);
     }
 
+    free(graph->node_list);
+    free(graph->graph_params_list);
+
+    tiovx_modules_destroy_mem_arena(graph);
+
     vxReleaseGraph(&graph->tiovx_graph);
 
     tivxExtUnLoadKernels(graph->tiovx_context);
@@ -89,6 +89,7 @@ NodeCbs gNodeCbs[TIOVX_MODULES_NUM_MODULES] =
     },
     {
         .init_node = tiovx_viss_init_node,
+        .load_node = tiovx_viss_load_node,
         .create_node = tiovx_viss_create_node,
         .post_verify_graph = NULL,
         .delete_node = tiovx_viss_delete_node,
@@ -97,6 +98,7 @@ NodeCbs gNodeCbs[TIOVX_MODULES_NUM_MODULES] =
     },
     {
         .init_node = tiovx_ldc_init_node,
+        .load_node = tiovx_ldc_load_node,
         .create_node = tiovx_ldc_create_node,
         .post_verify_graph = NULL,
         .delete_node = tiovx_ldc_delete_node,
@@ -113,6 +115,7 @@ NodeCbs gNodeCbs[TIOVX_MODULES_NUM_MODULES] =
     },
     {
         .init_node = tiovx_tidl_init_node,
+        .load_node = tiovx_tidl_load_node,
         .create_node = tiovx_tidl_create_node,
         .post_verify_graph = NULL,
         .delete_node = tiovx_tidl_delete_node,
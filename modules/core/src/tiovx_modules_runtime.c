@@ -0,0 +1,657 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "tiovx_modules_runtime.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#define LOCK(a) pthread_mutex_lock(&a->lock)
+#define UNLOCK(a) pthread_mutex_unlock(&a->lock)
+
+/* Wakeup period of workers in case a graph event was missed */
+#define TIOVX_MODULES_RUNTIME_POLL_MS  (100u)
+
+/* Events are queued per context, so every started runtime is listed here
+ * and a reactor dispatches events of any graph it receives
+ */
+static Runtime *g_runtimes = NULL;
+static vx_uint32 g_num_runtimes = 0;
+static pthread_mutex_t g_runtimes_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void tiovx_modules_rate_control_init(RateControl *rate, vx_uint32 decimation,
+                                     vx_float32 fps)
+{
+    CLR(rate);
+
+    rate->decimation = decimation;
+    rate->fps = fps;
+    if (fps > 0) {
+        rate->period_us = (vx_uint64)(1000000.0f / fps);
+    }
+}
+
+vx_bool tiovx_modules_rate_control_accept(RateControl *rate)
+{
+    struct timespec ts;
+    vx_uint64 now;
+    vx_bool accept = vx_true_e;
+
+    rate->num_frames++;
+
+    if (rate->decimation > 1 &&
+        0 != (rate->num_frames - 1) % rate->decimation) {
+        accept = vx_false_e;
+    } else if (0 != rate->period_us) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        now = (vx_uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+        if (now < rate->next_us) {
+            accept = vx_false_e;
+        } else if (now - rate->next_us >= rate->period_us) {
+            /* Fell behind by a full period, restart the schedule */
+            rate->next_us = now + rate->period_us;
+        } else {
+            rate->next_us += rate->period_us;
+        }
+    }
+
+    if (vx_false_e == accept) {
+        rate->num_skipped++;
+    }
+
+    return accept;
+}
+
+static vx_uint32 tiovx_modules_runtime_stop_event(Runtime *runtime)
+{
+    return runtime->graph->event_base + runtime->graph->num_graph_params;
+}
+
+static void tiovx_modules_runtime_dispatch(vx_event_t *event)
+{
+    Runtime *runtime = NULL;
+    vx_uint32 index;
+
+    pthread_mutex_lock(&g_runtimes_lock);
+    for (runtime = g_runtimes; NULL != runtime; runtime = runtime->next) {
+        if (event->app_value < runtime->graph->event_base) {
+            continue;
+        }
+
+        index = event->app_value - runtime->graph->event_base;
+        if (index < runtime->graph->num_graph_params) {
+            if (NULL != runtime->param_map[index]) {
+                sem_post(&runtime->param_map[index]->sem);
+            }
+            break;
+        }
+
+        /* Stop event of another runtime, forward it to its reactor */
+        if (index == runtime->graph->num_graph_params) {
+            vxSendUserEvent(runtime->graph->tiovx_context,
+                            event->app_value, NULL);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_runtimes_lock);
+}
+
+static vx_bool tiovx_modules_runtime_is_running(Runtime *runtime)
+{
+    vx_bool running;
+
+    LOCK(runtime);
+    running = runtime->running;
+    UNLOCK(runtime);
+
+    return running;
+}
+
+static void tiovx_modules_runtime_finish(Runtime *runtime)
+{
+    LOCK(runtime);
+    runtime->finished = vx_true_e;
+    pthread_cond_broadcast(&runtime->cond);
+    UNLOCK(runtime);
+}
+
+static void* tiovx_modules_runtime_reactor(void *arg)
+{
+    Runtime *runtime = (Runtime *)arg;
+    GraphObj *graph = runtime->graph;
+    vx_event_t event;
+    vx_status status;
+
+    tiovx_modules_set_param_event_source(vx_true_e);
+
+    while (tiovx_modules_runtime_is_running(runtime)) {
+        status = vxWaitEvent(graph->tiovx_context, &event, vx_false_e);
+        if (VX_SUCCESS != status) {
+            continue;
+        }
+
+        /* User event is only sent by stop to wake a reactor */
+        if (VX_EVENT_USER == event.type &&
+            tiovx_modules_runtime_stop_event(runtime) == event.app_value) {
+            break;
+        }
+
+        /* Timed dequeues outside the runtime wait on the same events */
+        if (VX_EVENT_GRAPH_PARAMETER_CONSUMED == event.type) {
+            tiovx_modules_signal_param_event();
+        }
+
+        if (VX_EVENT_USER == event.type ||
+            VX_EVENT_GRAPH_PARAMETER_CONSUMED == event.type) {
+            tiovx_modules_runtime_dispatch(&event);
+        }
+    }
+
+    tiovx_modules_set_param_event_source(vx_false_e);
+
+    return NULL;
+}
+
+static void* tiovx_modules_runtime_worker(void *arg)
+{
+    RuntimePad *rt_pad = (RuntimePad *)arg;
+    Runtime *runtime = rt_pad->runtime;
+    BufPool *buf_pool = rt_pad->pad->buf_pool;
+    struct timespec deadline;
+    Buf *buf = NULL;
+
+    while (tiovx_modules_runtime_is_running(runtime)) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += TIOVX_MODULES_RUNTIME_POLL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        sem_timedwait(&rt_pad->sem, &deadline);
+
+        /* Events can coalesce, service every buffer that is done */
+        while (tiovx_modules_runtime_is_running(runtime) &&
+               NULL != (buf = tiovx_modules_try_dequeue_buf(buf_pool))) {
+            /* Skipped output goes straight back to the graph */
+            if (SRC == rt_pad->pad->direction && rt_pad->use_rate &&
+                vx_false_e == tiovx_modules_rate_control_accept(&rt_pad->rate)) {
+                tiovx_modules_enqueue_buf(buf);
+                continue;
+            }
+
+            buf = rt_pad->cb(buf, rt_pad->priv);
+
+            /* Skipped input is handed back to the source for the next one */
+            while (SINK == rt_pad->pad->direction && rt_pad->use_rate &&
+                   NULL != buf && tiovx_modules_runtime_is_running(runtime) &&
+                   vx_false_e == tiovx_modules_rate_control_accept(&rt_pad->rate)) {
+                buf = rt_pad->cb(buf, rt_pad->priv);
+            }
+
+            if (NULL == buf) {
+                tiovx_modules_runtime_finish(runtime);
+                return NULL;
+            }
+
+            tiovx_modules_enqueue_buf(buf);
+            rt_pad->num_bufs++;
+        }
+    }
+
+    return NULL;
+}
+
+static vx_status tiovx_modules_runtime_add_pad(Runtime *runtime, Pad *pad,
+                                               RuntimeCallback cb, void *priv)
+{
+    vx_status status = VX_FAILURE;
+    RuntimePad *rt_pad = NULL;
+
+    if (NULL != pad->peer_pad || NULL == pad->buf_pool ||
+        pad->graph_parameter_index < 0) {
+        TIOVX_MODULE_ERROR("Pad is not a graph parameter\n");
+        return status;
+    }
+
+    if (NULL != runtime->param_map[pad->graph_parameter_index]) {
+        TIOVX_MODULE_ERROR("Pad already registered\n");
+        return status;
+    }
+
+    rt_pad = &runtime->pads[runtime->num_pads];
+    rt_pad->runtime = runtime;
+    rt_pad->pad = pad;
+    rt_pad->cb = cb;
+    rt_pad->priv = priv;
+    rt_pad->num_bufs = 0;
+    sem_init(&rt_pad->sem, 0, 0);
+
+    runtime->param_map[pad->graph_parameter_index] = rt_pad;
+    runtime->num_pads++;
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+vx_status tiovx_modules_runtime_init(Runtime *runtime, GraphObj *graph)
+{
+    vx_status status = VX_FAILURE;
+
+    CLR(runtime);
+
+    if (vx_false_e == graph->use_param_events) {
+        TIOVX_MODULE_ERROR("Graph verified without param events\n");
+        return status;
+    }
+
+    runtime->graph = graph;
+    runtime->pads = (RuntimePad *)calloc(graph->num_graph_params,
+                                         sizeof(RuntimePad));
+    runtime->param_map = (RuntimePad **)calloc(graph->num_graph_params,
+                                               sizeof(RuntimePad *));
+    if (NULL == runtime->pads || NULL == runtime->param_map) {
+        TIOVX_MODULE_ERROR("Runtime alloc failed\n");
+        free(runtime->pads);
+        free(runtime->param_map);
+        return VX_ERROR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&runtime->lock, NULL);
+    pthread_cond_init(&runtime->cond, NULL);
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+vx_status tiovx_modules_runtime_add_source(Runtime *runtime, Pad *pad,
+                                           RuntimeCallback cb, void *priv)
+{
+    if (SINK != pad->direction) {
+        TIOVX_MODULE_ERROR("Source callback needs a sink pad\n");
+        return VX_FAILURE;
+    }
+
+    return tiovx_modules_runtime_add_pad(runtime, pad, cb, priv);
+}
+
+vx_status tiovx_modules_runtime_add_sink(Runtime *runtime, Pad *pad,
+                                         RuntimeCallback cb, void *priv)
+{
+    if (SRC != pad->direction) {
+        TIOVX_MODULE_ERROR("Sink callback needs a src pad\n");
+        return VX_FAILURE;
+    }
+
+    return tiovx_modules_runtime_add_pad(runtime, pad, cb, priv);
+}
+
+vx_status tiovx_modules_runtime_set_rate(Runtime *runtime, Pad *pad,
+                                         vx_uint32 decimation, vx_float32 fps)
+{
+    RuntimePad *rt_pad = NULL;
+
+    if (pad->graph_parameter_index < 0 ||
+        NULL == runtime->param_map[pad->graph_parameter_index]) {
+        TIOVX_MODULE_ERROR("Pad not registered with runtime\n");
+        return VX_FAILURE;
+    }
+
+    rt_pad = runtime->param_map[pad->graph_parameter_index];
+    tiovx_modules_rate_control_init(&rt_pad->rate, decimation, fps);
+    rt_pad->use_rate = (decimation > 1 || fps > 0) ? vx_true_e : vx_false_e;
+
+    return VX_SUCCESS;
+}
+
+static void tiovx_modules_runtime_unregister(Runtime *runtime)
+{
+    pthread_mutex_lock(&g_runtimes_lock);
+    for (Runtime **it = &g_runtimes; NULL != *it; it = &(*it)->next) {
+        if (*it == runtime) {
+            *it = runtime->next;
+            break;
+        }
+    }
+    g_num_runtimes--;
+    if (0 == g_num_runtimes) {
+        vxDisableEvents(runtime->graph->tiovx_context);
+    }
+    pthread_mutex_unlock(&g_runtimes_lock);
+}
+
+static void tiovx_modules_runtime_join(Runtime *runtime, vx_int32 num_workers)
+{
+    LOCK(runtime);
+    runtime->running = vx_false_e;
+    UNLOCK(runtime);
+
+    vxSendUserEvent(runtime->graph->tiovx_context,
+                    tiovx_modules_runtime_stop_event(runtime), NULL);
+    pthread_join(runtime->reactor, NULL);
+
+    for (vx_int32 i = 0; i < num_workers; i++) {
+        sem_post(&runtime->pads[i].sem);
+        pthread_join(runtime->pads[i].thread, NULL);
+    }
+}
+
+vx_status tiovx_modules_runtime_start(Runtime *runtime)
+{
+    vx_status status = VX_FAILURE;
+    vx_int32 i = 0;
+
+    pthread_mutex_lock(&g_runtimes_lock);
+    if (0 == g_num_runtimes) {
+        status = vxEnableEvents(runtime->graph->tiovx_context);
+    } else {
+        status = VX_SUCCESS;
+    }
+
+    if (VX_SUCCESS != status) {
+        TIOVX_MODULE_ERROR("Enabling events failed\n");
+        pthread_mutex_unlock(&g_runtimes_lock);
+        return status;
+    }
+
+    runtime->next = g_runtimes;
+    g_runtimes = runtime;
+    g_num_runtimes++;
+    pthread_mutex_unlock(&g_runtimes_lock);
+
+    runtime->running = vx_true_e;
+    runtime->finished = vx_false_e;
+
+    if (0 != pthread_create(&runtime->reactor, NULL,
+                            tiovx_modules_runtime_reactor, runtime)) {
+        TIOVX_MODULE_ERROR("Creating reactor thread failed\n");
+        runtime->running = vx_false_e;
+        tiovx_modules_runtime_unregister(runtime);
+        return VX_FAILURE;
+    }
+
+    for (i = 0; i < runtime->num_pads; i++) {
+        if (0 != pthread_create(&runtime->pads[i].thread, NULL,
+                                tiovx_modules_runtime_worker,
+                                &runtime->pads[i])) {
+            TIOVX_MODULE_ERROR("Creating worker thread %d failed\n", i);
+            status = VX_FAILURE;
+            break;
+        }
+    }
+
+    if (VX_SUCCESS != status) {
+        tiovx_modules_runtime_join(runtime, i);
+        tiovx_modules_runtime_unregister(runtime);
+    }
+
+    return status;
+}
+
+vx_bool tiovx_modules_runtime_wait(Runtime *runtime, vx_uint32 timeout_ms)
+{
+    struct timespec deadline;
+    vx_bool finished;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    LOCK(runtime);
+    while (vx_false_e == runtime->finished) {
+        if (ETIMEDOUT == pthread_cond_timedwait(&runtime->cond,
+                                                &runtime->lock,
+                                                &deadline)) {
+            break;
+        }
+    }
+    finished = runtime->finished;
+    UNLOCK(runtime);
+
+    return finished;
+}
+
+vx_status tiovx_modules_runtime_stop(Runtime *runtime)
+{
+    vx_status status = VX_SUCCESS;
+    Buf *buf = NULL;
+
+    tiovx_modules_runtime_join(runtime, runtime->num_pads);
+    tiovx_modules_runtime_unregister(runtime);
+
+    /* Nothing is enqueued anymore, so once the graph is idle every buffer
+     * still owned by it can be dequeued without blocking */
+    status = tiovx_modules_wait_graph(runtime->graph);
+    if (VX_SUCCESS != status) {
+        TIOVX_MODULE_ERROR("Waiting for graph failed\n");
+    }
+
+    for (vx_int32 i = 0; i < runtime->num_pads; i++) {
+        BufPool *buf_pool = runtime->pads[i].pad->buf_pool;
+
+        while (NULL != (buf = tiovx_modules_try_dequeue_buf(buf_pool))) {
+            tiovx_modules_release_buf(buf);
+        }
+    }
+
+    return status;
+}
+
+void tiovx_modules_runtime_deinit(Runtime *runtime)
+{
+    for (vx_int32 i = 0; i < runtime->num_pads; i++) {
+        sem_destroy(&runtime->pads[i].sem);
+    }
+
+    pthread_mutex_destroy(&runtime->lock);
+    pthread_cond_destroy(&runtime->cond);
+    free(runtime->pads);
+    free(runtime->param_map);
+    CLR(runtime);
+}
+
+vx_status tiovx_modules_bridge_init(Bridge *bridge, Pad *src_pad,
+                                    Pad *sink_pad, vx_uint32 timeout_ms)
+{
+    vx_status status = VX_FAILURE;
+
+    CLR(bridge);
+
+    if (SRC != src_pad->direction || SINK != sink_pad->direction) {
+        TIOVX_MODULE_ERROR("Bridge needs a src pad and a sink pad\n");
+        return status;
+    }
+
+    if (NULL != src_pad->peer_pad || NULL == src_pad->buf_pool ||
+        NULL != sink_pad->peer_pad || NULL == sink_pad->buf_pool) {
+        TIOVX_MODULE_ERROR("Bridge pads must be graph parameters\n");
+        return status;
+    }
+
+    if (src_pad->num_channels != sink_pad->num_channels) {
+        TIOVX_MODULE_ERROR("Bridge pads have different num channels\n");
+        return status;
+    }
+
+    /* Buffers swap memory across the bridge, so they must be alike */
+    if (vx_false_e == tiovx_modules_compare_exemplars(src_pad->exemplar,
+                                                      sink_pad->exemplar)) {
+        TIOVX_MODULE_ERROR("Bridge pads have different exemplars\n");
+        return status;
+    }
+
+    if (src_pad->node->graph->use_mem_arena ||
+        sink_pad->node->graph->use_mem_arena) {
+        TIOVX_MODULE_ERROR("Bridge cannot move memory of a memory arena\n");
+        return status;
+    }
+
+    if (src_pad->buf_pool->import_mem || sink_pad->buf_pool->import_mem) {
+        TIOVX_MODULE_ERROR("Bridge cannot move imported memory\n");
+        return status;
+    }
+
+    bridge->slot = tiovx_modules_acquire_buf(sink_pad->buf_pool);
+    if (NULL == bridge->slot) {
+        TIOVX_MODULE_ERROR("No free buffer for bridge slot\n");
+        return status;
+    }
+
+    bridge->src_pad = src_pad;
+    bridge->sink_pad = sink_pad;
+    bridge->fresh = vx_false_e;
+    bridge->timeout_ms = timeout_ms;
+    pthread_mutex_init(&bridge->lock, NULL);
+    pthread_cond_init(&bridge->cond, NULL);
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+void tiovx_modules_bridge_set_rate(Bridge *bridge, vx_uint32 decimation,
+                                   vx_float32 fps)
+{
+    LOCK(bridge);
+    tiovx_modules_rate_control_init(&bridge->rate, decimation, fps);
+    UNLOCK(bridge);
+}
+
+Buf* tiovx_modules_bridge_push(Buf *buf, void *priv)
+{
+    Bridge *bridge = (Bridge *)priv;
+
+    LOCK(bridge);
+
+    /* Skipped frame goes back to the producer, consumer keeps the last */
+    if (vx_false_e == tiovx_modules_rate_control_accept(&bridge->rate)) {
+        UNLOCK(bridge);
+        return buf;
+    }
+
+    if (bridge->fresh) {
+        bridge->num_dropped++;
+    }
+
+    /* Slot takes the new frame, producer gets the old slot memory */
+    tiovx_modules_buf_swap_mem(buf, bridge->slot);
+    bridge->fresh = vx_true_e;
+    bridge->num_pushed++;
+    pthread_cond_signal(&bridge->cond);
+
+    UNLOCK(bridge);
+
+    return buf;
+}
+
+Buf* tiovx_modules_bridge_pull(Buf *buf, void *priv)
+{
+    Bridge *bridge = (Bridge *)priv;
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += bridge->timeout_ms / 1000;
+    deadline.tv_nsec += (bridge->timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    LOCK(bridge);
+
+    while (vx_false_e == bridge->fresh) {
+        if (ETIMEDOUT == pthread_cond_timedwait(&bridge->cond,
+                                                &bridge->lock,
+                                                &deadline)) {
+            break;
+        }
+    }
+
+    if (bridge->fresh) {
+        /* Consumed buffer takes the new frame, slot gets its memory */
+        tiovx_modules_buf_swap_mem(bridge->slot, buf);
+        bridge->fresh = vx_false_e;
+    } else {
+        /* Producer is slower, feed the buffer again */
+        bridge->num_repeated++;
+    }
+
+    UNLOCK(bridge);
+
+    return buf;
+}
+
+void tiovx_modules_bridge_deinit(Bridge *bridge)
+{
+    if (NULL != bridge->slot) {
+        tiovx_modules_release_buf(bridge->slot);
+    }
+
+    pthread_mutex_destroy(&bridge->lock);
+    pthread_cond_destroy(&bridge->cond);
+    CLR(bridge);
+}
@@ -0,0 +1,503 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "tiovx_modules_trace.h"
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+
+#define LOCK(a) pthread_mutex_lock(&a->lock)
+#define UNLOCK(a) pthread_mutex_unlock(&a->lock)
+
+/* Track ids of nodes start here, above any thread id */
+#define TIOVX_MODULES_TRACE_TRACK_BASE (1 << 22)
+
+#define TIOVX_MODULES_TRACE_PATH_LEN   (256u)
+
+/*
+ * Events of one thread. Only the owner writes, head is published after
+ * the event so a dump sees complete events. Events being overwritten
+ * while a dump runs may be torn, the dump is a best effort snapshot.
+ */
+typedef struct _TraceRing {
+    TraceEvent          *events;
+    vx_uint32           size;
+    vx_uint64           head;
+    vx_int32            tid;
+    struct _TraceRing   *next;
+} TraceRing;
+
+typedef struct {
+    vx_int32            tid;
+    char                name[TIOVX_MODULES_TRACE_NAME_LEN];
+} TraceTrack;
+
+typedef struct {
+    vx_bool             enabled;
+    vx_uint32           num_events;
+    char                path[TIOVX_MODULES_TRACE_PATH_LEN];
+
+    /* Rings are kept after their thread exits, freed on stop */
+    TraceRing           *rings;
+
+    /* Tracks live as long as the process, nodes keep their track id */
+    TraceTrack          *tracks;
+    vx_int32            num_tracks;
+    vx_int32            max_tracks;
+
+    /* Incremented on every stop, so rings of an old session are dropped */
+    vx_uint32           session;
+
+    /* Threads inside a record call, stop waits for them before freeing */
+    vx_int32            active;
+
+    /* Dumps on SIGUSR2, the handler only posts sem */
+    pthread_t           dumper;
+    sem_t               sem;
+    vx_bool             stopping;
+
+    pthread_mutex_t     lock;
+} TraceCtx;
+
+static TraceCtx g_trace = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static __thread TraceRing *t_ring = NULL;
+static __thread vx_uint32 t_session = 0;
+
+static void tiovx_modules_trace_signal(int sig)
+{
+    sem_post(&g_trace.sem);
+}
+
+static void tiovx_modules_trace_atexit(void)
+{
+    if (tiovx_modules_trace_enabled()) {
+        tiovx_modules_trace_dump(g_trace.path);
+    }
+}
+
+static void* tiovx_modules_trace_dumper(void *arg)
+{
+    TraceCtx *ctx = (TraceCtx *)arg;
+
+    for (;;) {
+        while (0 != sem_wait(&ctx->sem));
+
+        if (__atomic_load_n(&ctx->stopping, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        tiovx_modules_trace_dump(ctx->path);
+    }
+
+    return NULL;
+}
+
+static TraceRing* tiovx_modules_trace_get_ring(void)
+{
+    TraceRing *ring = NULL;
+    TraceCtx *ctx = &g_trace;
+
+    if (NULL != t_ring &&
+        t_session == __atomic_load_n(&ctx->session, __ATOMIC_ACQUIRE)) {
+        return t_ring;
+    }
+
+    ring = (TraceRing *)calloc(1, sizeof(TraceRing));
+    if (NULL == ring) {
+        return NULL;
+    }
+
+    ring->size = ctx->num_events;
+    ring->events = (TraceEvent *)calloc(ring->size, sizeof(TraceEvent));
+    if (NULL == ring->events) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->tid = (vx_int32)syscall(SYS_gettid);
+
+    LOCK(ctx);
+    if (vx_false_e == ctx->enabled) {
+        UNLOCK(ctx);
+        free(ring->events);
+        free(ring);
+        return NULL;
+    }
+    ring->next = ctx->rings;
+    ctx->rings = ring;
+    t_session = ctx->session;
+    UNLOCK(ctx);
+
+    t_ring = ring;
+
+    return ring;
+}
+
+vx_bool tiovx_modules_trace_enabled(void)
+{
+    return __atomic_load_n(&g_trace.enabled, __ATOMIC_RELAXED);
+}
+
+vx_uint64 tiovx_modules_trace_time(void)
+{
+    /* Same clock as the node performance timestamps of OpenVX */
+    return tivxPlatformGetTimeInUsecs();
+}
+
+static void tiovx_modules_trace_record(const char *cat, const char *name,
+                                       char phase, vx_int32 tid,
+                                       vx_uint64 ts_us, vx_uint64 dur_us,
+                                       vx_uint64 id)
+{
+    TraceCtx *ctx = &g_trace;
+    TraceRing *ring = NULL;
+    TraceEvent *event = NULL;
+
+    /*
+     * Announced before enabled is checked, so stop either sees this thread
+     * active or this thread sees tracing disabled.
+     */
+    __atomic_add_fetch(&ctx->active, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&ctx->enabled, __ATOMIC_SEQ_CST)) {
+        ring = tiovx_modules_trace_get_ring();
+    }
+
+    if (NULL == ring) {
+        __atomic_sub_fetch(&ctx->active, 1, __ATOMIC_RELEASE);
+        return;
+    }
+
+    event = &ring->events[ring->head % ring->size];
+    strncpy(event->name, name, TIOVX_MODULES_TRACE_NAME_LEN - 1);
+    event->name[TIOVX_MODULES_TRACE_NAME_LEN - 1] = '\0';
+    event->cat = cat;
+    event->phase = phase;
+    event->tid = (0 == tid) ? ring->tid : tid;
+    event->ts_us = ts_us;
+    event->dur_us = dur_us;
+    event->id = id;
+
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&ctx->active, 1, __ATOMIC_RELEASE);
+}
+
+void tiovx_modules_trace_event(const char *cat, const char *name, char phase,
+                               vx_uint64 ts_us, vx_uint64 dur_us,
+                               vx_uint64 id)
+{
+    if (!tiovx_modules_trace_enabled()) {
+        return;
+    }
+
+    tiovx_modules_trace_record(cat, name, phase, 0, ts_us, dur_us, id);
+}
+
+/* Name a new track, returns 0 on failure */
+static vx_int32 tiovx_modules_trace_new_track(const char *name)
+{
+    TraceCtx *ctx = &g_trace;
+    TraceTrack *tracks = NULL;
+    vx_int32 max_tracks;
+    vx_int32 tid = 0;
+
+    if (ctx->num_tracks == ctx->max_tracks) {
+        max_tracks = (0 == ctx->max_tracks) ? 16 : 2 * ctx->max_tracks;
+        tracks = (TraceTrack *)realloc(ctx->tracks,
+                                       max_tracks * sizeof(TraceTrack));
+        if (NULL == tracks) {
+            TIOVX_MODULE_ERROR("Trace track alloc failed\n");
+            return tid;
+        }
+        ctx->tracks = tracks;
+        ctx->max_tracks = max_tracks;
+    }
+
+    tid = TIOVX_MODULES_TRACE_TRACK_BASE + ctx->num_tracks;
+    ctx->tracks[ctx->num_tracks].tid = tid;
+    snprintf(ctx->tracks[ctx->num_tracks].name,
+             TIOVX_MODULES_TRACE_NAME_LEN, "%s", name);
+    ctx->num_tracks++;
+
+    return tid;
+}
+
+void tiovx_modules_trace_track_event(vx_int32 *track, const char *cat,
+                                     const char *name, vx_uint64 ts_us,
+                                     vx_uint64 dur_us)
+{
+    TraceCtx *ctx = &g_trace;
+    vx_int32 tid;
+
+    if (!tiovx_modules_trace_enabled()) {
+        return;
+    }
+
+    tid = __atomic_load_n(track, __ATOMIC_ACQUIRE);
+    if (0 == tid) {
+        LOCK(ctx);
+        /* Another thread may have named the track meanwhile */
+        tid = *track;
+        if (0 == tid) {
+            tid = tiovx_modules_trace_new_track(name);
+            __atomic_store_n(track, tid, __ATOMIC_RELEASE);
+        }
+        UNLOCK(ctx);
+
+        if (0 == tid) {
+            return;
+        }
+    }
+
+    tiovx_modules_trace_record(cat, name, 'X', tid, ts_us, dur_us, 0);
+}
+
+/* Write str as a JSON string, node names come from the application */
+void tiovx_modules_trace_write_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+
+    for (; '\0' != *str; str++) {
+        if ('"' == *str || '\\' == *str) {
+            fputc('\\', fp);
+            fputc(*str, fp);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, fp);
+        }
+    }
+
+    fputc('"', fp);
+}
+
+static void tiovx_modules_trace_write_event(FILE *fp, TraceEvent *event,
+                                            vx_int32 pid, vx_bool *first)
+{
+    fprintf(fp, "%s\n{\"name\":", *first ? "" : ",");
+    tiovx_modules_trace_write_string(fp, event->name);
+    fprintf(fp, ",\"cat\":");
+    tiovx_modules_trace_write_string(fp, event->cat);
+    fprintf(fp, ",\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%llu",
+            event->phase, pid, event->tid, (unsigned long long)event->ts_us);
+
+    if ('X' == event->phase) {
+        fprintf(fp, ",\"dur\":%llu", (unsigned long long)event->dur_us);
+    } else if ('i' == event->phase) {
+        fprintf(fp, ",\"s\":\"t\"");
+    } else if ('b' == event->phase || 'e' == event->phase) {
+        fprintf(fp, ",\"id\":\"0x%llx\"", (unsigned long long)event->id);
+    }
+
+    fprintf(fp, "}");
+    *first = vx_false_e;
+}
+
+static void tiovx_modules_trace_write_name(FILE *fp, vx_int32 pid,
+                                           vx_int32 tid, const char *name,
+                                           vx_bool *first)
+{
+    fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"tid\":%d,\"args\":{\"name\":",
+            *first ? "" : ",", pid, tid);
+    tiovx_modules_trace_write_string(fp, name);
+    fprintf(fp, "}}");
+    *first = vx_false_e;
+}
+
+vx_status tiovx_modules_trace_dump(const char *path)
+{
+    vx_status status = VX_FAILURE;
+    TraceCtx *ctx = &g_trace;
+    TraceRing *ring = NULL;
+    vx_int32 pid = (vx_int32)getpid();
+    vx_bool first = vx_true_e;
+    vx_uint64 head, start;
+    FILE *fp = NULL;
+
+    fp = fopen(path, "w");
+    if (NULL == fp) {
+        TIOVX_MODULE_ERROR("Could not open %s\n", path);
+        return status;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    LOCK(ctx);
+
+    for (vx_int32 i = 0; i < ctx->num_tracks; i++) {
+        tiovx_modules_trace_write_name(fp, pid, ctx->tracks[i].tid,
+                                       ctx->tracks[i].name, &first);
+    }
+
+    for (ring = ctx->rings; NULL != ring; ring = ring->next) {
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        start = (head > ring->size) ? head - ring->size : 0;
+
+        for (vx_uint64 i = start; i < head; i++) {
+            tiovx_modules_trace_write_event(fp, &ring->events[i % ring->size],
+                                            pid, &first);
+        }
+    }
+
+    UNLOCK(ctx);
+
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+vx_status tiovx_modules_trace_start(const char *path, vx_uint32 num_events)
+{
+    vx_status status = VX_FAILURE;
+    TraceCtx *ctx = &g_trace;
+    static vx_bool atexit_registered = vx_false_e;
+    struct sigaction sa;
+
+    if (tiovx_modules_trace_enabled()) {
+        TIOVX_MODULE_ERROR("Trace already started\n");
+        return status;
+    }
+
+    CLR(&sa);
+    sa.sa_handler = tiovx_modules_trace_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+
+    LOCK(ctx);
+
+    snprintf(ctx->path, TIOVX_MODULES_TRACE_PATH_LEN, "%s", path);
+    ctx->num_events = (0 == num_events) ?
+                      TIOVX_MODULES_TRACE_DEFAULT_EVENTS : num_events;
+    ctx->stopping = vx_false_e;
+    sem_init(&ctx->sem, 0, 0);
+
+    if (0 != pthread_create(&ctx->dumper, NULL, tiovx_modules_trace_dumper,
+                            ctx)) {
+        TIOVX_MODULE_ERROR("Creating trace dump thread failed\n");
+        sem_destroy(&ctx->sem);
+        UNLOCK(ctx);
+        return status;
+    }
+
+    sigaction(SIGUSR2, &sa, NULL);
+    if (vx_false_e == atexit_registered) {
+        atexit(tiovx_modules_trace_atexit);
+        atexit_registered = vx_true_e;
+    }
+
+    __atomic_store_n(&ctx->enabled, vx_true_e, __ATOMIC_RELEASE);
+    UNLOCK(ctx);
+
+    status = VX_SUCCESS;
+
+    return status;
+}
+
+void tiovx_modules_trace_stop(void)
+{
+    TraceCtx *ctx = &g_trace;
+
+    if (!tiovx_modules_trace_enabled()) {
+        return;
+    }
+
+    signal(SIGUSR2, SIG_DFL);
+    __atomic_store_n(&ctx->stopping, vx_true_e, __ATOMIC_RELEASE);
+    sem_post(&ctx->sem);
+    pthread_join(ctx->dumper, NULL);
+    sem_destroy(&ctx->sem);
+
+    /*
+     * Threads holding a ring of this session drop it once session is
+     * incremented. Rings are freed only when no thread is inside a record
+     * call, one may have checked enabled just before it was cleared.
+     */
+    LOCK(ctx);
+    __atomic_store_n(&ctx->enabled, vx_false_e, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&ctx->session, 1, __ATOMIC_SEQ_CST);
+    UNLOCK(ctx);
+
+    while (0 != __atomic_load_n(&ctx->active, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+
+    tiovx_modules_trace_dump(ctx->path);
+
+    LOCK(ctx);
+    while (NULL != ctx->rings) {
+        TraceRing *ring = ctx->rings;
+
+        ctx->rings = ring->next;
+        free(ring->events);
+        free(ring);
+    }
+    UNLOCK(ctx);
+}
@@ -115,6 +115,7 @@ typedef struct {
 
 void tiovx_ldc_init_cfg(TIOVXLdcNodeCfg *cfg);
 vx_status tiovx_ldc_init_node(NodeObj *node);
+vx_status tiovx_ldc_load_node(NodeObj *node);
 vx_status tiovx_ldc_create_node(NodeObj *node);
 vx_status tiovx_ldc_delete_node(NodeObj *node);
 vx_uint32 tiovx_ldc_get_cfg_size();
@@ -86,6 +86,7 @@ typedef struct {
 
 void tiovx_tidl_init_cfg(TIOVXTIDLNodeCfg *cfg);
 vx_status tiovx_tidl_init_node(NodeObj *node);
+vx_status tiovx_tidl_load_node(NodeObj *node);
 vx_status tiovx_tidl_create_node(NodeObj *node);
 vx_status tiovx_tidl_delete_node(NodeObj *node);
 vx_uint32 tiovx_tidl_get_cfg_size();
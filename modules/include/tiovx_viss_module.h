@@ -89,6 +89,7 @@ typedef struct {
 
 void tiovx_viss_init_cfg(TIOVXVissNodeCfg *cfg);
 vx_status tiovx_viss_init_node(NodeObj *node);
+vx_status tiovx_viss_load_node(NodeObj *node);
 vx_status tiovx_viss_create_node(NodeObj *node);
 vx_status tiovx_viss_delete_node(NodeObj *node);
 vx_uint32 tiovx_viss_get_cfg_size();
@@ -85,6 +85,9 @@ v4l2CaptureHandle *v4l2_capture_create_handle(v4l2CaptureCfg *cfg);
 int v4l2_capture_start(v4l2CaptureHandle *handle);
 int v4l2_capture_enqueue_buf(v4l2CaptureHandle *handle, Buf *tiovx_buffer);
 Buf *v4l2_capture_dqueue_buf(v4l2CaptureHandle *handle);
+/* Dequeues the newest captured frame, older ones are queued back */
+Buf *v4l2_capture_dqueue_latest_buf(v4l2CaptureHandle *handle,
+                                    uint32_t *num_dropped);
 int v4l2_capture_stop(v4l2CaptureHandle *handle);
 int v4l2_capture_delete_handle(v4l2CaptureHandle *handle);
 
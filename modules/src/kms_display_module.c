@@ -62,6 +62,7 @@
 
 #include "kms_display_module.h"
 #include "tiovx_utils.h"
+#include "tiovx_modules_trace.h"
 
 #include <drm.h>
 #include <xf86drm.h>
@@ -186,6 +187,7 @@ int kms_display_render_buf(kmsDisplayHandle *handle, Buf *tiovx_buffer)
     struct pollfd pfd;
     int page_flip_done = 0;
     static int first_frame = 1;
+    vx_uint64 start = tiovx_modules_trace_time();
 
     if (first_frame == 1) {
         first_frame = 0;
@@ -199,11 +201,16 @@ int kms_display_render_buf(kmsDisplayHandle *handle, Buf *tiovx_buffer)
             poll(&pfd, 1, KMS_DISPLAY_PAGE_FLIP_TIMEOUT);
             status = drmHandleEvent(handle->fd, &drm_event);
         }
+
+        tiovx_modules_trace_event("kms", "page flip wait", 'X', start,
+                                  tiovx_modules_trace_time() - start, 0);
     }
 
     drmModePageFlip(handle->fd, handle->cfg.crtc,
             handle->fbs[tiovx_buffer->buf_index], DRM_MODE_PAGE_FLIP_EVENT,
             &page_flip_done);
+    tiovx_modules_trace_event("kms", "page flip", 'i',
+                              tiovx_modules_trace_time(), 0, 0);
 
     return status;
 }
@@ -359,9 +359,7 @@ vx_status tiovx_ldc_init_node(NodeObj *node)
     }
     vxReleaseReference(&exemplar);
 
-    if (node_cfg->ldc_mode == TIOVX_MODULE_LDC_OP_MODE_DCC_DATA) {
-        tiovx_ldc_module_configure_dcc_params(node);
-    } else if (node_cfg->ldc_mode == TIOVX_MODULE_LDC_OP_MODE_MESH_IMAGE) {
+    if (node_cfg->ldc_mode == TIOVX_MODULE_LDC_OP_MODE_MESH_IMAGE) {
         tiovx_ldc_module_configure_mesh_params(node);
         tiovx_ldc_module_configure_region_params(node);
         if (node_cfg->lut_file[0] == '\0') {
@@ -417,6 +415,19 @@ vx_status tiovx_ldc_init_node(NodeObj *node)
     return status;
 }
 
+vx_status tiovx_ldc_load_node(NodeObj *node)
+{
+    vx_status status = VX_SUCCESS;
+    TIOVXLdcNodeCfg *node_cfg = (TIOVXLdcNodeCfg *)node->node_cfg;
+
+    /* The node is created without DCC data if the file can't be read */
+    if (node_cfg->ldc_mode == TIOVX_MODULE_LDC_OP_MODE_DCC_DATA) {
+        tiovx_ldc_module_configure_dcc_params(node);
+    }
+
+    return status;
+}
+
 vx_status tiovx_ldc_create_node(NodeObj *node)
 {
     vx_status status = VX_FAILURE;
@@ -60,15 +60,46 @@
  *
  */
 #include "tiovx_tidl_module.h"
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Network bytes copied per step, the next step is read ahead meanwhile */
+#define TIOVX_TIDL_NETWORK_CHUNK_SIZE (4 * 1024 * 1024)
 
 uint32_t num_params;
 uint32_t max_params;
 
+/*
+ * io_config and network objects shared by the TIDL nodes of a context that
+ * use the same file and checksum. io_config holds the network checksum too,
+ * so its entries are also keyed on the network.
+ */
+typedef struct _TIOVXTIDLCacheEntry {
+    vx_context                  context;
+    vx_char                     *path;
+    vx_uint8                    checksum[TIVX_TIDL_J7_CHECKSUM_SIZE];
+    vx_char                     *network_path;
+    vx_uint8                    network_checksum[TIVX_TIDL_J7_CHECKSUM_SIZE];
+    vx_user_data_object         obj;
+    vx_bool                     loading;
+    vx_uint32                   refs;
+    struct _TIOVXTIDLCacheEntry *next;
+} TIOVXTIDLCacheEntry;
+
+static TIOVXTIDLCacheEntry *g_tidl_cache = NULL;
+static pthread_mutex_t g_tidl_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_tidl_cache_cond = PTHREAD_COND_INITIALIZER;
+
 typedef struct {
     vx_kernel                   kernel;
     tivxTIDLJ7Params            params;
     vx_user_data_object         io_config;
+    TIOVXTIDLCacheEntry         *io_config_entry;
     vx_user_data_object         network;
+    TIOVXTIDLCacheEntry         *network_entry;
     vx_user_data_object         createParams;
     vx_object_array             in_args_arr;
     vx_object_array             out_args_arr;
@@ -93,6 +124,140 @@ void add_param(vx_reference params[], vx_reference obj)
     }
 }
 
+static void tiovx_tidl_cache_release(TIOVXTIDLCacheEntry *entry)
+{
+    TIOVXTIDLCacheEntry **prev;
+
+    pthread_mutex_lock(&g_tidl_cache_lock);
+
+    entry->refs--;
+    if (0 == entry->refs)
+    {
+        for (prev = &g_tidl_cache; *prev != entry; prev = &(*prev)->next);
+        *prev = entry->next;
+
+        if (NULL != entry->obj)
+        {
+            vxReleaseUserDataObject(&entry->obj);
+        }
+        free(entry->path);
+        free(entry->network_path);
+        free(entry);
+    }
+
+    pthread_mutex_unlock(&g_tidl_cache_lock);
+}
+
+/*
+ * Take a reference on the entry of path and checksum, and of network_path
+ * and network_checksum unless network_path is NULL. If the entry is new,
+ * *owner is set and the caller must load the object and publish it. Returns
+ * NULL if another node failed to load it.
+ */
+static TIOVXTIDLCacheEntry* tiovx_tidl_cache_acquire(vx_context context,
+                                                     vx_char *path,
+                                                     vx_uint8 *checksum,
+                                                     vx_char *network_path,
+                                                     vx_uint8 *network_checksum,
+                                                     vx_bool *owner)
+{
+    TIOVXTIDLCacheEntry *entry = NULL;
+
+    *owner = vx_false_e;
+
+    pthread_mutex_lock(&g_tidl_cache_lock);
+
+    for (entry = g_tidl_cache; NULL != entry; entry = entry->next)
+    {
+        if (entry->context != context ||
+            0 != strcmp(entry->path, path) ||
+            0 != memcmp(entry->checksum, checksum, TIVX_TIDL_J7_CHECKSUM_SIZE))
+        {
+            continue;
+        }
+
+        if (NULL == network_path && NULL == entry->network_path)
+        {
+            break;
+        }
+
+        if (NULL != network_path && NULL != entry->network_path &&
+            0 == strcmp(entry->network_path, network_path) &&
+            0 == memcmp(entry->network_checksum, network_checksum,
+                        TIVX_TIDL_J7_CHECKSUM_SIZE))
+        {
+            break;
+        }
+    }
+
+    if (NULL != entry)
+    {
+        entry->refs++;
+        while (entry->loading)
+        {
+            pthread_cond_wait(&g_tidl_cache_cond, &g_tidl_cache_lock);
+        }
+        pthread_mutex_unlock(&g_tidl_cache_lock);
+
+        if (NULL == entry->obj)
+        {
+            tiovx_tidl_cache_release(entry);
+            entry = NULL;
+        }
+
+        return entry;
+    }
+
+    entry = (TIOVXTIDLCacheEntry *)calloc(1, sizeof(TIOVXTIDLCacheEntry));
+    if (NULL != entry)
+    {
+        entry->path = strdup(path);
+        if (NULL != network_path)
+        {
+            entry->network_path = strdup(network_path);
+        }
+        if (NULL == entry->path ||
+            (NULL != network_path && NULL == entry->network_path))
+        {
+            free(entry->path);
+            free(entry->network_path);
+            free(entry);
+            entry = NULL;
+        }
+    }
+
+    if (NULL != entry)
+    {
+        entry->context = context;
+        memcpy(entry->checksum, checksum, TIVX_TIDL_J7_CHECKSUM_SIZE);
+        if (NULL != network_path)
+        {
+            memcpy(entry->network_checksum, network_checksum,
+                   TIVX_TIDL_J7_CHECKSUM_SIZE);
+        }
+        entry->loading = vx_true_e;
+        entry->refs = 1;
+        entry->next = g_tidl_cache;
+        g_tidl_cache = entry;
+        *owner = vx_true_e;
+    }
+
+    pthread_mutex_unlock(&g_tidl_cache_lock);
+
+    return entry;
+}
+
+/* Set the object loaded by the owner of an entry, NULL if loading failed */
+static void tiovx_tidl_cache_publish(TIOVXTIDLCacheEntry *entry,
+                                     vx_user_data_object obj)
+{
+    pthread_mutex_lock(&g_tidl_cache_lock);
+    entry->obj = obj;
+    entry->loading = vx_false_e;
+    pthread_cond_broadcast(&g_tidl_cache_cond);
+    pthread_mutex_unlock(&g_tidl_cache_lock);
+}
+
 vx_enum get_vx_tensor_datatype(int32_t tidl_datatype)
 {
     vx_enum tiovx_datatype = VX_TYPE_INVALID;
@@ -202,19 +367,9 @@ vx_status tiovx_tidl_set_cfg(NodeObj *node)
 {
     vx_status status = VX_FAILURE;
     TIOVXTIDLNodeCfg *node_cfg = (TIOVXTIDLNodeCfg *)node->node_cfg;
-    TIOVXTIDLNodePriv *node_priv = (TIOVXTIDLNodePriv *)node->node_priv;
 
     vx_int32 i;
 
-    node_priv->io_config = tiovx_tidl_read_io_config(node->graph,
-                                                    node_cfg->io_config_path,
-                                                    &node_cfg->io_buf_desc);
-    if(NULL == node_priv->io_config)
-    {
-        TIOVX_MODULE_ERROR("[TIDL] Config object is null\n");
-        return status;
-    }
-
     node_cfg->num_input_tensors  = node_cfg->io_buf_desc.numInputBuf;
     node_cfg->num_output_tensors = node_cfg->io_buf_desc.numOutputBuf;
 
@@ -325,6 +480,61 @@ vx_status tiovx_tidl_create_io_config(NodeObj *node)
     return status;
 }
 
+/*
+ * Copy the network file into the mapped user data object. The file is
+ * mapped and copied in chunks, read ahead of the copy and dropped from the
+ * process once copied, so only the user data object stays resident.
+ */
+static vx_status tiovx_tidl_read_network(int fd, void *dst, size_t size)
+{
+    vx_status status = VX_SUCCESS;
+    uint8_t *src = NULL;
+    size_t offset, chunk;
+    ssize_t read_count;
+
+    src = (uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == src)
+    {
+        /* Not every file system can map files, read it instead */
+        for (offset = 0; offset < size; offset += read_count)
+        {
+            read_count = read(fd, (uint8_t *)dst + offset, size - offset);
+            if (read_count <= 0)
+            {
+                status = VX_FAILURE;
+                break;
+            }
+        }
+        return status;
+    }
+
+    madvise(src, size, MADV_SEQUENTIAL);
+
+    for (offset = 0; offset < size; offset += chunk)
+    {
+        chunk = size - offset;
+        if (chunk > TIOVX_TIDL_NETWORK_CHUNK_SIZE)
+        {
+            chunk = TIOVX_TIDL_NETWORK_CHUNK_SIZE;
+        }
+
+        if (offset + chunk < size)
+        {
+            madvise(src + offset + chunk,
+                    (size - offset - chunk < TIOVX_TIDL_NETWORK_CHUNK_SIZE) ?
+                    size - offset - chunk : TIOVX_TIDL_NETWORK_CHUNK_SIZE,
+                    MADV_WILLNEED);
+        }
+
+        memcpy((uint8_t *)dst + offset, src + offset, chunk);
+        madvise(src + offset, chunk, MADV_DONTNEED);
+    }
+
+    munmap(src, size);
+
+    return status;
+}
+
 vx_status tiovx_tidl_create_network(NodeObj *node)
 {
     vx_status status = VX_FAILURE;
@@ -333,20 +543,26 @@ vx_status tiovx_tidl_create_network(NodeObj *node)
 
     vx_map_id map_id;
     vx_uint32 capacity;
-    FILE *fp_network;
+    int fd_network;
+    struct stat st;
     void *network_buffer = NULL;
-    vx_size read_count;
 
-    fp_network = fopen(&node_cfg->network_path[0], "rb");
-    if(NULL == fp_network)
+    fd_network = open(&node_cfg->network_path[0], O_RDONLY);
+    if(fd_network < 0)
     {
         TIOVX_MODULE_ERROR("[TIDL] Unable to open %s\n", node_cfg->network_path);
         return status;
     }
 
-    fseek(fp_network, 0, SEEK_END);
-    capacity = ftell(fp_network);
-    fseek(fp_network, 0, SEEK_SET);
+    if(0 != fstat(fd_network, &st) || 0 == st.st_size)
+    {
+        TIOVX_MODULE_ERROR("[TIDL] Unable to stat %s\n", node_cfg->network_path);
+        close(fd_network);
+        return status;
+    }
+
+    capacity = (vx_uint32)st.st_size;
+    posix_fadvise(fd_network, 0, 0, POSIX_FADV_SEQUENTIAL);
 
     node_priv->network = vxCreateUserDataObject(node->graph->tiovx_context,
                                                "TIDL_network",
@@ -356,7 +572,7 @@ vx_status tiovx_tidl_create_network(NodeObj *node)
     if (VX_SUCCESS != status)
     {
         TIOVX_MODULE_ERROR("[TIDL] Create network Failed\n");
-        fclose(fp_network);
+        close(fd_network);
         return status;
     }
 
@@ -373,11 +589,10 @@ vx_status tiovx_tidl_create_network(NodeObj *node)
 
     if(network_buffer)
     {
-        read_count = fread(network_buffer, capacity, 1, fp_network);
-        if(1 != read_count)
+        status = tiovx_tidl_read_network(fd_network, network_buffer, capacity);
+        if(VX_SUCCESS != status)
         {
             TIOVX_MODULE_ERROR("[TIDL] Unable to read network\n");
-            status = VX_FAILURE;
         }
     }
     else
@@ -389,7 +604,7 @@ vx_status tiovx_tidl_create_network(NodeObj *node)
 
     vxUnmapUserDataObject(node_priv->network, map_id);
 
-    fclose(fp_network);
+    close(fd_network);
 
     return status;
 }
@@ -655,42 +870,112 @@ void tiovx_tidl_init_cfg(TIOVXTIDLNodeCfg *node_cfg)
     return;
 }
 
-vx_status tiovx_tidl_init_node(NodeObj *node)
+/*
+ * Get the io_config object, shared with the nodes that use the same
+ * io_config and network files and checksums, and fill io_buf_desc from it.
+ */
+static vx_status tiovx_tidl_acquire_io_config(NodeObj *node)
 {
     vx_status status = VX_FAILURE;
     TIOVXTIDLNodeCfg *node_cfg = (TIOVXTIDLNodeCfg *)node->node_cfg;
     TIOVXTIDLNodePriv *node_priv = (TIOVXTIDLNodePriv *)node->node_priv;
-    vx_reference exemplar;
-    vx_size tensor_sizes[TIOVX_MODULES_MAX_TENSOR_DIMS];
-    vx_int32 i;
+    TIOVXTIDLCacheEntry *entry = NULL;
+    tivxTIDLJ7Params *tidlParams = NULL;
+    vx_map_id map_id;
+    vx_bool owner;
+
+    entry = tiovx_tidl_cache_acquire(node->graph->tiovx_context,
+                                     node_cfg->io_config_path,
+                                     node_cfg->io_config_checksum,
+                                     node_cfg->network_path,
+                                     node_cfg->network_checksum,
+                                     &owner);
+    if(NULL == entry)
+    {
+        TIOVX_MODULE_ERROR("[TIDL] Config object is null\n");
+        return status;
+    }
 
-    CLR(node_priv);
+    if(owner)
+    {
+        node_priv->io_config = tiovx_tidl_read_io_config(node->graph,
+                                                        node_cfg->io_config_path,
+                                                        &node_cfg->io_buf_desc);
+        if(NULL != node_priv->io_config)
+        {
+            status = tiovx_tidl_create_io_config(node);
+        }
+        if(VX_SUCCESS == status)
+        {
+            status = tiovx_tidl_update_checksums(node);
+        }
+        if(VX_SUCCESS != status && NULL != node_priv->io_config)
+        {
+            vxReleaseUserDataObject(&node_priv->io_config);
+        }
 
-    status = tiovx_tidl_set_cfg(node);
-    if(VX_SUCCESS != status)
+        tiovx_tidl_cache_publish(entry, node_priv->io_config);
+    }
+    else
     {
-        TIOVX_MODULE_ERROR("[TIDL] Set TIDL cfg failed\n");
-        return status;
+        node_priv->io_config = entry->obj;
+
+        vxMapUserDataObject(node_priv->io_config,
+                            0,
+                            sizeof(tivxTIDLJ7Params),
+                            &map_id,
+                            (void **)&tidlParams,
+                            VX_READ_ONLY,
+                            VX_MEMORY_TYPE_HOST,
+                            0);
+
+        if(NULL != tidlParams)
+        {
+            memcpy(&node_priv->params, tidlParams, sizeof(tivxTIDLJ7Params));
+            memcpy(&node_cfg->io_buf_desc, &tidlParams->ioBufDesc,
+                   sizeof(sTIDL_IOBufDesc_t));
+            status = VX_SUCCESS;
+        }
+
+        vxUnmapUserDataObject(node_priv->io_config, map_id);
     }
 
-    status = tiovx_tidl_create_io_config(node);
     if(VX_SUCCESS != status)
     {
-        TIOVX_MODULE_ERROR("[TIDL] Create io_config failed\n");
+        TIOVX_MODULE_ERROR("[TIDL] Unable to get io_config %s\n",
+                           node_cfg->io_config_path);
+        node_priv->io_config = NULL;
+        tiovx_tidl_cache_release(entry);
         return status;
     }
 
-    status = tiovx_tidl_create_network(node);
+    node_priv->io_config_entry = entry;
+
+    return status;
+}
+
+vx_status tiovx_tidl_init_node(NodeObj *node)
+{
+    vx_status status = VX_FAILURE;
+    TIOVXTIDLNodeCfg *node_cfg = (TIOVXTIDLNodeCfg *)node->node_cfg;
+    TIOVXTIDLNodePriv *node_priv = (TIOVXTIDLNodePriv *)node->node_priv;
+    vx_reference exemplar;
+    vx_size tensor_sizes[TIOVX_MODULES_MAX_TENSOR_DIMS];
+    vx_int32 i;
+
+    CLR(node_priv);
+
+    status = tiovx_tidl_acquire_io_config(node);
     if(VX_SUCCESS != status)
     {
-        TIOVX_MODULE_ERROR("[TIDL] Create network failed\n");
+        TIOVX_MODULE_ERROR("[TIDL] Create io_config failed\n");
         return status;
     }
 
-    status = tiovx_tidl_update_checksums(node);
+    status = tiovx_tidl_set_cfg(node);
     if(VX_SUCCESS != status)
     {
-        TIOVX_MODULE_ERROR("[TIDL] Update checksums failed\n");
+        TIOVX_MODULE_ERROR("[TIDL] Set TIDL cfg failed\n");
         return status;
     }
 
@@ -775,6 +1060,56 @@ vx_status tiovx_tidl_init_node(NodeObj *node)
     return status;
 }
 
+vx_status tiovx_tidl_load_node(NodeObj *node)
+{
+    vx_status status = VX_FAILURE;
+    TIOVXTIDLNodeCfg *node_cfg = (TIOVXTIDLNodeCfg *)node->node_cfg;
+    TIOVXTIDLNodePriv *node_priv = (TIOVXTIDLNodePriv *)node->node_priv;
+    TIOVXTIDLCacheEntry *entry = NULL;
+    vx_bool owner;
+
+    /* Nodes running the same model share one network object */
+    entry = tiovx_tidl_cache_acquire(node->graph->tiovx_context,
+                                     node_cfg->network_path,
+                                     node_cfg->network_checksum,
+                                     NULL,
+                                     NULL,
+                                     &owner);
+    if(NULL == entry)
+    {
+        TIOVX_MODULE_ERROR("[TIDL] Create network failed\n");
+        return status;
+    }
+
+    if(owner)
+    {
+        status = tiovx_tidl_create_network(node);
+        if(VX_SUCCESS != status && NULL != node_priv->network)
+        {
+            vxReleaseUserDataObject(&node_priv->network);
+        }
+
+        tiovx_tidl_cache_publish(entry, node_priv->network);
+    }
+    else
+    {
+        node_priv->network = entry->obj;
+        status = VX_SUCCESS;
+    }
+
+    if(VX_SUCCESS != status)
+    {
+        TIOVX_MODULE_ERROR("[TIDL] Create network failed\n");
+        node_priv->network = NULL;
+        tiovx_tidl_cache_release(entry);
+        return status;
+    }
+
+    node_priv->network_entry = entry;
+
+    return status;
+}
+
 vx_status tiovx_tidl_create_node(NodeObj *node)
 {
     vx_status status = VX_FAILURE;
@@ -869,8 +1204,20 @@ vx_status tiovx_tidl_delete_node(NodeObj *node)
 
     status = vxReleaseNode(&node->tiovx_node);
 
-    status = vxReleaseUserDataObject(&node_priv->io_config);
-    status = vxReleaseUserDataObject(&node_priv->network);
+    if(NULL != node_priv->io_config_entry)
+    {
+        tiovx_tidl_cache_release(node_priv->io_config_entry);
+        node_priv->io_config_entry = NULL;
+        node_priv->io_config = NULL;
+    }
+
+    if(NULL != node_priv->network_entry)
+    {
+        tiovx_tidl_cache_release(node_priv->network_entry);
+        node_priv->network_entry = NULL;
+        node_priv->network = NULL;
+    }
+
     status = vxReleaseUserDataObject(&node_priv->createParams);
     status = vxReleaseObjectArray(&node_priv->in_args_arr);
     status = vxReleaseObjectArray(&node_priv->out_args_arr);
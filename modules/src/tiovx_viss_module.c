@@ -418,11 +418,18 @@ vx_status tiovx_viss_init_node(NodeObj *node)
     sprintf(node->name, "viss_node");
 
     tiovx_viss_module_configure_params(node);
-    tiovx_viss_module_configure_dcc_params(node);
 
     return status;
 }
 
+vx_status tiovx_viss_load_node(NodeObj *node)
+{
+    /* The node is created without DCC data if the file can't be read */
+    tiovx_viss_module_configure_dcc_params(node);
+
+    return VX_SUCCESS;
+}
+
 vx_status tiovx_viss_create_node(NodeObj *node)
 {
     vx_status status = VX_FAILURE;
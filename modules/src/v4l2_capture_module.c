@@ -62,6 +62,7 @@
 
 #include "v4l2_capture_module.h"
 #include "tiovx_utils.h"
+#include "tiovx_modules_trace.h"
 
 #include <sys/ioctl.h>
 #include <errno.h>
@@ -254,6 +255,7 @@ int v4l2_capture_enqueue_buf(v4l2CaptureHandle *handle, Buf *tiovx_buffer)
 {
     struct v4l2_buffer buf;
     int status = 0;
+    vx_uint64 start = tiovx_modules_trace_time();
 
     if (handle->queued[tiovx_buffer->buf_index] == true) {
         TIOVX_MODULE_ERROR("[V4L2_CAPTURE] Buffer alread enqueued\n");
@@ -273,30 +275,39 @@ int v4l2_capture_enqueue_buf(v4l2CaptureHandle *handle, Buf *tiovx_buffer)
     } else {
         handle->queued[tiovx_buffer->buf_index] = true;
         handle->bufq[tiovx_buffer->buf_index] = tiovx_buffer;
+        tiovx_modules_trace_event("v4l2", "QBUF", 'X', start,
+                                  tiovx_modules_trace_time() - start, 0);
     }
 
 ret:
     return status;
 }
 
-Buf *v4l2_capture_dqueue_buf(v4l2CaptureHandle *handle)
+static Buf *v4l2_capture_dqueue_buf_timeout(v4l2CaptureHandle *handle,
+                                             int timeout)
 {
     Buf *tiovx_buffer = NULL;
     struct v4l2_buffer buf;
     struct pollfd pfd;
     int ret = 0;
+    vx_uint64 start = tiovx_modules_trace_time();
 
     CLR(&pfd);
     pfd.fd = handle->fd;
     pfd.events = POLLIN;
     pfd.revents = 0;
 
-    ret = poll(&pfd, 1, V4L2_CAPTURE_TIMEOUT);
+    ret = poll(&pfd, 1, timeout);
     if (ret < 0) {
         TIOVX_MODULE_ERROR("[V4L2_CAPTURE] POLL failed\n");
         goto ret;
     }
 
+    /* Nothing captured yet, only an error when waiting */
+    if (ret == 0 && timeout == 0) {
+        goto ret;
+    }
+
     CLR(&buf);
     buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     buf.memory = V4L2_MEMORY_DMABUF;
@@ -309,10 +320,38 @@ Buf *v4l2_capture_dqueue_buf(v4l2CaptureHandle *handle)
     handle->queued[buf.index] = false;
     tiovx_buffer = handle->bufq[buf.index];
 
+    /* Includes the wait for the frame */
+    tiovx_modules_trace_event("v4l2", "DQBUF", 'X', start,
+                              tiovx_modules_trace_time() - start, 0);
+
 ret:
     return tiovx_buffer;
 }
 
+Buf *v4l2_capture_dqueue_buf(v4l2CaptureHandle *handle)
+{
+    return v4l2_capture_dqueue_buf_timeout(handle, V4L2_CAPTURE_TIMEOUT);
+}
+
+Buf *v4l2_capture_dqueue_latest_buf(v4l2CaptureHandle *handle,
+                                    uint32_t *num_dropped)
+{
+    Buf *tiovx_buffer = NULL, *next = NULL;
+
+    tiovx_buffer = v4l2_capture_dqueue_buf_timeout(handle,
+                                                   V4L2_CAPTURE_TIMEOUT);
+
+    /* Give older frames straight back to the driver */
+    while (NULL != tiovx_buffer &&
+           NULL != (next = v4l2_capture_dqueue_buf_timeout(handle, 0))) {
+        v4l2_capture_enqueue_buf(handle, tiovx_buffer);
+        tiovx_buffer = next;
+        (*num_dropped)++;
+    }
+
+    return tiovx_buffer;
+}
+
 int v4l2_capture_stop(v4l2CaptureHandle *handle)
 {
     int status = 0;
@@ -0,0 +1,164 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH   (4)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+#define NUM_ROUNDS   (4)
+
+vx_status app_modules_batch_enqueue_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *node = NULL, *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    BufPool *in_buf_pool = NULL;
+    Buf *bufs[APP_BUFQ_DEPTH];
+    Buf *done_bufs[APP_BUFQ_DEPTH];
+    vx_int32 seen[APP_BUFQ_DEPTH];
+    vx_int32 i, round, num_bufs, num_done;
+    vx_uint32 num_dequeued;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+
+    tiovx_pixelwise_multiply_init_cfg(&cfg);
+    cfg.input_cfg.width = IMAGE_WIDTH;
+    cfg.input_cfg.height = IMAGE_HEIGHT;
+    cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+    cfg.output_color_format = VX_DF_IMAGE_S16;
+    sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+    node = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY, (void *)&cfg);
+
+    tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+    fakesrc_cfg.sink_pad = &node->sinks[1];
+    fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC, (void *)&fakesrc_cfg);
+
+    tiovx_fakesink_init_cfg(&fakesink_cfg);
+    fakesink_cfg.src_pad = &node->srcs[0];
+    tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+    node->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+
+    resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    status = tiovx_modules_verify_graph(&graph);
+
+    in_buf_pool = node->sinks[0].buf_pool;
+
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_enqueue_bufs(bufs, 0);
+    }
+
+    for (round = 0; round < NUM_ROUNDS && VX_SUCCESS == status; round++) {
+        /* The whole pool goes to the graph in one call */
+        num_bufs = 0;
+        while (num_bufs < APP_BUFQ_DEPTH) {
+            bufs[num_bufs] = tiovx_modules_acquire_buf(in_buf_pool);
+            resetImage((vx_image)bufs[num_bufs]->handle, num_bufs);
+            num_bufs++;
+        }
+
+        status = tiovx_modules_enqueue_bufs(bufs, num_bufs);
+        if (VX_SUCCESS != status) {
+            TIOVX_MODULE_ERROR("Batch enqueue failed in round %d\n", round);
+            break;
+        }
+
+        /* Completed buffers come back in batches, each exactly once */
+        for (i = 0; i < APP_BUFQ_DEPTH; i++) {
+            seen[i] = 0;
+        }
+        num_done = 0;
+        while (num_done < num_bufs) {
+            num_dequeued = tiovx_modules_dequeue_bufs(in_buf_pool, done_bufs,
+                                                      APP_BUFQ_DEPTH);
+            if (0 == num_dequeued || num_done + num_dequeued > num_bufs) {
+                TIOVX_MODULE_ERROR("Dequeued %d buffers after %d of %d\n",
+                                   num_dequeued, num_done, num_bufs);
+                status = VX_FAILURE;
+                break;
+            }
+
+            for (vx_uint32 j = 0; j < num_dequeued; j++) {
+                if (done_bufs[j]->pool != in_buf_pool ||
+                    seen[done_bufs[j]->buf_index]++ > 0) {
+                    TIOVX_MODULE_ERROR("Unexpected buffer %d dequeued\n",
+                                       done_bufs[j]->buf_index);
+                    status = VX_FAILURE;
+                }
+                tiovx_modules_release_buf(done_bufs[j]);
+            }
+            num_done += num_dequeued;
+        }
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
@@ -0,0 +1,266 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH   (2)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+/* A U8 image has one plane, so one fd per buffer */
+typedef struct {
+    vx_image image;
+    vx_int32 fd;
+    vx_uint32 offset;
+} ExternalBuf;
+
+static vx_status create_external_buf(vx_context context, ExternalBuf *ext,
+                                     vx_uint8 value)
+{
+    vx_uint32 pitch;
+    vx_uint64 size;
+
+    ext->image = vxCreateImage(context, IMAGE_WIDTH, IMAGE_HEIGHT,
+                               VX_DF_IMAGE_U8);
+    if (VX_SUCCESS != vxGetStatus((vx_reference)ext->image)) {
+        TIOVX_MODULE_ERROR("Creating external image failed\n");
+        return VX_FAILURE;
+    }
+
+    resetImage(ext->image, value);
+
+    if (1 != getImageDmaFd((vx_reference)ext->image, &ext->fd, &pitch, &size,
+                           &ext->offset, 1)) {
+        TIOVX_MODULE_ERROR("Getting dma fd of external image failed\n");
+        return VX_FAILURE;
+    }
+
+    return VX_SUCCESS;
+}
+
+static vx_status check_pool(BufPool *buf_pool, vx_int32 num_allocated)
+{
+    if (num_allocated != buf_pool->num_allocated ||
+        APP_BUFQ_DEPTH - num_allocated != buf_pool->spare_count) {
+        TIOVX_MODULE_ERROR("Pool has %d imported and %d spare buffers,"
+                           " expected %d imported\n",
+                           buf_pool->num_allocated, buf_pool->spare_count,
+                           num_allocated);
+        return VX_FAILURE;
+    }
+
+    return VX_SUCCESS;
+}
+
+vx_status app_modules_buf_import_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *node = NULL, *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    BufPool *in_buf_pool = NULL;
+    ExternalBuf ext[APP_BUFQ_DEPTH];
+    Buf *inbuf = NULL, *outbuf = NULL;
+    vx_int32 i, num_ext = 0;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+
+    tiovx_pixelwise_multiply_init_cfg(&cfg);
+    cfg.input_cfg.width = IMAGE_WIDTH;
+    cfg.input_cfg.height = IMAGE_HEIGHT;
+    cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+    cfg.output_color_format = VX_DF_IMAGE_S16;
+    sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+    node = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY, (void *)&cfg);
+
+    tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+    fakesrc_cfg.sink_pad = &node->sinks[1];
+    fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC, (void *)&fakesrc_cfg);
+
+    tiovx_fakesink_init_cfg(&fakesink_cfg);
+    fakesink_cfg.src_pad = &node->srcs[0];
+    tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+    node->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+    node->sinks[0].import_mem = vx_true_e;
+
+    resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    status = tiovx_modules_verify_graph(&graph);
+
+    in_buf_pool = node->sinks[0].buf_pool;
+
+    for (i = 0; i < APP_BUFQ_DEPTH && VX_SUCCESS == status; i++) {
+        status = create_external_buf(graph.tiovx_context, &ext[i], i + 1);
+        if (VX_SUCCESS == status) {
+            num_ext++;
+        }
+    }
+
+    /* An import pool starts empty and never allocates memory itself */
+    if (VX_SUCCESS == status) {
+        status = check_pool(in_buf_pool, 0);
+    }
+    if (VX_SUCCESS == status &&
+        NULL != tiovx_modules_try_acquire_buf(in_buf_pool)) {
+        TIOVX_MODULE_ERROR("Acquired from an empty import pool\n");
+        status = VX_FAILURE;
+    }
+
+    /* A plain import and unimport round trip */
+    if (VX_SUCCESS == status) {
+        inbuf = tiovx_modules_import_buf(in_buf_pool, &ext[0].fd,
+                                         &ext[0].offset, 1);
+        if (NULL == inbuf) {
+            TIOVX_MODULE_ERROR("Import failed\n");
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = check_pool(in_buf_pool, 1);
+    }
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_unimport_buf(inbuf);
+    }
+    if (VX_SUCCESS == status) {
+        status = check_pool(in_buf_pool, 0);
+    }
+
+    /* The graph owns the buffer till it is dequeued */
+    if (VX_SUCCESS == status) {
+        inbuf = tiovx_modules_import_buf(in_buf_pool, &ext[0].fd,
+                                         &ext[0].offset, 1);
+        if (NULL == inbuf) {
+            TIOVX_MODULE_ERROR("Import after unimport failed\n");
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_enqueue_buf(inbuf);
+    }
+    if (VX_SUCCESS == status &&
+        VX_SUCCESS == tiovx_modules_unimport_buf(inbuf)) {
+        TIOVX_MODULE_ERROR("Unimported a buffer queued to the graph\n");
+        status = VX_FAILURE;
+    }
+    if (VX_SUCCESS == status) {
+        outbuf = tiovx_modules_dequeue_buf(in_buf_pool);
+        if (outbuf != inbuf) {
+            TIOVX_MODULE_ERROR("Dequeued a buffer that was not imported\n");
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_unimport_buf(outbuf);
+    }
+
+    /* A released buffer belongs to the pool till it is acquired again */
+    if (VX_SUCCESS == status) {
+        inbuf = tiovx_modules_import_buf(in_buf_pool, &ext[1].fd,
+                                         &ext[1].offset, 1);
+        if (NULL == inbuf) {
+            TIOVX_MODULE_ERROR("Import of second buffer failed\n");
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        tiovx_modules_release_buf(inbuf);
+        if (VX_SUCCESS == tiovx_modules_unimport_buf(inbuf)) {
+            TIOVX_MODULE_ERROR("Unimported a released buffer\n");
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        outbuf = tiovx_modules_try_acquire_buf(in_buf_pool);
+        if (outbuf != inbuf) {
+            TIOVX_MODULE_ERROR("Released import was not acquired back\n");
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_unimport_buf(outbuf);
+    }
+
+    /* A short fd list is rejected and the spare buffer is kept */
+    if (VX_SUCCESS == status &&
+        NULL != tiovx_modules_import_buf(in_buf_pool, &ext[0].fd,
+                                         &ext[0].offset, 0)) {
+        TIOVX_MODULE_ERROR("Imported a buffer without fds\n");
+        status = VX_FAILURE;
+    }
+    if (VX_SUCCESS == status) {
+        status = check_pool(in_buf_pool, 0);
+    }
+
+    /* The images belong to the graph context, release them first */
+    for (i = 0; i < num_ext; i++) {
+        vxReleaseImage(&ext[i].image);
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
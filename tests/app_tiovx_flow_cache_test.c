@@ -0,0 +1,196 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+#include <flow_cache.h>
+
+static int32_t write_file(char *file_name, const char *text)
+{
+    FILE *fp = fopen(file_name, "w");
+
+    if (NULL == fp) {
+        TIOVX_MODULE_ERROR("Unable to open %s\n", file_name);
+        return -1;
+    }
+    fputs(text, fp);
+    fclose(fp);
+
+    return 0;
+}
+
+vx_status app_modules_flow_cache_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_SUCCESS;
+    FlowInfo *flow_infos = NULL, *cached_infos = NULL;
+    uint32_t num_flows = 0;
+    char config_filename[100];
+    char other_filename[100];
+    char cache_filename[100];
+    char param_filename[200];
+    SubflowInfo *subflow_info;
+
+    sprintf(config_filename, "%s/output/flow_cache_test.yaml", EDGEAI_DATA_PATH);
+    sprintf(other_filename, "%s/output/flow_cache_other.yaml", EDGEAI_DATA_PATH);
+    sprintf(cache_filename, "%s/output/flow_cache_test.cache", EDGEAI_DATA_PATH);
+
+    flow_infos = (FlowInfo *)calloc(1, sizeof(FlowInfo));
+    cached_infos = (FlowInfo *)calloc(1, sizeof(FlowInfo));
+    if (NULL == flow_infos || NULL == cached_infos) {
+        free(flow_infos);
+        free(cached_infos);
+        return VX_ERROR_NO_MEMORY;
+    }
+
+    /* One flow with a model whose param.yaml does not exist yet */
+    flow_infos[0].num_subflows = 1;
+    subflow_info = &flow_infos[0].subflow_infos[0];
+    subflow_info->has_model = true;
+    sprintf(subflow_info->model_info.model_path, "%s/output/flow_cache_model",
+            EDGEAI_DATA_PATH);
+    sprintf(param_filename, "%s/param.yaml", subflow_info->model_info.model_path);
+    remove(param_filename);
+
+    if (0 != write_file(config_filename, "flows: 1\n") ||
+        0 != write_file(other_filename, "flows: 1\n") ||
+        0 != save_flow_cache(cache_filename, config_filename, flow_infos, 1)) {
+        status = VX_FAILURE;
+    }
+
+    /* Valid hit returns the saved flows */
+    if (VX_SUCCESS == status) {
+        if (0 != load_flow_cache(cache_filename, config_filename,
+                                 cached_infos, 1, &num_flows) ||
+            1 != num_flows ||
+            0 != memcmp(flow_infos, cached_infos, sizeof(FlowInfo))) {
+            TIOVX_MODULE_ERROR("Valid flow cache was not loaded\n");
+            status = VX_FAILURE;
+        }
+    }
+
+    /* A cache of another config is never used */
+    if (VX_SUCCESS == status &&
+        0 == load_flow_cache(cache_filename, other_filename,
+                             cached_infos, 1, &num_flows)) {
+        TIOVX_MODULE_ERROR("Flow cache used for another config\n");
+        status = VX_FAILURE;
+    }
+
+    /* More flows than the caller has room for */
+    if (VX_SUCCESS == status &&
+        0 == load_flow_cache(cache_filename, config_filename,
+                             cached_infos, 0, &num_flows)) {
+        TIOVX_MODULE_ERROR("Flow cache overflowed flow array\n");
+        status = VX_FAILURE;
+    }
+
+    /* Creating a file that was missing invalidates */
+    if (VX_SUCCESS == status) {
+        mkdir(subflow_info->model_info.model_path, 0755);
+        write_file(param_filename, "model: 1\n");
+        if (0 == load_flow_cache(cache_filename, config_filename,
+                                 cached_infos, 1, &num_flows)) {
+            TIOVX_MODULE_ERROR("Stale flow cache used after model change\n");
+            status = VX_FAILURE;
+        }
+    }
+
+    /* Editing the config invalidates */
+    if (VX_SUCCESS == status &&
+        0 != save_flow_cache(cache_filename, config_filename, flow_infos, 1)) {
+        status = VX_FAILURE;
+    }
+    if (VX_SUCCESS == status) {
+        write_file(config_filename, "flows: 2\n# edited\n");
+        if (0 == load_flow_cache(cache_filename, config_filename,
+                                 cached_infos, 1, &num_flows)) {
+            TIOVX_MODULE_ERROR("Stale flow cache used after config change\n");
+            status = VX_FAILURE;
+        }
+    }
+
+    /* Garbage is rejected */
+    if (VX_SUCCESS == status) {
+        write_file(cache_filename, "not a flow cache");
+        if (0 == load_flow_cache(cache_filename, config_filename,
+                                 cached_infos, 1, &num_flows)) {
+            TIOVX_MODULE_ERROR("Invalid flow cache was loaded\n");
+            status = VX_FAILURE;
+        }
+    }
+
+    remove(cache_filename);
+    remove(config_filename);
+    remove(other_filename);
+    remove(param_filename);
+    rmdir(subflow_info->model_info.model_path);
+
+    free(flow_infos);
+    free(cached_infos);
+
+    return status;
+}
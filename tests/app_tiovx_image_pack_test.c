@@ -0,0 +1,187 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <string.h>
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+#define NUM_FRAMES   (8)
+
+static vx_status check_image(vx_image img, vx_uint8 value)
+{
+    vx_status status;
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t image_addr;
+    vx_map_id map_id;
+    void *data_ptr;
+    vx_uint8 *row;
+    vx_uint32 i, j;
+
+    rect.start_x = 0;
+    rect.start_y = 0;
+    rect.end_x = IMAGE_WIDTH;
+    rect.end_y = IMAGE_HEIGHT;
+    status = vxMapImagePatch(img, &rect, 0, &map_id, &image_addr, &data_ptr,
+                             VX_READ_ONLY, VX_MEMORY_TYPE_HOST, VX_NOGAP_X);
+    if (VX_SUCCESS != status) {
+        return status;
+    }
+
+    for (j = 0; j < image_addr.dim_y && VX_SUCCESS == status; j++) {
+        row = (vx_uint8 *)data_ptr + j * image_addr.stride_y;
+        for (i = 0; i < image_addr.dim_x; i++) {
+            if (row[i] != value) {
+                TIOVX_MODULE_ERROR("Pixel (%d, %d) is %d, expected %d\n",
+                                   i, j, row[i], value);
+                status = VX_FAILURE;
+                break;
+            }
+        }
+    }
+
+    vxUnmapImagePatch(img, map_id);
+
+    return status;
+}
+
+vx_status app_modules_image_pack_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    vx_context context;
+    vx_image in_img, out_img, small_img;
+    ImagePack pack;
+    vx_uint64 timestamp_us;
+    char pack_filename[100];
+    vx_uint32 i;
+
+    sprintf(pack_filename, "%s/output/image_pack_test%s", EDGEAI_DATA_PATH,
+            TIOVX_IMAGE_PACK_EXT);
+
+    context = vxCreateContext();
+    in_img = vxCreateImage(context, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    out_img = vxCreateImage(context, IMAGE_WIDTH, IMAGE_HEIGHT, VX_DF_IMAGE_U8);
+    small_img = vxCreateImage(context, IMAGE_WIDTH / 2, IMAGE_HEIGHT / 2,
+                              VX_DF_IMAGE_U8);
+
+    /* Write a pack where every frame has its own pixel value */
+    status = createImagePack(pack_filename, in_img, &pack);
+    for (i = 0; i < NUM_FRAMES && VX_SUCCESS == status; i++) {
+        resetImage(in_img, i + 1);
+        status = writeImagePackFrame(&pack, in_img, i * 33333);
+    }
+
+    /* Frames that do not match the pack header are rejected */
+    if (VX_SUCCESS == status &&
+        VX_SUCCESS == writeImagePackFrame(&pack, small_img, 0)) {
+        TIOVX_MODULE_ERROR("Wrote a frame that does not match the pack\n");
+        status = VX_FAILURE;
+    }
+    if (VX_SUCCESS == status) {
+        status = closeImagePack(&pack);
+    }
+
+    /* Read it back in reverse to exercise the index */
+    if (VX_SUCCESS == status) {
+        status = openImagePack(pack_filename, &pack);
+    }
+    if (VX_SUCCESS == status) {
+        if (NUM_FRAMES != pack.header.num_frames ||
+            IMAGE_WIDTH != pack.header.width ||
+            IMAGE_HEIGHT != pack.header.height ||
+            VX_DF_IMAGE_U8 != pack.header.format) {
+            TIOVX_MODULE_ERROR("Image pack header mismatch\n");
+            status = VX_FAILURE;
+        }
+
+        for (i = NUM_FRAMES; i > 0 && VX_SUCCESS == status; i--) {
+            status = readImagePackFrame(&pack, i - 1, out_img, &timestamp_us);
+            if (VX_SUCCESS == status && (i - 1) * 33333 != timestamp_us) {
+                TIOVX_MODULE_ERROR("Frame %d timestamp mismatch\n", i - 1);
+                status = VX_FAILURE;
+            }
+            if (VX_SUCCESS == status) {
+                status = check_image(out_img, i);
+            }
+        }
+
+        /* Frames past the end are rejected */
+        if (VX_SUCCESS == status &&
+            VX_SUCCESS == readImagePackFrame(&pack, NUM_FRAMES, out_img,
+                                             &timestamp_us)) {
+            TIOVX_MODULE_ERROR("Read past the end of the image pack\n");
+            status = VX_FAILURE;
+        }
+
+        closeImagePack(&pack);
+    }
+
+    remove(pack_filename);
+
+    vxReleaseImage(&in_img);
+    vxReleaseImage(&out_img);
+    vxReleaseImage(&small_img);
+    vxReleaseContext(&context);
+
+    return status;
+}
@@ -0,0 +1,201 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pthread.h>
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH   (2)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+#define NUM_ITERATIONS (1000)
+#define NUM_FRAMES     (4)
+
+typedef struct {
+    BufPool *buf_pool;
+    vx_int32 *owners;
+    vx_status status;
+} AcquireThreadArgs;
+
+/* Acquire and release in a loop, checking no buffer is handed out twice */
+static void *acquire_release_thread(void *arg)
+{
+    AcquireThreadArgs *args = (AcquireThreadArgs *)arg;
+    Buf *buf = NULL;
+
+    for (vx_int32 i = 0; i < NUM_ITERATIONS; i++) {
+        buf = tiovx_modules_acquire_buf(args->buf_pool);
+        if (NULL == buf) {
+            TIOVX_MODULE_ERROR("Acquire failed at iteration %d\n", i);
+            args->status = VX_FAILURE;
+            break;
+        }
+
+        if (0 != __atomic_exchange_n(&args->owners[buf->buf_index], 1,
+                                     __ATOMIC_ACQ_REL)) {
+            TIOVX_MODULE_ERROR("Buffer %d acquired twice\n", buf->buf_index);
+            args->status = VX_FAILURE;
+        }
+        __atomic_store_n(&args->owners[buf->buf_index], 0, __ATOMIC_RELEASE);
+
+        tiovx_modules_release_buf(buf);
+    }
+
+    return NULL;
+}
+
+vx_status app_modules_lock_free_bufpool_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *node = NULL, *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    BufPool *in_buf_pool = NULL;
+    Buf *bufs[APP_BUFQ_DEPTH];
+    Buf *inbuf = NULL;
+    vx_int32 owners[APP_BUFQ_DEPTH] = {0};
+    AcquireThreadArgs args[2];
+    pthread_t threads[2];
+    vx_int32 i, num_bufs = 0;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+
+    tiovx_pixelwise_multiply_init_cfg(&cfg);
+    cfg.input_cfg.width = IMAGE_WIDTH;
+    cfg.input_cfg.height = IMAGE_HEIGHT;
+    cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+    cfg.output_color_format = VX_DF_IMAGE_S16;
+    sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+    node = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY, (void *)&cfg);
+
+    tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+    fakesrc_cfg.sink_pad = &node->sinks[1];
+    fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC, (void *)&fakesrc_cfg);
+
+    tiovx_fakesink_init_cfg(&fakesink_cfg);
+    fakesink_cfg.src_pad = &node->srcs[0];
+    tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+    node->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+    node->sinks[0].lock_free = vx_true_e;
+
+    resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    status = tiovx_modules_verify_graph(&graph);
+
+    in_buf_pool = node->sinks[0].buf_pool;
+
+    /* Both threads contend for a pool smaller than their combined demand */
+    for (i = 0; i < 2 && VX_SUCCESS == status; i++) {
+        args[i].buf_pool = in_buf_pool;
+        args[i].owners = owners;
+        args[i].status = VX_SUCCESS;
+        pthread_create(&threads[i], NULL, acquire_release_thread, &args[i]);
+    }
+    for (i = 0; i < 2 && VX_SUCCESS == status; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0; i < 2 && VX_SUCCESS == status; i++) {
+        status = args[i].status;
+    }
+
+    /* Every buffer must be back in the pool, and no more than that */
+    while (num_bufs < APP_BUFQ_DEPTH && VX_SUCCESS == status) {
+        bufs[num_bufs] = tiovx_modules_try_acquire_buf(in_buf_pool);
+        if (NULL == bufs[num_bufs]) {
+            TIOVX_MODULE_ERROR("Buffer %d missing after threads\n", num_bufs);
+            status = VX_FAILURE;
+        } else {
+            num_bufs++;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        inbuf = tiovx_modules_try_acquire_buf(in_buf_pool);
+        if (NULL != inbuf) {
+            TIOVX_MODULE_ERROR("Acquired more than %d buffers\n", APP_BUFQ_DEPTH);
+            tiovx_modules_release_buf(inbuf);
+            status = VX_FAILURE;
+        }
+    }
+    for (i = 0; i < num_bufs; i++) {
+        tiovx_modules_release_buf(bufs[i]);
+    }
+
+    /* The graph keeps working on the lock-free queues */
+    for (i = 0; i < NUM_FRAMES && VX_SUCCESS == status; i++) {
+        inbuf = tiovx_modules_acquire_buf(in_buf_pool);
+        resetImage((vx_image)inbuf->handle, i);
+        status = tiovx_modules_enqueue_buf(inbuf);
+        if (VX_SUCCESS == status) {
+            inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
+            status = tiovx_modules_release_buf(inbuf);
+        }
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
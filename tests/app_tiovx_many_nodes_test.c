@@ -0,0 +1,159 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH   (1)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+/*
+ * Each set is a multiply node with a fakesrc and a fakesink, its first
+ * input is a graph parameter. This is past the 16 graph parameters and
+ * nodes the tables start with.
+ */
+#define NUM_SETS     (17)
+#define NUM_FRAMES   (2)
+
+vx_status app_modules_many_nodes_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *nodes[NUM_SETS];
+    NodeObj *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    Buf *bufs[NUM_SETS];
+    Buf *inbuf = NULL;
+    vx_int32 i, frame;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+
+    for (i = 0; i < NUM_SETS; i++) {
+        tiovx_pixelwise_multiply_init_cfg(&cfg);
+        cfg.input_cfg.width = IMAGE_WIDTH;
+        cfg.input_cfg.height = IMAGE_HEIGHT;
+        cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+        cfg.output_color_format = VX_DF_IMAGE_S16;
+        sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+        nodes[i] = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY,
+                                          (void *)&cfg);
+        if (NULL == nodes[i]) {
+            TIOVX_MODULE_ERROR("Adding node set %d failed\n", i);
+            status = VX_FAILURE;
+            break;
+        }
+
+        tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+        fakesrc_cfg.sink_pad = &nodes[i]->sinks[1];
+        fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC,
+                                              (void *)&fakesrc_cfg);
+
+        tiovx_fakesink_init_cfg(&fakesink_cfg);
+        fakesink_cfg.src_pad = &nodes[i]->srcs[0];
+        tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+        nodes[i]->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+        resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    }
+
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_verify_graph(&graph);
+    }
+
+    if (VX_SUCCESS == status &&
+        (3 * NUM_SETS != graph.num_nodes ||
+         NUM_SETS != graph.num_graph_params)) {
+        TIOVX_MODULE_ERROR("Graph has %d nodes and %d graph parameters,"
+                           " expected %d and %d\n", graph.num_nodes,
+                           graph.num_graph_params, 3 * NUM_SETS, NUM_SETS);
+        status = VX_FAILURE;
+    }
+
+    /* The graph runs once every graph parameter has a buffer */
+    for (frame = 0; frame < NUM_FRAMES && VX_SUCCESS == status; frame++) {
+        for (i = 0; i < NUM_SETS && VX_SUCCESS == status; i++) {
+            bufs[i] = tiovx_modules_acquire_buf(nodes[i]->sinks[0].buf_pool);
+            resetImage((vx_image)bufs[i]->handle, i);
+            status = tiovx_modules_enqueue_buf(bufs[i]);
+        }
+
+        for (i = 0; i < NUM_SETS && VX_SUCCESS == status; i++) {
+            inbuf = tiovx_modules_dequeue_buf(nodes[i]->sinks[0].buf_pool);
+            if (inbuf != bufs[i]) {
+                TIOVX_MODULE_ERROR("Set %d dequeued a wrong buffer\n", i);
+                status = VX_FAILURE;
+            }
+            if (NULL != inbuf) {
+                tiovx_modules_release_buf(inbuf);
+            }
+        }
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
@@ -0,0 +1,226 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH      (2)
+#define APP_MAX_BUFQ_DEPTH  (4)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+/* Enough idle acquires to shrink from max_bufq_depth back to bufq_depth */
+#define MAX_SHRINK_ITERATIONS (64 * 2 * APP_MAX_BUFQ_DEPTH)
+
+static vx_status check_mem_stats(GraphObj *graph, vx_int32 num_allocs,
+                                 vx_uint64 buf_size, vx_int32 peak_allocs)
+{
+    vx_status status;
+    MemStats stats;
+
+    status = tiovx_modules_get_mem_stats(graph, &stats);
+    if (VX_SUCCESS != status) {
+        return status;
+    }
+
+    if (num_allocs != stats.num_allocs ||
+        (APP_MAX_BUFQ_DEPTH - num_allocs) * buf_size != stats.free_bytes ||
+        peak_allocs * buf_size != stats.peak_bytes) {
+        TIOVX_MODULE_ERROR("Arena has %d allocs, %lu free, %lu peak,"
+                           " expected %d allocs of %lu bytes, peak %d\n",
+                           stats.num_allocs,
+                           (unsigned long)stats.free_bytes,
+                           (unsigned long)stats.peak_bytes,
+                           num_allocs, (unsigned long)buf_size, peak_allocs);
+        status = VX_FAILURE;
+    }
+
+    return status;
+}
+
+vx_status app_modules_mem_arena_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *node = NULL, *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    BufPool *in_buf_pool = NULL;
+    Buf *bufs[APP_MAX_BUFQ_DEPTH];
+    Buf *inbuf = NULL;
+    MemStats stats;
+    vx_uint64 buf_size = 0;
+    vx_int32 i, num_bufs = 0;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+    graph.use_mem_arena = vx_true_e;
+
+    tiovx_pixelwise_multiply_init_cfg(&cfg);
+    cfg.input_cfg.width = IMAGE_WIDTH;
+    cfg.input_cfg.height = IMAGE_HEIGHT;
+    cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+    cfg.output_color_format = VX_DF_IMAGE_S16;
+    sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+    node = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY, (void *)&cfg);
+
+    tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+    fakesrc_cfg.sink_pad = &node->sinks[1];
+    fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC, (void *)&fakesrc_cfg);
+
+    tiovx_fakesink_init_cfg(&fakesink_cfg);
+    fakesink_cfg.src_pad = &node->srcs[0];
+    tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+    node->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+    node->sinks[0].max_bufq_depth = APP_MAX_BUFQ_DEPTH;
+
+    resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    status = tiovx_modules_verify_graph(&graph);
+
+    in_buf_pool = node->sinks[0].buf_pool;
+
+    /* The only pool is the graph input, the arena is sized for its maximum */
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_get_mem_stats(&graph, &stats);
+    }
+    if (VX_SUCCESS == status) {
+        buf_size = stats.total_bytes / APP_MAX_BUFQ_DEPTH;
+        if (0 == buf_size ||
+            buf_size * APP_MAX_BUFQ_DEPTH != stats.total_bytes) {
+            TIOVX_MODULE_ERROR("Arena of %lu bytes is not sized for %d buffers\n",
+                               (unsigned long)stats.total_bytes,
+                               APP_MAX_BUFQ_DEPTH);
+            status = VX_FAILURE;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = check_mem_stats(&graph, APP_BUFQ_DEPTH, buf_size,
+                                 APP_BUFQ_DEPTH);
+    }
+
+    /* Growing takes the rest of the arena */
+    while (num_bufs < APP_MAX_BUFQ_DEPTH && VX_SUCCESS == status) {
+        bufs[num_bufs] = tiovx_modules_try_acquire_buf(in_buf_pool);
+        if (NULL == bufs[num_bufs]) {
+            TIOVX_MODULE_ERROR("Pool did not grow past %d buffers\n", num_bufs);
+            status = VX_FAILURE;
+        } else {
+            num_bufs++;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = check_mem_stats(&graph, APP_MAX_BUFQ_DEPTH, buf_size,
+                                 APP_MAX_BUFQ_DEPTH);
+    }
+    for (i = 0; i < num_bufs; i++) {
+        tiovx_modules_release_buf(bufs[i]);
+    }
+
+    /* Shrinking hands the memory back to the arena */
+    for (i = 0; i < MAX_SHRINK_ITERATIONS && VX_SUCCESS == status &&
+                in_buf_pool->num_allocated > APP_BUFQ_DEPTH; i++) {
+        inbuf = tiovx_modules_acquire_buf(in_buf_pool);
+        tiovx_modules_release_buf(inbuf);
+    }
+    if (VX_SUCCESS == status) {
+        status = check_mem_stats(&graph, APP_BUFQ_DEPTH, buf_size,
+                                 APP_MAX_BUFQ_DEPTH);
+    }
+
+    /* Regrowing reuses the freed memory, the peak stays where it was */
+    num_bufs = 0;
+    while (num_bufs < APP_MAX_BUFQ_DEPTH && VX_SUCCESS == status) {
+        bufs[num_bufs] = tiovx_modules_try_acquire_buf(in_buf_pool);
+        if (NULL == bufs[num_bufs]) {
+            TIOVX_MODULE_ERROR("Pool did not regrow past %d buffers\n",
+                               num_bufs);
+            status = VX_FAILURE;
+        } else {
+            resetImage((vx_image)bufs[num_bufs]->handle, num_bufs);
+            num_bufs++;
+        }
+    }
+    if (VX_SUCCESS == status) {
+        status = check_mem_stats(&graph, APP_MAX_BUFQ_DEPTH, buf_size,
+                                 APP_MAX_BUFQ_DEPTH);
+    }
+
+    /* Arena memory works as graph input */
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_enqueue_bufs(bufs, num_bufs);
+        for (i = 0; i < num_bufs && VX_SUCCESS == status; i++) {
+            inbuf = tiovx_modules_dequeue_buf(in_buf_pool);
+            status = tiovx_modules_release_buf(inbuf);
+        }
+    } else {
+        for (i = 0; i < num_bufs; i++) {
+            tiovx_modules_release_buf(bufs[i]);
+        }
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
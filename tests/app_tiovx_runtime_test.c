@@ -0,0 +1,186 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <tiovx_modules.h>
+#include <tiovx_modules_runtime.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH   (2)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+#define NUM_FRAMES       (16)
+#define WAIT_TIMEOUT_MS  (5000)
+
+typedef struct {
+    vx_uint32 num_frames;
+    vx_uint32 num_bad_bufs;
+    BufPool *buf_pool;
+} SourceData;
+
+/* Feed the consumed buffer back till NUM_FRAMES have gone through */
+static Buf *source_cb(Buf *buf, void *priv)
+{
+    SourceData *data = (SourceData *)priv;
+
+    if (buf->pool != data->buf_pool) {
+        data->num_bad_bufs++;
+    }
+
+    if (NUM_FRAMES == data->num_frames) {
+        tiovx_modules_release_buf(buf);
+        return NULL;
+    }
+
+    data->num_frames++;
+    resetImage((vx_image)buf->handle, data->num_frames);
+
+    return buf;
+}
+
+vx_status app_modules_runtime_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *node = NULL, *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    Runtime runtime;
+    SourceData data;
+    Buf *inbuf = NULL;
+    vx_bool runtime_ready = vx_false_e, finished = vx_false_e;
+    vx_int32 i;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+    graph.use_param_events = vx_true_e;
+
+    tiovx_pixelwise_multiply_init_cfg(&cfg);
+    cfg.input_cfg.width = IMAGE_WIDTH;
+    cfg.input_cfg.height = IMAGE_HEIGHT;
+    cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+    cfg.output_color_format = VX_DF_IMAGE_S16;
+    sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+    node = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY, (void *)&cfg);
+
+    tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+    fakesrc_cfg.sink_pad = &node->sinks[1];
+    fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC, (void *)&fakesrc_cfg);
+
+    tiovx_fakesink_init_cfg(&fakesink_cfg);
+    fakesink_cfg.src_pad = &node->srcs[0];
+    tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+    node->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+
+    resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    status = tiovx_modules_verify_graph(&graph);
+
+    data.num_frames = 0;
+    data.num_bad_bufs = 0;
+    data.buf_pool = node->sinks[0].buf_pool;
+
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_runtime_init(&runtime, &graph);
+        runtime_ready = (VX_SUCCESS == status) ? vx_true_e : vx_false_e;
+    }
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_runtime_add_source(&runtime, &node->sinks[0],
+                                                  source_cb, &data);
+    }
+
+    /* Prime the graph with the whole pool, the runtime keeps it fed */
+    for (i = 0; i < APP_BUFQ_DEPTH && VX_SUCCESS == status; i++) {
+        inbuf = tiovx_modules_acquire_buf(data.buf_pool);
+        resetImage((vx_image)inbuf->handle, 0);
+        status = tiovx_modules_enqueue_buf(inbuf);
+    }
+
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_runtime_start(&runtime);
+    }
+    if (VX_SUCCESS == status) {
+        finished = tiovx_modules_runtime_wait(&runtime, WAIT_TIMEOUT_MS);
+        tiovx_modules_runtime_stop(&runtime);
+
+        if (vx_false_e == finished) {
+            TIOVX_MODULE_ERROR("Runtime did not finish, %d frames fed\n",
+                               data.num_frames);
+            status = VX_FAILURE;
+        } else if (NUM_FRAMES != data.num_frames || 0 != data.num_bad_bufs) {
+            TIOVX_MODULE_ERROR("Runtime fed %d frames, %d from a wrong pool,"
+                               " expected %d\n", data.num_frames,
+                               data.num_bad_bufs, NUM_FRAMES);
+            status = VX_FAILURE;
+        }
+    }
+
+    if (runtime_ready) {
+        tiovx_modules_runtime_deinit(&runtime);
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
@@ -0,0 +1,243 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <time.h>
+#include <tiovx_modules.h>
+#include <tiovx_utils.h>
+
+#define APP_BUFQ_DEPTH   (2)
+
+#define IMAGE_WIDTH  (640)
+#define IMAGE_HEIGHT (480)
+
+#define SHORT_TIMEOUT_MS (50)
+#define LONG_TIMEOUT_MS  (1000)
+
+static vx_uint64 get_time_ms()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (vx_uint64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Every variant must come back empty handed, timed ones only after waiting */
+static vx_status check_empty(BufPool *buf_pool)
+{
+    vx_status status = VX_SUCCESS;
+    vx_uint64 start;
+
+    if (NULL != tiovx_modules_try_acquire_buf(buf_pool)) {
+        TIOVX_MODULE_ERROR("try_acquire_buf returned a buffer\n");
+        status = VX_FAILURE;
+    }
+
+    start = get_time_ms();
+    if (NULL != tiovx_modules_acquire_buf_timeout(buf_pool, SHORT_TIMEOUT_MS)) {
+        TIOVX_MODULE_ERROR("acquire_buf_timeout returned a buffer\n");
+        status = VX_FAILURE;
+    } else if (get_time_ms() - start + 1 < SHORT_TIMEOUT_MS) {
+        TIOVX_MODULE_ERROR("acquire_buf_timeout returned early\n");
+        status = VX_FAILURE;
+    }
+
+    if (NULL != tiovx_modules_try_dequeue_buf(buf_pool)) {
+        TIOVX_MODULE_ERROR("try_dequeue_buf returned a buffer\n");
+        status = VX_FAILURE;
+    }
+
+    start = get_time_ms();
+    if (NULL != tiovx_modules_dequeue_buf_timeout(buf_pool, SHORT_TIMEOUT_MS)) {
+        TIOVX_MODULE_ERROR("dequeue_buf_timeout returned a buffer\n");
+        status = VX_FAILURE;
+    } else if (get_time_ms() - start + 1 < SHORT_TIMEOUT_MS) {
+        TIOVX_MODULE_ERROR("dequeue_buf_timeout returned early\n");
+        status = VX_FAILURE;
+    }
+
+    return status;
+}
+
+static vx_status run_timed_test(vx_bool use_param_events)
+{
+    vx_status status = VX_FAILURE;
+    GraphObj graph;
+    NodeObj *node = NULL, *fakesrc_node = NULL;
+    TIOVXPixelwiseMultiplyNodeCfg cfg;
+    TIOVXFakesrcNodeCfg fakesrc_cfg;
+    TIOVXFakesinkNodeCfg fakesink_cfg;
+    BufPool *in_buf_pool = NULL;
+    Buf *bufs[APP_BUFQ_DEPTH];
+    Buf *inbuf = NULL;
+    PadStats stats;
+    vx_int32 i, num_bufs = 0;
+
+    status = tiovx_modules_initialize_graph(&graph);
+    graph.schedule_mode = VX_GRAPH_SCHEDULE_MODE_QUEUE_AUTO;
+    graph.use_param_events = use_param_events;
+    graph.collect_pad_stats = vx_true_e;
+
+    tiovx_pixelwise_multiply_init_cfg(&cfg);
+    cfg.input_cfg.width = IMAGE_WIDTH;
+    cfg.input_cfg.height = IMAGE_HEIGHT;
+    cfg.input_cfg.color_format = VX_DF_IMAGE_U8;
+    cfg.output_color_format = VX_DF_IMAGE_S16;
+    sprintf(cfg.target_string, TIVX_TARGET_DSP1);
+    node = tiovx_modules_add_node(&graph, TIOVX_PIXELWISE_MULTIPLY, (void *)&cfg);
+
+    tiovx_fakesrc_init_cfg(&fakesrc_cfg);
+    fakesrc_cfg.sink_pad = &node->sinks[1];
+    fakesrc_node = tiovx_modules_add_node(&graph, TIOVX_FAKESRC, (void *)&fakesrc_cfg);
+
+    tiovx_fakesink_init_cfg(&fakesink_cfg);
+    fakesink_cfg.src_pad = &node->srcs[0];
+    tiovx_modules_add_node(&graph, TIOVX_FAKESINK, (void *)&fakesink_cfg);
+
+    node->sinks[0].bufq_depth = APP_BUFQ_DEPTH;
+
+    resetImage((vx_image)(fakesrc_node->srcs[0].exemplar), 2);
+    status = tiovx_modules_verify_graph(&graph);
+
+    in_buf_pool = node->sinks[0].buf_pool;
+
+    /* Hold the whole pool so nothing is free and nothing is in the graph */
+    while (num_bufs < APP_BUFQ_DEPTH && VX_SUCCESS == status) {
+        bufs[num_bufs] = tiovx_modules_try_acquire_buf(in_buf_pool);
+        if (NULL == bufs[num_bufs]) {
+            TIOVX_MODULE_ERROR("try_acquire_buf failed with free buffers\n");
+            status = VX_FAILURE;
+        } else {
+            resetImage((vx_image)bufs[num_bufs]->handle, num_bufs);
+            num_bufs++;
+        }
+    }
+
+    if (VX_SUCCESS == status) {
+        status = check_empty(in_buf_pool);
+    }
+
+    if (VX_SUCCESS == status) {
+        status = tiovx_modules_get_pad_stats(&node->sinks[0], &stats);
+    }
+    if (VX_SUCCESS == status &&
+        (2 != stats.num_acquire_fails || 2 != stats.num_dequeue_empty)) {
+        TIOVX_MODULE_ERROR("Counted %lu acquire fails and %lu empty dequeues,"
+                           " expected 2 of each\n",
+                           (unsigned long)stats.num_acquire_fails,
+                           (unsigned long)stats.num_dequeue_empty);
+        status = VX_FAILURE;
+    }
+
+    /* A timed dequeue returns the buffer once the graph is done with it */
+    for (i = 0; i < num_bufs && VX_SUCCESS == status; i++) {
+        status = tiovx_modules_enqueue_buf(bufs[i]);
+        if (VX_SUCCESS != status) {
+            break;
+        }
+
+        if (0 == i) {
+            inbuf = tiovx_modules_dequeue_buf_timeout(in_buf_pool,
+                                                      LONG_TIMEOUT_MS);
+        } else {
+            inbuf = tiovx_modules_dequeue_any_buf(&in_buf_pool, 1,
+                                                  LONG_TIMEOUT_MS);
+        }
+
+        if (inbuf != bufs[i]) {
+            TIOVX_MODULE_ERROR("Timed dequeue of buffer %d failed\n", i);
+            status = VX_FAILURE;
+            break;
+        }
+
+        tiovx_modules_release_buf(inbuf);
+    }
+
+    /* A released buffer satisfies a timed acquire */
+    if (VX_SUCCESS == status) {
+        inbuf = tiovx_modules_acquire_buf_timeout(in_buf_pool, LONG_TIMEOUT_MS);
+        if (NULL == inbuf) {
+            TIOVX_MODULE_ERROR("acquire_buf_timeout failed with a free buffer\n");
+            status = VX_FAILURE;
+        } else {
+            tiovx_modules_release_buf(inbuf);
+        }
+    }
+
+    tiovx_modules_clean_graph(&graph);
+
+    return status;
+}
+
+vx_status app_modules_timed_dequeue_test(vx_int32 argc, vx_char* argv[])
+{
+    vx_status status;
+
+    status = run_timed_test(vx_false_e);
+
+    /* Waits on graph parameter events instead of polling */
+    if (VX_SUCCESS == status) {
+        status = run_timed_test(vx_true_e);
+    }
+
+    return status;
+}
@@ -97,6 +97,18 @@
 #define APP_MODULES_TEST_PIXELWISE_ADD (1)
 #define APP_MODULES_TEST_LUT (1)
 #define APP_MODULES_TEST_FAKESRC_FAKESINK (1)
+#define APP_MODULES_TEST_IMAGE_PACK (1)
+#define APP_MODULES_TEST_FLOW_CACHE (1)
+#define APP_MODULES_TEST_LOCK_FREE_BUFPOOL (1)
+#define APP_MODULES_TEST_BUFPOOL_GROWTH (1)
+#define APP_MODULES_TEST_MEM_ARENA (1)
+#define APP_MODULES_TEST_BATCH_ENQUEUE (1)
+#define APP_MODULES_TEST_TIMED_DEQUEUE (1)
+#define APP_MODULES_TEST_RUNTIME (1)
+#define APP_MODULES_TEST_MANY_NODES (1)
+#define APP_MODULES_TEST_BUF_IMPORT (1)
+#define APP_MODULES_TEST_PAD_STATS (1)
+#define APP_MODULES_TEST_DROP_POLICY (1)
 #define APP_MODULES_TEST_QNX_DECODE_DISPLAY (0)
 #define APP_MODULES_TEST_QNX_CAPTURE_ENCODE (0)
 #define APP_MODULES_TEST_LINUX_MULTI_GRAPH (0)
@@ -339,6 +351,126 @@ int main(int argc, char *argv[])
     }
 #endif
 
+#if (APP_MODULES_TEST_IMAGE_PACK)
+    if(status==0)
+    {
+        printf("Running image pack test\n");
+        int app_modules_image_pack_test(int argc, char* argv[]);
+
+        status = app_modules_image_pack_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_FLOW_CACHE)
+    if(status==0)
+    {
+        printf("Running flow cache test\n");
+        int app_modules_flow_cache_test(int argc, char* argv[]);
+
+        status = app_modules_flow_cache_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_LOCK_FREE_BUFPOOL)
+    if(status==0)
+    {
+        printf("Running lock-free buffer pool test\n");
+        int app_modules_lock_free_bufpool_test(int argc, char* argv[]);
+
+        status = app_modules_lock_free_bufpool_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_BUFPOOL_GROWTH)
+    if(status==0)
+    {
+        printf("Running buffer pool growth test\n");
+        int app_modules_bufpool_growth_test(int argc, char* argv[]);
+
+        status = app_modules_bufpool_growth_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_MEM_ARENA)
+    if(status==0)
+    {
+        printf("Running memory arena test\n");
+        int app_modules_mem_arena_test(int argc, char* argv[]);
+
+        status = app_modules_mem_arena_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_BATCH_ENQUEUE)
+    if(status==0)
+    {
+        printf("Running batch enqueue test\n");
+        int app_modules_batch_enqueue_test(int argc, char* argv[]);
+
+        status = app_modules_batch_enqueue_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_TIMED_DEQUEUE)
+    if(status==0)
+    {
+        printf("Running timed dequeue test\n");
+        int app_modules_timed_dequeue_test(int argc, char* argv[]);
+
+        status = app_modules_timed_dequeue_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_RUNTIME)
+    if(status==0)
+    {
+        printf("Running graph runtime test\n");
+        int app_modules_runtime_test(int argc, char* argv[]);
+
+        status = app_modules_runtime_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_MANY_NODES)
+    if(status==0)
+    {
+        printf("Running many nodes test\n");
+        int app_modules_many_nodes_test(int argc, char* argv[]);
+
+        status = app_modules_many_nodes_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_BUF_IMPORT)
+    if(status==0)
+    {
+        printf("Running buffer import test\n");
+        int app_modules_buf_import_test(int argc, char* argv[]);
+
+        status = app_modules_buf_import_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_PAD_STATS)
+    if(status==0)
+    {
+        printf("Running pad statistics test\n");
+        int app_modules_pad_stats_test(int argc, char* argv[]);
+
+        status = app_modules_pad_stats_test(argc, argv);
+    }
+#endif
+
+#if (APP_MODULES_TEST_DROP_POLICY)
+    if(status==0)
+    {
+        printf("Running drop policy test\n");
+        int app_modules_drop_policy_test(int argc, char* argv[]);
+
+        status = app_modules_drop_policy_test(argc, argv);
+    }
+#endif
+
 #if defined(SOC_AM62A) && defined(TARGET_OS_QNX)
 #if (APP_MODULES_TEST_CAPTURE_VISS_LDC_MSC_DISPLAY)
     if(status==0)
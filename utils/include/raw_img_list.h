@@ -0,0 +1,133 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _TIOVX_APPS_RAW_IMG_LIST_
+#define _TIOVX_APPS_RAW_IMG_LIST_
+
+#include <apps/include/info.h>
+#include <tiovx_utils.h>
+#include <stdio.h>
+#include <dirent.h>
+#include <glob.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Iterator over the images of a RAW_IMG input. Directories and glob
+ * patterns are listed once in sorted order, list files are read a line at a
+ * time and image packs are mapped, so the number of images is not bounded.
+ */
+typedef struct {
+    RawImgPathType  type;
+
+    /* Directory, file or list file the input was configured with */
+    char            base[MAX_CHAR_ARRAY_SIZE];
+
+    /* Sorted entries of RAW_IMG_DIR */
+    struct dirent   **entries;
+    int32_t         num_entries;
+
+    /* Matches of RAW_IMG_GLOB */
+    glob_t          matches;
+    bool            has_matches;
+
+    /* Open list file of RAW_IMG_LIST */
+    FILE            *list_fp;
+    char            *line;
+    size_t          line_size;
+
+    /* Mapped RAW_IMG_PACK */
+    ImagePack       pack;
+    bool            has_pack;
+
+    /* Number of images, counted on first use for RAW_IMG_LIST */
+    int32_t         count;
+
+    uint32_t        next;
+    char            path[PATH_MAX];
+} RawImgList;
+
+/* Open the image list of input_info, returns 0 on success */
+extern int32_t raw_img_list_open(RawImgList *list, InputInfo *input_info);
+
+/* Path of the next image, NULL at the end of the list. The path is valid
+ * until the next call. Image packs have no path per image. */
+extern const char *raw_img_list_next(RawImgList *list);
+
+/* Read the next image into img with the status of the read in status.
+ * Returns -1 at the end of the list. */
+extern int32_t raw_img_list_read(RawImgList *list, vx_image img, vx_status *status);
+
+/* Start again from the first image */
+extern void raw_img_list_rewind(RawImgList *list);
+
+/* Number of images in the list */
+extern uint32_t raw_img_list_count(RawImgList *list);
+
+extern void raw_img_list_close(RawImgList *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TIOVX_APPS_RAW_IMG_LIST_
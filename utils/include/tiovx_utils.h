@@ -71,8 +71,43 @@ extern "C" {
 #define APP_MAX_FILE_PATH           (256u)
 #define APP_MAX_TENSOR_DIMS         (4u)
 
+/* Extension of image pack files */
+#define TIOVX_IMAGE_PACK_EXT        ".tfp"
+
 extern char *EDGEAI_DATA_PATH;
 
+/* An image pack keeps frames of one size and format in a single file: the
+ * header, the frames back to back and an index of all frames, whose offset
+ * is written to the header on close. Fields are in host byte order.
+ */
+typedef struct {
+    vx_uint32   magic;
+    vx_uint32   version;
+    vx_uint32   width;
+    vx_uint32   height;
+    vx_df_image format;
+    vx_uint32   num_frames;
+    vx_uint64   index_offset;
+} ImagePackHeader;
+
+typedef struct {
+    vx_uint64   offset;
+    vx_uint64   size;
+    vx_uint64   timestamp_us;
+} ImagePackEntry;
+
+typedef struct {
+    ImagePackHeader header;
+    /* Points in the mapped file when read, grown while written */
+    ImagePackEntry  *index;
+    vx_uint32       max_frames;
+    vx_uint64       offset;
+    uint8_t         *data;
+    size_t          size;
+    int             fd;
+    vx_bool         writable;
+} ImagePack;
+
 vx_status readImage(char* file_name, vx_image img);
 vx_status writeImage(char* file_name, vx_image img);
 vx_status writeDistribution(char* file_name, vx_distribution dist);
@@ -81,6 +116,12 @@ vx_status resetImage(vx_image img, int32_t value);
 vx_status readRawImage(char* file_name, tivx_raw_image img, vx_uint32 *bytes_read);
 vx_status writeRawImage(char* file_name, tivx_raw_image img);
 
+vx_status openImagePack(char* file_name, ImagePack *pack);
+vx_status createImagePack(char* file_name, vx_image img, ImagePack *pack);
+vx_status readImagePackFrame(ImagePack *pack, vx_uint32 frame, vx_image img, vx_uint64 *timestamp_us);
+vx_status writeImagePackFrame(ImagePack *pack, vx_image img, vx_uint64 timestamp_us);
+vx_status closeImagePack(ImagePack *pack);
+
 vx_status readTensor(char* file_name, vx_tensor tensor);
 vx_status writeTensor(char* file_name, vx_tensor tensor);
 
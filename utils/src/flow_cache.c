@@ -0,0 +1,294 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "flow_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define FLOW_CACHE_MAGIC    (0x43465854u)   /* "TXFC" */
+#define FLOW_CACHE_VERSION  (2u)
+#define FLOW_CACHE_MAX_DEPS (256u)
+
+/* File the cached flows depend on */
+typedef struct {
+    char        path[MAX_CHAR_ARRAY_SIZE + 32];
+    int64_t     size;
+    int64_t     mtime_sec;
+    int64_t     mtime_nsec;
+} FlowCacheDep;
+
+typedef struct {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    flow_info_size;
+    uint32_t    num_flows;
+    uint32_t    num_deps;
+} FlowCacheHeader;
+
+static void stat_dep(FlowCacheDep *dep)
+{
+    struct stat st;
+
+    /* Missing files are recorded too, so creating one invalidates */
+    if (0 != stat(dep->path, &st))
+    {
+        dep->size = -1;
+        dep->mtime_sec = 0;
+        dep->mtime_nsec = 0;
+        return;
+    }
+
+    dep->size = st.st_size;
+#if defined(TARGET_OS_QNX)
+    dep->mtime_sec = st.st_mtime;
+    dep->mtime_nsec = 0;
+#else
+    dep->mtime_sec = st.st_mtim.tv_sec;
+    dep->mtime_nsec = st.st_mtim.tv_nsec;
+#endif
+}
+
+static int32_t add_dep(FlowCacheDep deps[], uint32_t *num_deps, const char *path)
+{
+    uint32_t i;
+
+    for (i = 0; i < *num_deps; i++)
+    {
+        if (0 == strcmp(deps[i].path, path))
+        {
+            return 0;
+        }
+    }
+
+    /* A dependency left out would never invalidate the cache */
+    if (*num_deps == FLOW_CACHE_MAX_DEPS)
+    {
+        return -1;
+    }
+
+    snprintf(deps[*num_deps].path, sizeof(deps[*num_deps].path), "%s", path);
+    stat_dep(&deps[*num_deps]);
+    *num_deps = *num_deps + 1;
+
+    return 0;
+}
+
+static int32_t get_deps(char *config_filename,
+                     FlowInfo flow_infos[],
+                     uint32_t num_flows,
+                     FlowCacheDep deps[],
+                     uint32_t *num_deps)
+{
+    char path[MAX_CHAR_ARRAY_SIZE + 32];
+    int32_t status = 0;
+    uint32_t i, j;
+
+    *num_deps = 0;
+    status |= add_dep(deps, num_deps, config_filename);
+
+    for (i = 0; i < num_flows; i++)
+    {
+        for (j = 0; j < flow_infos[i].num_subflows; j++)
+        {
+            ModelInfo *model_info = &flow_infos[i].subflow_infos[j].model_info;
+
+            if (!flow_infos[i].subflow_infos[j].has_model)
+            {
+                continue;
+            }
+
+            snprintf(path, sizeof(path), "%s/param.yaml", model_info->model_path);
+            status |= add_dep(deps, num_deps, path);
+            snprintf(path, sizeof(path), "%s/dataset.yaml", model_info->model_path);
+            status |= add_dep(deps, num_deps, path);
+            status |= add_dep(deps, num_deps, model_info->io_config_path);
+            status |= add_dep(deps, num_deps, model_info->network_path);
+        }
+    }
+
+    return status;
+}
+
+int32_t load_flow_cache(char       *cache_filename,
+                        char       *config_filename,
+                        FlowInfo   flow_infos[],
+                        uint32_t   max_flows,
+                        uint32_t   *num_flows)
+{
+    FlowCacheHeader header;
+    FlowCacheDep deps[FLOW_CACHE_MAX_DEPS];
+    FlowCacheDep dep;
+    FILE *fp = NULL;
+    int32_t status = -1;
+    uint32_t i;
+
+    fp = fopen(cache_filename, "rb");
+    if (NULL == fp)
+    {
+        return status;
+    }
+
+    if (1 != fread(&header, sizeof(header), 1, fp) ||
+        FLOW_CACHE_MAGIC != header.magic ||
+        FLOW_CACHE_VERSION != header.version ||
+        sizeof(FlowInfo) != header.flow_info_size ||
+        header.num_flows > max_flows ||
+        header.num_deps > FLOW_CACHE_MAX_DEPS ||
+        header.num_deps != fread(deps, sizeof(FlowCacheDep),
+                                 header.num_deps, fp))
+    {
+        TIOVX_APPS_ERROR("%s is not a valid flow cache\n", cache_filename);
+        goto exit;
+    }
+
+    /* The first dependency is always the config file */
+    if (0 == header.num_deps || 0 != strcmp(deps[0].path, config_filename))
+    {
+        goto exit;
+    }
+
+    for (i = 0; i < header.num_deps; i++)
+    {
+        dep = deps[i];
+        stat_dep(&dep);
+        if (dep.size != deps[i].size ||
+            dep.mtime_sec != deps[i].mtime_sec ||
+            dep.mtime_nsec != deps[i].mtime_nsec)
+        {
+            TIOVX_APPS_PRINTF("%s changed, flow cache is stale\n", dep.path);
+            goto exit;
+        }
+    }
+
+    if (header.num_flows != fread(flow_infos, sizeof(FlowInfo),
+                                  header.num_flows, fp))
+    {
+        TIOVX_APPS_ERROR("%s is truncated\n", cache_filename);
+        goto exit;
+    }
+
+    *num_flows = header.num_flows;
+    status = 0;
+
+exit:
+    fclose(fp);
+    return status;
+}
+
+int32_t save_flow_cache(char       *cache_filename,
+                        char       *config_filename,
+                        FlowInfo   flow_infos[],
+                        uint32_t   num_flows)
+{
+    FlowCacheHeader header;
+    FlowCacheDep deps[FLOW_CACHE_MAX_DEPS];
+    char tmp_filename[MAX_CHAR_ARRAY_SIZE * 2 + 8];
+    FILE *fp = NULL;
+    int32_t status = -1;
+
+    header.magic = FLOW_CACHE_MAGIC;
+    header.version = FLOW_CACHE_VERSION;
+    header.flow_info_size = sizeof(FlowInfo);
+    header.num_flows = num_flows;
+    if (0 != get_deps(config_filename, flow_infos, num_flows, deps,
+                      &header.num_deps))
+    {
+        TIOVX_APPS_ERROR("More than %u files to track, not writing %s\n",
+                         FLOW_CACHE_MAX_DEPS, cache_filename);
+        return status;
+    }
+
+    /* Written aside and renamed, a crash never leaves a partial cache */
+    snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp", cache_filename);
+    fp = fopen(tmp_filename, "wb");
+    if (NULL == fp)
+    {
+        TIOVX_APPS_ERROR("Unable to open %s\n", tmp_filename);
+        return status;
+    }
+
+    if (1 == fwrite(&header, sizeof(header), 1, fp) &&
+        header.num_deps == fwrite(deps, sizeof(FlowCacheDep),
+                                  header.num_deps, fp) &&
+        num_flows == fwrite(flow_infos, sizeof(FlowInfo), num_flows, fp))
+    {
+        status = 0;
+    }
+
+    if (0 != fclose(fp))
+    {
+        status = -1;
+    }
+
+    if (0 == status && 0 != rename(tmp_filename, cache_filename))
+    {
+        status = -1;
+    }
+
+    if (0 != status)
+    {
+        TIOVX_APPS_ERROR("Unable to write %s\n", cache_filename);
+        remove(tmp_filename);
+    }
+
+    return status;
+}
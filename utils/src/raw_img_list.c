@@ -0,0 +1,333 @@
+/*
+ *
+ * Copyright (c) 2024 Texas Instruments Incorporated
+ *
+ * All rights reserved not granted herein.
+ *
+ * Limited License.
+ *
+ * Texas Instruments Incorporated grants a world-wide, royalty-free, non-exclusive
+ * license under copyrights and patents it now or hereafter owns or controls to make,
+ * have made, use, import, offer to sell and sell ("Utilize") this software subject to the
+ * terms herein.  With respect to the foregoing patent license, such license is granted
+ * solely to the extent that any such patent is necessary to Utilize the software alone.
+ * The patent license shall not apply to any combinations which include this software,
+ * other than combinations with devices manufactured by or for TI ("TI Devices").
+ * No hardware patent is licensed hereunder.
+ *
+ * Redistributions must preserve existing copyright notices and reproduce this license
+ * (including the above copyright notice and the disclaimer and (if applicable) source
+ * code license limitations below) in the documentation and/or other materials provided
+ * with the distribution
+ *
+ * Redistribution and use in binary form, without modification, are permitted provided
+ * that the following conditions are met:
+ *
+ * *       No reverse engineering, decompilation, or disassembly of this software is
+ * permitted with respect to any software provided in binary form.
+ *
+ * *       any redistribution and use are licensed by TI for use only with TI Devices.
+ *
+ * *       Nothing shall obligate TI to provide you with source code for the software
+ * licensed and provided to you in object code.
+ *
+ * If software source code is provided to you, modification and redistribution of the
+ * source code are permitted provided that the following conditions are met:
+ *
+ * *       any redistribution and use of the source code, including any resulting derivative
+ * works, are licensed by TI for use only with TI Devices.
+ *
+ * *       any redistribution and use of any object code compiled from the source code
+ * and any resulting derivative works, are licensed by TI for use only with TI Devices.
+ *
+ * Neither the name of Texas Instruments Incorporated nor the names of its suppliers
+ *
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * DISCLAIMER.
+ *
+ * THIS SOFTWARE IS PROVIDED BY TI AND TI'S LICENSORS "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL TI AND TI'S LICENSORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "raw_img_list.h"
+#include <stdlib.h>
+#include <string.h>
+#include <libgen.h>
+
+static int raw_img_filter(const struct dirent *entry)
+{
+    if (0 == strcmp(entry->d_name, ".") || 0 == strcmp(entry->d_name, ".."))
+    {
+        return 0;
+    }
+
+    return (DT_DIR != entry->d_type);
+}
+
+static int raw_img_compare(const struct dirent **a, const struct dirent **b)
+{
+    return strcmp((*a)->d_name, (*b)->d_name);
+}
+
+/* Next image path of a list file, blank lines and comments are skipped */
+static const char *raw_img_list_read_line(RawImgList *list, FILE *fp)
+{
+    ssize_t len;
+    char *line;
+
+    while ((len = getline(&list->line, &list->line_size, fp)) >= 0)
+    {
+        while (len > 0 && ('\n' == list->line[len - 1] ||
+                           '\r' == list->line[len - 1] ||
+                           ' ' == list->line[len - 1]))
+        {
+            list->line[--len] = '\0';
+        }
+
+        line = list->line;
+        while (' ' == *line || '\t' == *line)
+        {
+            line++;
+        }
+
+        if ('\0' != *line && '#' != *line)
+        {
+            return line;
+        }
+    }
+
+    return NULL;
+}
+
+int32_t raw_img_list_open(RawImgList *list, InputInfo *input_info)
+{
+    int32_t status = 0;
+    int ret;
+
+    memset(list, 0, sizeof(RawImgList));
+    list->type = input_info->raw_img_type;
+    list->count = -1;
+    snprintf(list->base, sizeof(list->base), "%s", input_info->raw_img_path);
+
+    switch (list->type)
+    {
+        case RAW_IMG_DIR:
+            list->num_entries = scandir(list->base, &list->entries,
+                                        raw_img_filter, raw_img_compare);
+            if (list->num_entries < 0)
+            {
+                TIOVX_APPS_ERROR("Unable to list %s\n", list->base);
+                list->entries = NULL;
+                list->num_entries = 0;
+                status = -1;
+            }
+            list->count = list->num_entries;
+            break;
+
+        case RAW_IMG_GLOB:
+            ret = glob(list->base, 0, NULL, &list->matches);
+            if (0 == ret || GLOB_NOMATCH == ret)
+            {
+                list->has_matches = true;
+                list->count = (0 == ret) ? (int32_t)list->matches.gl_pathc : 0;
+            }
+            else
+            {
+                TIOVX_APPS_ERROR("Unable to expand %s\n", list->base);
+                status = -1;
+            }
+            break;
+
+        case RAW_IMG_LIST:
+            list->list_fp = fopen(list->base, "r");
+            if (NULL == list->list_fp)
+            {
+                TIOVX_APPS_ERROR("Unable to open %s\n", list->base);
+                status = -1;
+            }
+            break;
+
+        case RAW_IMG_PACK:
+            if (VX_SUCCESS == openImagePack(list->base, &list->pack))
+            {
+                list->has_pack = true;
+                list->count = list->pack.header.num_frames;
+            }
+            else
+            {
+                status = -1;
+            }
+            break;
+
+        case RAW_IMG_FILE:
+        default:
+            list->count = 1;
+            break;
+    }
+
+    if (0 != status)
+    {
+        list->count = 0;
+    }
+
+    return status;
+}
+
+const char *raw_img_list_next(RawImgList *list)
+{
+    const char *line;
+    char dir[MAX_CHAR_ARRAY_SIZE];
+
+    switch (list->type)
+    {
+        case RAW_IMG_DIR:
+            if (list->next >= (uint32_t)list->num_entries)
+            {
+                return NULL;
+            }
+            snprintf(list->path, sizeof(list->path), "%s/%s",
+                     list->base, list->entries[list->next]->d_name);
+            list->next++;
+            return list->path;
+
+        case RAW_IMG_GLOB:
+            if (list->next >= (uint32_t)list->count)
+            {
+                return NULL;
+            }
+            return list->matches.gl_pathv[list->next++];
+
+        case RAW_IMG_LIST:
+            if (NULL == list->list_fp)
+            {
+                return NULL;
+            }
+            line = raw_img_list_read_line(list, list->list_fp);
+            if (NULL == line)
+            {
+                return NULL;
+            }
+            /* Relative paths are relative to the list file */
+            if ('/' == line[0])
+            {
+                snprintf(list->path, sizeof(list->path), "%s", line);
+            }
+            else
+            {
+                snprintf(dir, sizeof(dir), "%s", list->base);
+                snprintf(list->path, sizeof(list->path), "%s/%s",
+                         dirname(dir), line);
+            }
+            list->next++;
+            return list->path;
+
+        case RAW_IMG_PACK:
+            return NULL;
+
+        case RAW_IMG_FILE:
+        default:
+            if (list->next > 0)
+            {
+                return NULL;
+            }
+            list->next++;
+            return list->base;
+    }
+}
+
+int32_t raw_img_list_read(RawImgList *list, vx_image img, vx_status *status)
+{
+    const char *path;
+
+    if (RAW_IMG_PACK == list->type)
+    {
+        if (!list->has_pack || list->next >= list->pack.header.num_frames)
+        {
+            return -1;
+        }
+        *status = readImagePackFrame(&list->pack, list->next, img, NULL);
+        list->next++;
+        return 0;
+    }
+
+    path = raw_img_list_next(list);
+    if (NULL == path)
+    {
+        return -1;
+    }
+    *status = readImage((char *)path, img);
+
+    return 0;
+}
+
+void raw_img_list_rewind(RawImgList *list)
+{
+    list->next = 0;
+
+    if (NULL != list->list_fp)
+    {
+        rewind(list->list_fp);
+    }
+}
+
+uint32_t raw_img_list_count(RawImgList *list)
+{
+    FILE *fp;
+
+    /* List files are only scanned if the count is asked for */
+    if (list->count < 0)
+    {
+        list->count = 0;
+        fp = fopen(list->base, "r");
+        if (NULL != fp)
+        {
+            while (NULL != raw_img_list_read_line(list, fp))
+            {
+                list->count++;
+            }
+            fclose(fp);
+        }
+    }
+
+    return (uint32_t)list->count;
+}
+
+void raw_img_list_close(RawImgList *list)
+{
+    int32_t i;
+
+    for (i = 0; i < list->num_entries; i++)
+    {
+        free(list->entries[i]);
+    }
+    free(list->entries);
+
+    if (list->has_matches)
+    {
+        globfree(&list->matches);
+    }
+
+    if (NULL != list->list_fp)
+    {
+        fclose(list->list_fp);
+    }
+    free(list->line);
+
+    if (list->has_pack)
+    {
+        closeImagePack(&list->pack);
+    }
+
+    memset(list, 0, sizeof(RawImgList));
+}
@@ -62,6 +62,20 @@
 
 #include "tiovx_utils.h"
 #include "app_mem.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+/* Rows written by one writev when image rows are padded */
+#define TIOVX_UTILS_MAX_IOV (64)
+
+#define TIOVX_IMAGE_PACK_MAGIC      (0x50465854u)   /* "TXFP" */
+#define TIOVX_IMAGE_PACK_VERSION    (1u)
+
+/* Frames the image pack index grows by first, it then doubles */
+#define TIOVX_IMAGE_PACK_INDEX_STEP (256u)
 
 vx_status readRawImage(char* file_name, tivx_raw_image image, vx_uint32 *bytes_read)
 {
@@ -286,6 +300,120 @@ vx_status writeRawImage(char* file_name, tivx_raw_image image)
     return(status);
 }
 
+/* Bytes of one row and number of rows of a mapped image plane */
+static size_t get_plane_size(vx_imagepatch_addressing_t *image_addr,
+                             vx_uint32 *row_bytes, vx_uint32 *num_rows)
+{
+    *row_bytes = (image_addr->dim_x * image_addr->stride_x) / image_addr->step_x;
+    *num_rows = image_addr->dim_y / image_addr->step_y;
+
+    return (size_t)(*row_bytes) * (*num_rows);
+}
+
+/* Copy a plane from file data, in one copy if the rows have no padding */
+static vx_uint32 copy_plane_from_file(uint8_t *data_ptr,
+                                      vx_imagepatch_addressing_t *image_addr,
+                                      const uint8_t *file_data,
+                                      size_t file_bytes)
+{
+    vx_uint32 row_bytes, num_rows, j;
+    size_t size, num_bytes = 0;
+
+    size = get_plane_size(image_addr, &row_bytes, &num_rows);
+    if (size > file_bytes)
+    {
+        size = file_bytes;
+    }
+
+    if (image_addr->stride_y == (vx_int32)row_bytes)
+    {
+        memcpy(data_ptr, file_data, size);
+        return (vx_uint32)size;
+    }
+
+    for (j = 0; j < num_rows && num_bytes < size; j++)
+    {
+        row_bytes = (size - num_bytes < row_bytes) ? size - num_bytes : row_bytes;
+        memcpy(data_ptr, file_data + num_bytes, row_bytes);
+        num_bytes += row_bytes;
+        data_ptr += image_addr->stride_y;
+    }
+
+    return (vx_uint32)num_bytes;
+}
+
+/* Read a plane row by row, for files that can't be mapped */
+static vx_uint32 read_plane_from_fd(int fd, uint8_t *data_ptr,
+                                    vx_imagepatch_addressing_t *image_addr)
+{
+    vx_uint32 row_bytes, num_rows, j;
+    vx_uint32 num_bytes = 0;
+    ssize_t read_count;
+
+    get_plane_size(image_addr, &row_bytes, &num_rows);
+
+    for (j = 0; j < num_rows; j++)
+    {
+        read_count = read(fd, data_ptr, row_bytes);
+        if (read_count <= 0)
+        {
+            break;
+        }
+        num_bytes += read_count;
+        data_ptr += image_addr->stride_y;
+    }
+
+    return num_bytes;
+}
+
+/* Write a plane with one write per plane, or one writev per batch of rows */
+static vx_uint32 write_plane_to_fd(int fd, uint8_t *data_ptr,
+                                   vx_imagepatch_addressing_t *image_addr)
+{
+    struct iovec iov[TIOVX_UTILS_MAX_IOV];
+    vx_uint32 row_bytes, num_rows, j, num_iov;
+    size_t size, num_bytes = 0;
+    ssize_t write_count;
+
+    size = get_plane_size(image_addr, &row_bytes, &num_rows);
+
+    if (image_addr->stride_y == (vx_int32)row_bytes)
+    {
+        while (num_bytes < size)
+        {
+            write_count = write(fd, data_ptr + num_bytes, size - num_bytes);
+            if (write_count <= 0)
+            {
+                break;
+            }
+            num_bytes += write_count;
+        }
+        return (vx_uint32)num_bytes;
+    }
+
+    for (j = 0; j < num_rows; j += num_iov)
+    {
+        for (num_iov = 0; num_iov < TIOVX_UTILS_MAX_IOV && j + num_iov < num_rows; num_iov++)
+        {
+            iov[num_iov].iov_base = data_ptr;
+            iov[num_iov].iov_len = row_bytes;
+            data_ptr += image_addr->stride_y;
+        }
+
+        write_count = writev(fd, iov, num_iov);
+        if (write_count > 0)
+        {
+            num_bytes += write_count;
+        }
+        if (write_count != (ssize_t)num_iov * row_bytes)
+        {
+            break;
+        }
+    }
+
+    return (vx_uint32)num_bytes;
+}
+
 vx_status readImage(char* file_name, vx_image img)
 {
     vx_status status;
@@ -294,15 +422,33 @@ vx_status readImage(char* file_name, vx_image img)
 
     if((vx_status)VX_SUCCESS == status)
     {
-        FILE * fp = fopen(file_name,"rb");
-        vx_int32  j;
+        int fd = open(file_name, O_RDONLY);
+        struct stat st;
+        uint8_t *file_data = NULL;
+        size_t file_size = 0;
+        size_t offset = 0;
 
-        if(fp == NULL)
+        if(fd < 0)
         {
             TIOVX_MODULE_ERROR("Unable to open file %s \n", file_name);
             return (VX_FAILURE);
         }
 
+        /* The file is mapped and copied per plane, read() if it can't be */
+        if(0 == fstat(fd, &st) && st.st_size > 0)
+        {
+            file_size = (size_t)st.st_size;
+            file_data = (uint8_t *)mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(MAP_FAILED == file_data)
+            {
+                file_data = NULL;
+            }
+            else
+            {
+                madvise(file_data, file_size, MADV_SEQUENTIAL);
+            }
+        }
+
         {
             vx_rectangle_t rect;
             vx_imagepatch_addressing_t image_addr;
@@ -314,6 +460,7 @@ vx_status readImage(char* file_name, vx_image img)
             vx_size    num_planes;
             vx_uint32  plane;
             vx_uint32  plane_size;
+            vx_uint32  row_bytes, num_rows;
             vx_df_image img_format;
 
             vxQueryImage(img, VX_IMAGE_WIDTH, &img_width, sizeof(vx_uint32));
@@ -344,14 +491,19 @@ vx_status readImage(char* file_name, vx_image img)
                 TIOVX_MODULE_PRINTF("image_addr.stride_x = %d\n ", image_addr.stride_x);
                 TIOVX_MODULE_PRINTF("\n");
 
-                num_bytes = 0;
-                for (j = 0; j < (image_addr.dim_y/image_addr.step_y); j++)
+                if(NULL != file_data)
                 {
-                    num_bytes += image_addr.stride_x * fread(data_ptr, image_addr.stride_x, (image_addr.dim_x/image_addr.step_x), fp);
-                    data_ptr += image_addr.stride_y;
+                    num_bytes = copy_plane_from_file(data_ptr, &image_addr,
+                                                     file_data + offset,
+                                                     file_size - offset);
+                    offset += num_bytes;
+                }
+                else
+                {
+                    num_bytes = read_plane_from_fd(fd, data_ptr, &image_addr);
                 }
 
-                plane_size = (image_addr.dim_y/image_addr.step_y) * ((image_addr.dim_x * image_addr.stride_x)/image_addr.step_x);
+                plane_size = get_plane_size(&image_addr, &row_bytes, &num_rows);
 
                 if(num_bytes != plane_size)
                     TIOVX_MODULE_ERROR("Plane [%d] bytes read = %d, expected = %d\n", plane, num_bytes, plane_size);
@@ -361,7 +513,11 @@ vx_status readImage(char* file_name, vx_image img)
 
         }
 
-        fclose(fp);
+        if(NULL != file_data)
+        {
+            munmap(file_data, file_size);
+        }
+        close(fd);
     }
 
     return(status);
@@ -417,10 +573,9 @@ vx_status writeImage(char* file_name, vx_image img)
 
     if((vx_status)VX_SUCCESS == status)
     {
-        FILE * fp = fopen(file_name,"wb");
-        vx_int32  j;
+        int fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
 
-        if(fp == NULL)
+        if(fd < 0)
         {
             TIOVX_MODULE_ERROR("Unable to open file %s \n", file_name);
             return (VX_FAILURE);
@@ -437,6 +592,7 @@ vx_status writeImage(char* file_name, vx_image img)
             vx_size    num_planes;
             vx_uint32  plane;
             vx_uint32  plane_size;
+            vx_uint32  row_bytes, num_rows;
             vx_df_image img_format;
 
             vxQueryImage(img, VX_IMAGE_WIDTH, &img_width, sizeof(vx_uint32));
@@ -468,14 +624,9 @@ vx_status writeImage(char* file_name, vx_image img)
                 TIOVX_MODULE_PRINTF("image_addr.stride_x = %d\n ", image_addr.stride_x);
                 TIOVX_MODULE_PRINTF("\n");
 
-                num_bytes = 0;
-                for (j = 0; j < (image_addr.dim_y/image_addr.step_y); j++)
-                {
-                    num_bytes += image_addr.stride_x * fwrite(data_ptr, image_addr.stride_x, (image_addr.dim_x/image_addr.step_x), fp);
-                    data_ptr += image_addr.stride_y;
-                }
+                num_bytes = write_plane_to_fd(fd, data_ptr, &image_addr);
 
-                plane_size = (image_addr.dim_y/image_addr.step_y) * ((image_addr.dim_x * image_addr.stride_x)/image_addr.step_x);
+                plane_size = get_plane_size(&image_addr, &row_bytes, &num_rows);
 
                 if(num_bytes != plane_size)
                     TIOVX_MODULE_ERROR("Plane [%d] bytes written = %d, expected = %d\n", plane, num_bytes, plane_size);
@@ -485,12 +636,350 @@ vx_status writeImage(char* file_name, vx_image img)
 
         }
 
-        fclose(fp);
+        close(fd);
+    }
+
+    return(status);
+}
+
+vx_status openImagePack(char* file_name, ImagePack *pack)
+{
+    struct stat st;
+    vx_uint64 index_end;
+
+    memset(pack, 0, sizeof(ImagePack));
+    pack->fd = open(file_name, O_RDONLY);
+    if(pack->fd < 0)
+    {
+        TIOVX_MODULE_ERROR("Unable to open file %s \n", file_name);
+        return (VX_FAILURE);
+    }
+
+    /* Frames are copied straight from the mapped file in any order */
+    if(0 != fstat(pack->fd, &st) || st.st_size < (off_t)sizeof(ImagePackHeader))
+    {
+        TIOVX_MODULE_ERROR("%s is not an image pack\n", file_name);
+        close(pack->fd);
+        pack->fd = -1;
+        return (VX_FAILURE);
+    }
+
+    pack->size = (size_t)st.st_size;
+    pack->data = (uint8_t *)mmap(NULL, pack->size, PROT_READ, MAP_SHARED, pack->fd, 0);
+    if(MAP_FAILED == pack->data)
+    {
+        TIOVX_MODULE_ERROR("Unable to map %s\n", file_name);
+        close(pack->fd);
+        pack->data = NULL;
+        pack->fd = -1;
+        return (VX_FAILURE);
+    }
+
+    memcpy(&pack->header, pack->data, sizeof(ImagePackHeader));
+    index_end = pack->header.index_offset +
+                (vx_uint64)pack->header.num_frames * sizeof(ImagePackEntry);
+
+    if(TIOVX_IMAGE_PACK_MAGIC != pack->header.magic ||
+       TIOVX_IMAGE_PACK_VERSION != pack->header.version ||
+       pack->header.index_offset < sizeof(ImagePackHeader) ||
+       0 != (pack->header.index_offset % sizeof(vx_uint64)) ||
+       index_end > pack->size)
+    {
+        TIOVX_MODULE_ERROR("%s is not a complete image pack\n", file_name);
+        munmap(pack->data, pack->size);
+        close(pack->fd);
+        pack->data = NULL;
+        pack->fd = -1;
+        return (VX_FAILURE);
+    }
+
+    pack->index = (ImagePackEntry *)(pack->data + pack->header.index_offset);
+    pack->max_frames = pack->header.num_frames;
+    pack->writable = vx_false_e;
+
+    return (VX_SUCCESS);
+}
+
+vx_status createImagePack(char* file_name, vx_image img, ImagePack *pack)
+{
+    vx_status status;
+
+    memset(pack, 0, sizeof(ImagePack));
+
+    status = vxGetStatus((vx_reference)img);
+    if((vx_status)VX_SUCCESS != status)
+    {
+        return status;
+    }
+
+    pack->fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if(pack->fd < 0)
+    {
+        TIOVX_MODULE_ERROR("Unable to open file %s \n", file_name);
+        return (VX_FAILURE);
+    }
+
+    pack->header.magic = TIOVX_IMAGE_PACK_MAGIC;
+    pack->header.version = TIOVX_IMAGE_PACK_VERSION;
+    vxQueryImage(img, VX_IMAGE_WIDTH, &pack->header.width, sizeof(vx_uint32));
+    vxQueryImage(img, VX_IMAGE_HEIGHT, &pack->header.height, sizeof(vx_uint32));
+    vxQueryImage(img, VX_IMAGE_FORMAT, &pack->header.format, sizeof(vx_df_image));
+
+    /* Index offset stays 0 until closed, so a partial pack is rejected */
+    if(sizeof(ImagePackHeader) != write(pack->fd, &pack->header, sizeof(ImagePackHeader)))
+    {
+        TIOVX_MODULE_ERROR("Unable to write %s\n", file_name);
+        close(pack->fd);
+        pack->fd = -1;
+        return (VX_FAILURE);
+    }
+
+    pack->offset = sizeof(ImagePackHeader);
+    pack->writable = vx_true_e;
+
+    return (VX_SUCCESS);
+}
+
+vx_status readImagePackFrame(ImagePack *pack, vx_uint32 frame, vx_image img, vx_uint64 *timestamp_us)
+{
+    vx_status status;
+    ImagePackEntry entry;
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t image_addr;
+    vx_map_id map_id;
+    void * data_ptr;
+    vx_uint32  img_width;
+    vx_uint32  img_height;
+    vx_uint32  num_bytes = 0;
+    vx_size    num_planes;
+    vx_uint32  plane;
+    vx_uint32  plane_size;
+    vx_uint32  row_bytes, num_rows;
+    vx_df_image img_format;
+    vx_uint64  offset = 0;
+
+    status = vxGetStatus((vx_reference)img);
+    if((vx_status)VX_SUCCESS != status)
+    {
+        return status;
+    }
+
+    if(frame >= pack->header.num_frames)
+    {
+        TIOVX_MODULE_ERROR("Frame %d not in image pack of %d frames\n",
+                           frame, pack->header.num_frames);
+        return (VX_FAILURE);
+    }
+
+    entry = pack->index[frame];
+    if(entry.offset < sizeof(ImagePackHeader) ||
+       entry.offset > pack->header.index_offset ||
+       entry.size > pack->header.index_offset - entry.offset)
+    {
+        TIOVX_MODULE_ERROR("Frame %d of image pack is out of bounds\n", frame);
+        return (VX_FAILURE);
+    }
+
+    vxQueryImage(img, VX_IMAGE_WIDTH, &img_width, sizeof(vx_uint32));
+    vxQueryImage(img, VX_IMAGE_HEIGHT, &img_height, sizeof(vx_uint32));
+    vxQueryImage(img, VX_IMAGE_PLANES, &num_planes, sizeof(vx_size));
+    vxQueryImage(img, VX_IMAGE_FORMAT, &img_format, sizeof(vx_df_image));
+
+    if(img_width != pack->header.width || img_height != pack->header.height ||
+       img_format != pack->header.format)
+    {
+        TIOVX_MODULE_ERROR("Image pack of %dx%d does not match image of %dx%d\n",
+                           pack->header.width, pack->header.height,
+                           img_width, img_height);
+        return (VX_FAILURE);
+    }
+
+    for (plane = 0; plane < num_planes; plane++)
+    {
+        rect.start_x = 0;
+        rect.start_y = 0;
+        rect.end_x = img_width;
+        rect.end_y = img_height;
+        status = vxMapImagePatch(img,
+                                &rect,
+                                plane,
+                                &map_id,
+                                &image_addr,
+                                &data_ptr,
+                                VX_WRITE_ONLY,
+                                VX_MEMORY_TYPE_HOST,
+                                VX_NOGAP_X);
+
+        num_bytes = copy_plane_from_file(data_ptr, &image_addr,
+                                         pack->data + entry.offset + offset,
+                                         entry.size - offset);
+        offset += num_bytes;
+
+        plane_size = get_plane_size(&image_addr, &row_bytes, &num_rows);
+
+        if(num_bytes != plane_size)
+            TIOVX_MODULE_ERROR("Plane [%d] bytes read = %d, expected = %d\n", plane, num_bytes, plane_size);
+
+        vxUnmapImagePatch(img, map_id);
+    }
+
+    if(NULL != timestamp_us)
+    {
+        *timestamp_us = entry.timestamp_us;
     }
 
     return(status);
 }
 
+vx_status writeImagePackFrame(ImagePack *pack, vx_image img, vx_uint64 timestamp_us)
+{
+    vx_status status;
+    ImagePackEntry *index;
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t image_addr;
+    vx_map_id map_id;
+    void * data_ptr;
+    vx_uint32  img_width;
+    vx_uint32  img_height;
+    vx_uint32  num_bytes = 0;
+    vx_size    num_planes;
+    vx_uint32  plane;
+    vx_uint32  plane_size;
+    vx_uint32  row_bytes, num_rows;
+    vx_df_image img_format;
+    vx_uint64  size = 0;
+
+    status = vxGetStatus((vx_reference)img);
+    if((vx_status)VX_SUCCESS != status)
+    {
+        return status;
+    }
+
+    if(vx_true_e != pack->writable)
+    {
+        return (VX_FAILURE);
+    }
+
+    vxQueryImage(img, VX_IMAGE_WIDTH, &img_width, sizeof(vx_uint32));
+    vxQueryImage(img, VX_IMAGE_HEIGHT, &img_height, sizeof(vx_uint32));
+    vxQueryImage(img, VX_IMAGE_FORMAT, &img_format, sizeof(vx_df_image));
+
+    if(img_width != pack->header.width || img_height != pack->header.height ||
+       img_format != pack->header.format)
+    {
+        TIOVX_MODULE_ERROR("Image of %dx%d does not match image pack of %dx%d\n",
+                           img_width, img_height,
+                           pack->header.width, pack->header.height);
+        return (VX_FAILURE);
+    }
+
+    if(pack->header.num_frames == pack->max_frames)
+    {
+        pack->max_frames = (0 == pack->max_frames) ?
+                           TIOVX_IMAGE_PACK_INDEX_STEP : pack->max_frames * 2;
+        index = (ImagePackEntry *)realloc(pack->index,
+                                          pack->max_frames * sizeof(ImagePackEntry));
+        if(NULL == index)
+        {
+            TIOVX_MODULE_ERROR("Unable to grow image pack index\n");
+            return (VX_FAILURE);
+        }
+        pack->index = index;
+    }
+
+    vxQueryImage(img, VX_IMAGE_PLANES, &num_planes, sizeof(vx_size));
+
+    for (plane = 0; plane < num_planes; plane++)
+    {
+        rect.start_x = 0;
+        rect.start_y = 0;
+        rect.end_x = pack->header.width;
+        rect.end_y = pack->header.height;
+        status = vxMapImagePatch(img,
+                                &rect,
+                                plane,
+                                &map_id,
+                                &image_addr,
+                                &data_ptr,
+                                VX_READ_ONLY,
+                                VX_MEMORY_TYPE_HOST,
+                                VX_NOGAP_X);
+
+        num_bytes = write_plane_to_fd(pack->fd, data_ptr, &image_addr);
+        size += num_bytes;
+
+        plane_size = get_plane_size(&image_addr, &row_bytes, &num_rows);
+
+        vxUnmapImagePatch(img, map_id);
+
+        if(num_bytes != plane_size)
+        {
+            TIOVX_MODULE_ERROR("Plane [%d] bytes written = %d, expected = %d\n", plane, num_bytes, plane_size);
+            status = VX_FAILURE;
+            break;
+        }
+    }
+
+    /* A short frame is dropped, the next one is written over it */
+    if((vx_status)VX_SUCCESS != status)
+    {
+        lseek(pack->fd, (off_t)pack->offset, SEEK_SET);
+        return status;
+    }
+
+    index = &pack->index[pack->header.num_frames];
+    index->offset = pack->offset;
+    index->size = size;
+    index->timestamp_us = timestamp_us;
+    pack->header.num_frames++;
+    pack->offset += size;
+
+    return(status);
+}
+
+vx_status closeImagePack(ImagePack *pack)
+{
+    vx_status status = VX_SUCCESS;
+    vx_uint64 pad = 0;
+    size_t pad_size, index_size;
+
+    if(vx_true_e != pack->writable)
+    {
+        if(NULL != pack->data)
+        {
+            munmap(pack->data, pack->size);
+        }
+        if(pack->fd >= 0)
+        {
+            close(pack->fd);
+        }
+        memset(pack, 0, sizeof(ImagePack));
+        pack->fd = -1;
+        return status;
+    }
+
+    /* The index goes after the last frame, aligned for mapped access */
+    pad_size = (sizeof(vx_uint64) - (pack->offset % sizeof(vx_uint64))) % sizeof(vx_uint64);
+    index_size = pack->header.num_frames * sizeof(ImagePackEntry);
+    pack->header.index_offset = pack->offset + pad_size;
+
+    if((ssize_t)pad_size != write(pack->fd, &pad, pad_size) ||
+       (ssize_t)index_size != write(pack->fd, pack->index, index_size) ||
+       sizeof(ImagePackHeader) != pwrite(pack->fd, &pack->header,
+                                         sizeof(ImagePackHeader), 0))
+    {
+        TIOVX_MODULE_ERROR("Unable to write image pack index\n");
+        status = VX_FAILURE;
+    }
+
+    close(pack->fd);
+    free(pack->index);
+    memset(pack, 0, sizeof(ImagePack));
+    pack->fd = -1;
+
+    return status;
+}
+
 vx_status resetImage(vx_image img, int32_t value)
 {
     vx_status status;
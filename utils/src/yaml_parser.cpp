@@ -1,4 +1,5 @@
 #include "yaml_parser.h"
+#include "tiovx_utils.h"
 #include <yaml-cpp/yaml.h>
 #include <filesystem>
 #include <string.h>
@@ -53,9 +54,13 @@ int32_t parse_input_node(InputInfo *input_info, const YAML::Node &input_node)
     input_info->format[0] = '\0';
     input_info->loop = true;
     input_info->framerate = 1.0;
-    input_info->num_raw_img = 0;
+    input_info->raw_img_type = RAW_IMG_FILE;
+    input_info->raw_img_path[0] = '\0';
     input_info->ldc_enabled = false;
     input_info->num_channels = 1;
+    input_info->drop_policy = TIOVX_MODULES_DROP_NONE;
+    input_info->max_queued = 0;
+    input_info->cache_mb = 0;
 
     /* Parse necessary information for RTOS_CAM. */
     if (input_info->source == RTOS_CAM)
@@ -171,49 +176,59 @@ int32_t parse_input_node(InputInfo *input_info, const YAML::Node &input_node)
             input_info->framerate = input_node["framerate"].as<float>();
         }
 
-        /* Get images */
-        if (input_node["image_path"])
+        /* Get images. They are enumerated when the input starts. */
+        if (input_node["image_list"])
         {
-            std::string image_path = input_node["image_path"].as<std::string>();
-            if (!std::filesystem::exists(image_path))
+            std::string image_list = input_node["image_list"].as<std::string>();
+            if (!std::filesystem::is_regular_file(image_list))
             {
-                TIOVX_APPS_ERROR("%s does not exist.\n", image_path.c_str());
+                TIOVX_APPS_ERROR("%s does not exist.\n", image_list.c_str());
                 return -1;
             }
 
-            if(std::filesystem::is_directory(image_path))
-            {
-                for(const auto &filename : std::filesystem::directory_iterator(image_path))
-                {
-                    std::string path(filename.path());
-                    sprintf(input_info->raw_img_paths[input_info->num_raw_img],
-                            path.data());
-                    input_info->num_raw_img++;
-                }
+            snprintf(input_info->raw_img_path, MAX_CHAR_ARRAY_SIZE, "%s",
+                     image_list.data());
+            input_info->raw_img_type = RAW_IMG_LIST;
+        }
+        else if (input_node["image_path"])
+        {
+            std::string image_path = input_node["image_path"].as<std::string>();
 
-                char temp[MAX_CHAR_ARRAY_SIZE];
-                for(uint32_t i = 1; i < input_info->num_raw_img; i++)
-                {
-                    for(uint32_t j = 0; j < input_info->num_raw_img-i; j++)
-                    {
-                        if(strcmp(input_info->raw_img_paths[j],input_info->raw_img_paths[j+1]) > 0)
-                        {
-                            strcpy(temp, input_info->raw_img_paths[j]);
-                            strcpy(input_info->raw_img_paths[j], input_info->raw_img_paths[j+1]);
-                            strcpy(input_info->raw_img_paths[j+1], temp);
-                        }
-                    }
-                }
+            if (std::filesystem::is_directory(image_path))
+            {
+                input_info->raw_img_type = RAW_IMG_DIR;
+            }
+            else if (std::filesystem::exists(image_path) &&
+                     std::filesystem::path(image_path).extension() == TIOVX_IMAGE_PACK_EXT)
+            {
+                input_info->raw_img_type = RAW_IMG_PACK;
+            }
+            else if (std::filesystem::exists(image_path))
+            {
+                input_info->raw_img_type = RAW_IMG_FILE;
+            }
+            else if (std::string::npos != image_path.find_first_of("*?["))
+            {
+                input_info->raw_img_type = RAW_IMG_GLOB;
             }
             else
             {
-                sprintf(input_info->raw_img_paths[0], image_path.data());
-                input_info->num_raw_img = 1;
+                TIOVX_APPS_ERROR("%s does not exist.\n", image_path.c_str());
+                return -1;
             }
+
+            /* Trailing slashes are dropped, files are joined to it with one */
+            while (image_path.size() > 1 && '/' == image_path.back())
+            {
+                image_path.pop_back();
+            }
+
+            snprintf(input_info->raw_img_path, MAX_CHAR_ARRAY_SIZE, "%s",
+                     image_path.data());
         }
         else
         {
-            TIOVX_APPS_ERROR("Please specify image_path for %s.\n",
+            TIOVX_APPS_ERROR("Please specify image_path or image_list for %s.\n",
                     input_info->name);
             return -1;
         }
@@ -245,6 +260,77 @@ int32_t parse_input_node(InputInfo *input_info, const YAML::Node &input_node)
         input_info->loop = input_node["loop"].as<bool>();
     }
 
+    /* Parse drop policy. */
+    if (input_node["drop_policy"])
+    {
+        const std::string policy = input_node["drop_policy"].as<std::string>();
+
+        if ("none" == policy)
+        {
+            input_info->drop_policy = TIOVX_MODULES_DROP_NONE;
+        }
+        else if ("drop_newest" == policy)
+        {
+            input_info->drop_policy = TIOVX_MODULES_DROP_NEWEST;
+        }
+        else if ("drop_oldest" == policy)
+        {
+            input_info->drop_policy = TIOVX_MODULES_DROP_OLDEST;
+        }
+        else if ("keep_latest" == policy)
+        {
+            input_info->drop_policy = TIOVX_MODULES_KEEP_LATEST;
+        }
+        else
+        {
+            TIOVX_APPS_ERROR("Invalid drop_policy '%s' specified.\n",
+                             policy.c_str());
+            return -1;
+        }
+
+        /* Capture and decode buffers cycle through their driver, a buffer
+         * dropped to the pool would leave that rotation. LINUX_CAM drops
+         * backed up frames in v4l2 instead, which only keeps the newest.
+         */
+        if ((RTOS_CAM == input_info->source ||
+             VIDEO == input_info->source) &&
+            TIOVX_MODULES_DROP_NONE != input_info->drop_policy)
+        {
+            TIOVX_APPS_ERROR("drop_policy '%s' is not supported for %s.\n",
+                             policy.c_str(),
+                             input_node["source"].as<std::string>().c_str());
+            return -1;
+        }
+
+        if (LINUX_CAM == input_info->source &&
+            TIOVX_MODULES_DROP_NEWEST == input_info->drop_policy)
+        {
+            TIOVX_APPS_ERROR("drop_policy '%s' is not supported for LINUX_CAM.\n",
+                             policy.c_str());
+            return -1;
+        }
+    }
+
+    /* Parse max frames queued to the graph with a drop policy. */
+    if (input_node["max_queued"])
+    {
+        input_info->max_queued = input_node["max_queued"].as<uint32_t>();
+    }
+
+    /* Parse raw img cache size. */
+    if (input_node["cache_mb"])
+    {
+        input_info->cache_mb = input_node["cache_mb"].as<uint32_t>();
+
+        /* Preloaded frames are swapped into the first channel only */
+        if (input_info->cache_mb > 0 && input_info->num_channels > 1)
+        {
+            TIOVX_APPS_ERROR("cache_mb is not supported for %s with %u channels.\n",
+                             input_info->name, input_info->num_channels);
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -530,6 +616,8 @@ int32_t parse_output_node(OutputInfo *output_info, const YAML::Node &output_node
     
     output_info->overlay_perf = true;
 
+    output_info->image_pack = false;
+
     if(output_node["crtc"])
     {
         output_info->crtc =  output_node["crtc"].as<uint32_t>();
@@ -565,16 +653,8 @@ int32_t parse_output_node(OutputInfo *output_info, const YAML::Node &output_node
         if(output_node["output_path"])
         {
             std::string output_path = output_node["output_path"].as<std::string>();
-            if(!std::filesystem::exists(output_path))
-            {
-                std::filesystem::create_directory(output_path);
-                if(!std::filesystem::exists(output_path))
-                {
-                    TIOVX_APPS_ERROR("Error creating directory %s.\n",
-                                     output_path.c_str());
-                    return -1;
-                }
-            }
+            output_info->image_pack =
+                (std::filesystem::path(output_path).extension() == TIOVX_IMAGE_PACK_EXT);
             sprintf(output_info->output_path, output_path.data());
         }
         else
@@ -723,6 +803,8 @@ int32_t parse_yaml_file(char       *input_filename,
 
             flow_infos[i].subflow_infos[s_idx].num_channels = \
                                           flow_infos[i].input_info.num_channels;
+            flow_infos[i].subflow_infos[s_idx].decimation = 1;
+            flow_infos[i].subflow_infos[s_idx].fps = 0;
 
             /* Populate ModelInfo if present. */
             if (pipeline_node[1].IsNull())
@@ -823,7 +905,28 @@ int32_t parse_yaml_file(char       *input_filename,
                     return -1;
                 }
             }
-            
+
+            /* Populate rate control */
+            if(n.second["decimation"])
+            {
+                flow_infos[i].subflow_infos[s_idx].decimation = n.second["decimation"].as<uint32_t>();
+                if (0 == flow_infos[i].subflow_infos[s_idx].decimation)
+                {
+                    TIOVX_APPS_ERROR("decimation must be greater than 0\n");
+                    return -1;
+                }
+            }
+
+            if(n.second["fps"])
+            {
+                flow_infos[i].subflow_infos[s_idx].fps = n.second["fps"].as<float>();
+                if (flow_infos[i].subflow_infos[s_idx].fps < 0)
+                {
+                    TIOVX_APPS_ERROR("fps cannot be negative\n");
+                    return -1;
+                }
+            }
+
             flow_infos[i].num_subflows++;
         }
     }
@@ -846,6 +949,9 @@ void dump_data(FlowInfo flow_infos[], uint32_t num_flows)
         TIOVX_APPS_PRINTF("\twidth: %u\n",flow_infos[i].input_info.width);
         TIOVX_APPS_PRINTF("\theight: %u\n",flow_infos[i].input_info.height);
         TIOVX_APPS_PRINTF("\tloop: %d\n",flow_infos[i].input_info.loop);
+        TIOVX_APPS_PRINTF("\tdrop_policy: %d\n",flow_infos[i].input_info.drop_policy);
+        TIOVX_APPS_PRINTF("\tmax_queued: %d\n",flow_infos[i].input_info.max_queued);
+        TIOVX_APPS_PRINTF("\tcache_mb: %u\n",flow_infos[i].input_info.cache_mb);
         TIOVX_APPS_PRINTF("\tformat: %s\n",flow_infos[i].input_info.format);
         TIOVX_APPS_PRINTF("\tsensor_name: %s\n",flow_infos[i].input_info.sensor_name);
         TIOVX_APPS_PRINTF("\tchannel_mask: %u\n",flow_infos[i].input_info.channel_mask);
@@ -872,6 +978,10 @@ void dump_data(FlowInfo flow_infos[], uint32_t num_flows)
                        flow_infos[i].subflow_infos[j].mosaic_info[k].height);
             }
             TIOVX_APPS_PRINTF("\n");
+            TIOVX_APPS_PRINTF("\t\tdecimation: %u\n",
+                   flow_infos[i].subflow_infos[j].decimation);
+            TIOVX_APPS_PRINTF("\t\tfps: %f\n",
+                   flow_infos[i].subflow_infos[j].fps);
 
         }
         TIOVX_APPS_PRINTF("\n");